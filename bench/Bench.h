@@ -0,0 +1,119 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Shared helpers for the benchmarks. Each benchmark is a single file that runs on the ESP32 as an
+ * Arduino sketch (`src_dir = bench/<Name>` in platformio.ini) and on the host through CMake, against
+ * the NVS stand-in in host/.
+ *
+ * Output is CSV on the serial port / stdout: one header line, then one line per measurement.
+ *
+ * Commit counting: on the host, the stand-in counts `nvs_commit()` calls. On the ESP32, build with
+ * the `esp32-s3-bench` environment, which wraps `nvs_commit()` at link time
+ * (`-Wl,--wrap=nvs_commit`) and defines `BENCH_COUNT_COMMITS`. Without it, commits are reported as
+ * 0.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <esp_timer.h>
+#include <nvs.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#define BENCH_PRINTF(...) Serial.printf(__VA_ARGS__)
+#else
+#include <chrono>
+#include <inttypes.h>
+#include <stdio.h>
+#define BENCH_PRINTF(...) printf(__VA_ARGS__)
+#endif
+
+#if defined(ARDUINO) && defined(BENCH_COUNT_COMMITS)
+static uint32_t bench_commit_count = 0;
+
+extern "C" esp_err_t __real_nvs_commit(nvs_handle_t handle);
+extern "C" esp_err_t __wrap_nvs_commit(nvs_handle_t handle) {
+  bench_commit_count++;
+  return __real_nvs_commit(handle);
+}
+#endif
+
+namespace Bench {
+
+/**
+ * @brief Monotonic time in nanoseconds. On the ESP32 the resolution is 1 us (`esp_timer`).
+ */
+inline int64_t nowNs() {
+#ifdef ARDUINO
+  return esp_timer_get_time() * 1000;
+#else
+  using namespace std::chrono;
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * @brief Number of `nvs_commit()` calls so far.
+ */
+inline uint32_t commitCount() {
+#if !defined(ARDUINO)
+  return nvs_host_get_counters().commits;
+#elif defined(BENCH_COUNT_COMMITS)
+  return bench_commit_count;
+#else
+  return 0;
+#endif
+}
+
+/// @brief Result of timing an operation `iterations` times.
+struct Result {
+  uint32_t iterations;
+  double ops_per_sec;
+  int64_t p50_ns;
+  int64_t p99_ns;
+  uint32_t commits;
+};
+
+constexpr uint32_t MAX_ITERATIONS = 1000;
+
+/**
+ * @brief Time `fn(i)` for i in [0, iterations), one sample per call.
+ * @param iterations Number of calls, at most `MAX_ITERATIONS`.
+ * @param fn Operation to time.
+ * @return Throughput, median and 99th percentile latency, and commits issued.
+ */
+template <typename F>
+Result measure(uint32_t iterations, F&& fn) {
+  static int64_t samples[MAX_ITERATIONS];
+  iterations = std::min(iterations, MAX_ITERATIONS);
+
+  uint32_t commits = commitCount();
+  int64_t total    = 0;
+
+  for (uint32_t i = 0; i < iterations; i++) {
+    int64_t start = nowNs();
+    fn(i);
+    samples[i] = nowNs() - start;
+    total += samples[i];
+  }
+
+  commits = commitCount() - commits;
+  std::sort(samples, samples + iterations);
+
+  Result r;
+  r.iterations  = iterations;
+  r.ops_per_sec = total > 0 ? iterations * 1e9 / static_cast<double>(total) : 0;
+  r.p50_ns      = samples[iterations / 2];
+  r.p99_ns      = samples[(iterations * 99) / 100];
+  r.commits     = commits;
+  return r;
+}
+
+} // namespace Bench
@@ -0,0 +1,120 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/** Benchmark: reads per second with and without `NVS::Option::Cache`.
+ * - Two bool objects and two uint32_t objects share the same keys in separate namespaces, one of
+ *   each with the RAM cache enabled.
+ * - Every key is written once, then read in a tight loop with getValue() and getValueOrDefault().
+ * - One line per case is printed: `type,mode,api,reads,us,reads_per_sec`.
+ */
+
+#include "../Bench.h"
+#include "SettingsManagerESP32.h"
+
+#define FLAGS(X)                   \
+  X(Flag_1, "Flag 1", false, true) \
+  X(Flag_2, "Flag 2", true, true)  \
+  X(Flag_3, "Flag 3", false, true) \
+  X(Flag_4, "Flag 4", true, true)
+
+#define COUNTS(X)                \
+  X(Count_1, "Count 1", 1, true) \
+  X(Count_2, "Count 2", 2, true) \
+  X(Count_3, "Count 3", 3, true) \
+  X(Count_4, "Count 4", 4, true)
+
+enum class Flags : uint8_t { FLAGS(SETTINGS_EXPAND_ENUM_CLASS) };
+enum class Counts : uint8_t { COUNTS(SETTINGS_EXPAND_ENUM_CLASS) };
+
+NVS::Settings<bool, Flags, SETTINGS_COUNT(FLAGS)> flags("bench_plain",
+                                                        {FLAGS(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<bool, Flags, SETTINGS_COUNT(FLAGS), NVS::Option::Cache>
+  cached_flags("bench_cache", {FLAGS(SETTINGS_EXPAND_SETTINGS)});
+
+NVS::Settings<uint32_t, Counts, SETTINGS_COUNT(COUNTS)> counts("bench_plain",
+                                                               {COUNTS(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<uint32_t, Counts, SETTINGS_COUNT(COUNTS), NVS::Option::Cache>
+  cached_counts("bench_cache", {COUNTS(SETTINGS_EXPAND_SETTINGS)});
+
+constexpr uint32_t READS = 20000;
+
+template <typename T, typename ENUM, typename S>
+void benchReads(S& settings, const char* type, const char* mode) {
+  constexpr size_t count = 4;
+  volatile uint32_t sink = 0;
+  T value{};
+
+  int64_t start = Bench::nowNs();
+  for (uint32_t i = 0; i < READS; i++) {
+    settings.getValue(static_cast<ENUM>(i % count), value);
+    sink = sink + static_cast<uint32_t>(value);
+  }
+  int64_t elapsed = Bench::nowNs() - start;
+  BENCH_PRINTF("%s,%s,getValue,%" PRIu32 ",%lld,%.0f\n",
+               type,
+               mode,
+               READS,
+               static_cast<long long>(elapsed / 1000),
+               READS * 1e9 / static_cast<double>(elapsed));
+
+  start = Bench::nowNs();
+  for (uint32_t i = 0; i < READS; i++) {
+    sink = sink + static_cast<uint32_t>(settings.getValueOrDefault(static_cast<ENUM>(i % count),
+                                                                   value));
+  }
+  elapsed = Bench::nowNs() - start;
+  BENCH_PRINTF("%s,%s,getValueOrDefault,%" PRIu32 ",%lld,%.0f\n",
+               type,
+               mode,
+               READS,
+               static_cast<long long>(elapsed / 1000),
+               READS * 1e9 / static_cast<double>(elapsed));
+}
+
+bool beginAll() {
+  if (!NVS::init() || !flags.begin() || !cached_flags.begin() || !counts.begin() ||
+      !cached_counts.begin()) {
+    return false;
+  }
+
+  // Store every key so reads hit existing entries
+  flags.formatAll(true);
+  cached_flags.formatAll(true);
+  counts.formatAll(true);
+  cached_counts.formatAll(true);
+  return true;
+}
+
+void runAllBenchmarks() {
+  BENCH_PRINTF("type,mode,api,reads,us,reads_per_sec\n");
+  benchReads<bool, Flags>(flags, "bool", "nvs");
+  benchReads<bool, Flags>(cached_flags, "bool", "cache");
+  benchReads<uint32_t, Counts>(counts, "uint32", "nvs");
+  benchReads<uint32_t, Counts>(cached_counts, "uint32", "cache");
+}
+
+#ifdef ARDUINO
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+
+  if (!beginAll()) {
+    Serial.println("Failed to initialize NVS!");
+    while (true)
+      delay(1000);
+  }
+
+  runAllBenchmarks();
+}
+
+void loop() {}
+#else
+int main() {
+  if (!beginAll()) return 1;
+  runAllBenchmarks();
+  return 0;
+}
+#endif
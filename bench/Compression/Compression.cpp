@@ -0,0 +1,182 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/** Benchmark: `Option::Compressed` against raw storage.
+ * - Strings: JSON documents of 256, 1024 and 2048 bytes. Byte streams: a table of slowly varying
+ *   16-bit samples (compressible) of 1024 and 2048 bytes, and random bytes (stored raw by the
+ *   fallback) of the largest size that fits in `SETTINGS_COMPRESS_BUFFER` with its header.
+ * - Each value is written and read back by a raw object and by a compressed one, both with
+ *   `Option::Wear` to count the flash entries every write appends.
+ * - Output: `type,data,bytes,mode,op,iterations,ops_per_sec,p50_ns,p99_ns,commits,entries`, one
+ *   line per case. `entries` is per write, so the same for both ops of a case.
+ */
+
+#include "../Bench.h"
+#include "SettingsManagerESP32.h"
+
+#include <stdio.h>
+
+#define BENCH_STRINGS(X) X(Value, "value", "", true)
+#define BENCH_STREAMS(X) X(Value, "value", NVS::ByteStreamView{}, true)
+
+enum class Strings : uint8_t { BENCH_STRINGS(SETTINGS_EXPAND_ENUM_CLASS) };
+enum class Streams : uint8_t { BENCH_STREAMS(SETTINGS_EXPAND_ENUM_CLASS) };
+
+constexpr uint32_t ITERATIONS = 200;
+constexpr size_t MAX_SIZE     = 2048;
+
+NVS::Settings<NVS::Str, Strings, SETTINGS_COUNT(BENCH_STRINGS), NVS::Option::Wear>
+  raw_strings("bench_raw", {BENCH_STRINGS(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<NVS::Str, Strings, SETTINGS_COUNT(BENCH_STRINGS),
+              NVS::Option::Compressed | NVS::Option::Wear>
+  lz_strings("bench_lz", {BENCH_STRINGS(SETTINGS_EXPAND_SETTINGS)});
+
+NVS::Settings<NVS::ByteStream, Streams, SETTINGS_COUNT(BENCH_STREAMS), NVS::Option::Wear>
+  raw_streams("bench_raw", {BENCH_STREAMS(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<NVS::ByteStream, Streams, SETTINGS_COUNT(BENCH_STREAMS),
+              NVS::Option::Compressed | NVS::Option::Wear>
+  lz_streams("bench_lz", {BENCH_STREAMS(SETTINGS_EXPAND_SETTINGS)});
+
+static char text[MAX_SIZE + 1];
+static uint8_t data[MAX_SIZE];
+static uint8_t buf[MAX_SIZE + 1];
+
+void report(const char* type, const char* kind, size_t bytes, const char* mode, const char* op,
+            const Bench::Result& r, uint32_t entries) {
+  BENCH_PRINTF("%s,%s,%u,%s,%s,%" PRIu32 ",%.0f,%lld,%lld,%" PRIu32 ",%" PRIu32 "\n",
+               type,
+               kind,
+               static_cast<unsigned>(bytes),
+               mode,
+               op,
+               r.iterations,
+               r.ops_per_sec,
+               static_cast<long long>(r.p50_ns),
+               static_cast<long long>(r.p99_ns),
+               r.commits,
+               entries);
+}
+
+// JSON document of similar records, `size` bytes long
+void makeJson(size_t size) {
+  size_t length = snprintf(text, sizeof(text), "{\"sensors\":[");
+  for (unsigned i = 0; length < size; i++) {
+    length += snprintf(text + length, sizeof(text) - length,
+                       "%s{\"id\":%u,\"name\":\"sensor-%u\",\"unit\":\"C\",\"min\":-40,"
+                       "\"max\":125}",
+                       i ? "," : "", i, i);
+  }
+  text[size - 2] = ']';
+  text[size - 1] = '}';
+  text[size]     = '\0';
+}
+
+void makeSamples(size_t size) {
+  for (size_t i = 0; i + 1 < size; i += 2) {
+    int16_t sample = static_cast<int16_t>(1000 + (i / 64) * 3);
+    memcpy(data + i, &sample, sizeof(sample));
+  }
+}
+
+void makeRandom(size_t size) {
+  uint32_t state = 12345;
+  for (size_t i = 0; i < size; i++) {
+    state   = state * 1103515245 + 12345;
+    data[i] = static_cast<uint8_t>(state >> 24);
+  }
+}
+
+template <typename S>
+void benchString(S& settings, const char* mode, size_t bytes) {
+  NVS::KeyWear wear;
+  settings.resetWear();
+
+  Bench::Result write =
+    Bench::measure(ITERATIONS, [&](uint32_t) { settings.setValue(Strings::Value, text); });
+  settings.getKeyWear(Strings::Value, wear);
+  uint32_t entries = wear.writes ? wear.entries / wear.writes : 0;
+
+  Bench::Result read = Bench::measure(ITERATIONS, [&](uint32_t) {
+    NVS::Str out{reinterpret_cast<char*>(buf), sizeof(buf)};
+    settings.getValue(Strings::Value, out);
+  });
+
+  report("string", "json", bytes, mode, "write", write, entries);
+  report("string", "json", bytes, mode, "read", read, entries);
+}
+
+template <typename S>
+void benchStream(S& settings, const char* kind, const char* mode, size_t bytes) {
+  NVS::KeyWear wear;
+  settings.resetWear();
+
+  Bench::Result write = Bench::measure(ITERATIONS, [&](uint32_t) {
+    settings.setValue(Streams::Value, NVS::ByteStreamView{data, bytes});
+  });
+  settings.getKeyWear(Streams::Value, wear);
+  uint32_t entries = wear.writes ? wear.entries / wear.writes : 0;
+
+  Bench::Result read = Bench::measure(ITERATIONS, [&](uint32_t) {
+    NVS::ByteStream out(buf, sizeof(buf));
+    settings.getValue(Streams::Value, out);
+  });
+
+  report("bytestream", kind, bytes, mode, "write", write, entries);
+  report("bytestream", kind, bytes, mode, "read", read, entries);
+}
+
+void runAllBenchmarks() {
+  if (!raw_strings.begin() || !lz_strings.begin() || !raw_streams.begin() || !lz_streams.begin()) {
+    BENCH_PRINTF("begin() failed\n");
+    return;
+  }
+
+  BENCH_PRINTF("type,data,bytes,mode,op,iterations,ops_per_sec,p50_ns,p99_ns,commits,entries\n");
+
+  for (size_t bytes : {256, 1024, 2048}) {
+    makeJson(bytes);
+    benchString(raw_strings, "raw", bytes);
+    benchString(lz_strings, "compressed", bytes);
+  }
+
+  for (size_t bytes : {1024, 2048}) {
+    makeSamples(bytes);
+    benchStream(raw_streams, "samples", "raw", bytes);
+    benchStream(lz_streams, "samples", "compressed", bytes);
+  }
+
+  size_t random_bytes = SETTINGS_COMPRESS_BUFFER - NVS::Internal::LZ_HEADER_SIZE;
+  makeRandom(random_bytes);
+  benchStream(raw_streams, "random", "raw", random_bytes);
+  benchStream(lz_streams, "random", "compressed", random_bytes);
+
+  raw_strings.eraseAll();
+  lz_strings.eraseAll();
+}
+
+#ifdef ARDUINO
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+
+  if (!NVS::init()) {
+    Serial.println("Failed to initialize NVS!");
+    while (true)
+      delay(1000);
+  }
+
+  runAllBenchmarks();
+}
+
+void loop() {}
+#else
+int main() {
+  if (!NVS::init()) return 1;
+
+  runAllBenchmarks();
+  return 0;
+}
+#endif
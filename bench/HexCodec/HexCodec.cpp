@@ -0,0 +1,157 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/** Benchmark: hex encoding and decoding throughput.
+ * - `fromHexToStr()` and `fromStrToHex()` (table-driven, 16 bytes per step with SSE2/NEON on the
+ *   host, 4 bytes per step on the ESP32) are compared with the previous nibble-at-a-time
+ *   implementation, copied below as the reference.
+ * - Blobs of 32, 256 and 2048 bytes (a certificate), compact (`"DEADBEEF"`) and spaced
+ *   (`"DE AD BE EF"`).
+ * - No NVS access.
+ * - Output: `op,impl,spaced,bytes,iterations,mb_per_sec,p50_ns,p99_ns`, one line per case. One op
+ *   encodes or decodes the whole blob; MB/s counts blob bytes.
+ */
+
+#include "../Bench.h"
+#include "SettingsManagerESP32.h"
+
+#include <stdio.h>
+#include <string.h>
+
+constexpr size_t MAX_SIZE         = 2048;
+constexpr uint32_t ITERATIONS     = 500;
+constexpr uint32_t CALLS_PER_ITER = 8; // Keep each sample well above the timer resolution
+
+static uint8_t blob[MAX_SIZE];
+static uint8_t decoded[MAX_SIZE];
+static char text[NVS::hexStrSize(MAX_SIZE, true)];
+
+namespace Reference {
+
+bool fromHexToStr(const NVS::ByteStreamView bs, char* buf, const size_t buf_size,
+                  const bool with_spaces) {
+  if (!bs.data || buf_size < NVS::hexStrSize(bs.size, with_spaces)) return false;
+
+  static const char HEX_CHARS[] = "0123456789ABCDEF";
+
+  for (size_t i = 0; i < bs.size; i++) {
+    size_t pos   = with_spaces ? i * 3 : i * 2;
+    buf[pos]     = HEX_CHARS[bs.data[i] >> 4];
+    buf[pos + 1] = HEX_CHARS[bs.data[i] & 0x0F];
+    if (with_spaces && i < bs.size - 1) buf[pos + 2] = ' ';
+  }
+
+  buf[with_spaces ? bs.size * 3 - 1 : bs.size * 2] = '\0';
+  return true;
+}
+
+bool nibble(char c, uint8_t& out) {
+  if (c >= '0' && c <= '9')
+    out = c - '0';
+  else if (c >= 'A' && c <= 'F')
+    out = c - 'A' + 10;
+  else if (c >= 'a' && c <= 'f')
+    out = c - 'a' + 10;
+  else
+    return false;
+  return true;
+}
+
+bool fromStrToHex(const char* hex, NVS::ByteStream& out, const bool with_spaces) {
+  if (!hex || !out.data) return false;
+
+  size_t len = strlen(hex);
+  size_t byte_count;
+
+  if (with_spaces) {
+    if (len == 0) {
+      out.size = 0;
+      return true;
+    }
+    if ((len + 1) % 3 != 0) return false;
+    byte_count = (len + 1) / 3;
+  } else {
+    if (len % 2 != 0) return false;
+    byte_count = len / 2;
+  }
+
+  if (byte_count > out.max_size) return false;
+
+  for (size_t i = 0; i < byte_count; i++) {
+    size_t pos = with_spaces ? i * 3 : i * 2;
+    uint8_t high, low;
+    if (!nibble(hex[pos], high) || !nibble(hex[pos + 1], low)) return false;
+    if (with_spaces && i < byte_count - 1 && hex[pos + 2] != ' ') return false;
+    out.data[i] = (high << 4) | low;
+  }
+
+  out.size = byte_count;
+  return true;
+}
+
+} // namespace Reference
+
+void report(const char* op, const char* impl, bool spaced, size_t size, const Bench::Result& r) {
+  BENCH_PRINTF("%s,%s,%u,%u,%" PRIu32 ",%.1f,%lld,%lld\n",
+               op,
+               impl,
+               spaced ? 1u : 0u,
+               static_cast<unsigned>(size),
+               r.iterations * CALLS_PER_ITER,
+               r.ops_per_sec * CALLS_PER_ITER * size / 1e6,
+               static_cast<long long>(r.p50_ns / CALLS_PER_ITER),
+               static_cast<long long>(r.p99_ns / CALLS_PER_ITER));
+}
+
+template <typename Encode, typename Decode>
+void benchImpl(const char* impl, size_t size, bool spaced, Encode encode, Decode decode) {
+  NVS::ByteStreamView view{blob, size};
+  volatile size_t sink = 0;
+
+  report("encode", impl, spaced, size, Bench::measure(ITERATIONS, [&](uint32_t) {
+           for (uint32_t c = 0; c < CALLS_PER_ITER; c++) {
+             encode(view, text, sizeof(text), spaced);
+             sink = sink + static_cast<uint8_t>(text[0]);
+           }
+         }));
+
+  report("decode", impl, spaced, size, Bench::measure(ITERATIONS, [&](uint32_t) {
+           for (uint32_t c = 0; c < CALLS_PER_ITER; c++) {
+             NVS::ByteStream out{decoded, sizeof(decoded)};
+             decode(text, out, spaced);
+             sink = sink + out.size;
+           }
+         }));
+}
+
+void runAllBenchmarks() {
+  for (size_t i = 0; i < MAX_SIZE; i++)
+    blob[i] = static_cast<uint8_t>(i * 131 + 7);
+
+  BENCH_PRINTF("op,impl,spaced,bytes,iterations,mb_per_sec,p50_ns,p99_ns\n");
+
+  for (size_t size : {32, 256, 2048}) {
+    for (bool spaced : {false, true}) {
+      benchImpl("table", size, spaced, NVS::fromHexToStr, NVS::fromStrToHex);
+      benchImpl("reference", size, spaced, Reference::fromHexToStr, Reference::fromStrToHex);
+    }
+  }
+}
+
+#ifdef ARDUINO
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+  runAllBenchmarks();
+}
+
+void loop() {}
+#else
+int main() {
+  runAllBenchmarks();
+  return 0;
+}
+#endif
@@ -0,0 +1,106 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/** Benchmark: key string -> index resolution at N = 255.
+ * - One Settings object with 255 keys built at runtime ("setting_000", "setting_001", ...), which
+ *   share a long prefix like real configuration keys do.
+ * - `hasKey()` with `Option::KeyIndex` (hash index) is compared with the linear `strcmp()` scan
+ *   over `getKey()` objects without it do, for the first, middle and last key and for a missing key.
+ * - No NVS access: `hasKey()` works without `begin()`.
+ * - Output: `op,key,iterations,ops_per_sec,p50_ns,p99_ns,commits`, one line per case.
+ */
+
+#include "../Bench.h"
+#include "SettingsManagerESP32.h"
+
+#include <memory>
+#include <stdio.h>
+#include <string.h>
+
+enum class BenchKey : uint8_t {};
+
+constexpr size_t N                = 255;
+constexpr uint32_t ITERATIONS     = 1000;
+constexpr uint32_t CALLS_PER_ITER = 16; // Keep each sample well above the timer resolution
+
+using BenchSettings = NVS::Settings<uint32_t, BenchKey, N, NVS::Option::KeyIndex>;
+
+static char keys[N][16];
+static std::unique_ptr<BenchSettings> settings;
+
+bool linearScan(const NVS::ISettings& s, const char* key, size_t& index_found) {
+  for (size_t i = 0; i < s.getSize(); i++) {
+    if (strcmp(s.getKey(i), key) == 0) {
+      index_found = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+void report(const char* op, const char* key, const Bench::Result& r) {
+  BENCH_PRINTF("%s,%s,%" PRIu32 ",%.0f,%lld,%lld,%" PRIu32 "\n",
+               op,
+               key,
+               r.iterations * CALLS_PER_ITER,
+               r.ops_per_sec * CALLS_PER_ITER,
+               static_cast<long long>(r.p50_ns / CALLS_PER_ITER),
+               static_cast<long long>(r.p99_ns / CALLS_PER_ITER),
+               r.commits);
+}
+
+void benchKey(const char* key) {
+  volatile size_t sink = 0;
+
+  report("hasKey", key, Bench::measure(ITERATIONS, [&](uint32_t) {
+           for (uint32_t c = 0; c < CALLS_PER_ITER; c++) {
+             size_t index = 0;
+             settings->hasKey(key, index);
+             sink = sink + index;
+           }
+         }));
+
+  report("linearScan", key, Bench::measure(ITERATIONS, [&](uint32_t) {
+           for (uint32_t c = 0; c < CALLS_PER_ITER; c++) {
+             size_t index = 0;
+             linearScan(*settings, key, index);
+             sink = sink + index;
+           }
+         }));
+}
+
+void runAllBenchmarks() {
+  std::array<BenchSettings::Struct, N> list;
+  for (size_t i = 0; i < N; i++) {
+    snprintf(keys[i], sizeof(keys[i]), "setting_%03u", static_cast<unsigned>(i));
+    list[i] = {keys[i], "", 0, true};
+  }
+
+  settings.reset(new BenchSettings("bench_keys", list));
+
+  BENCH_PRINTF("op,key,iterations,ops_per_sec,p50_ns,p99_ns,commits\n");
+  benchKey(keys[0]);
+  benchKey(keys[N / 2]);
+  benchKey(keys[N - 1]);
+  benchKey("setting_999");
+
+  settings.reset();
+}
+
+#ifdef ARDUINO
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+  runAllBenchmarks();
+}
+
+void loop() {}
+#else
+int main() {
+  runAllBenchmarks();
+  return 0;
+}
+#endif
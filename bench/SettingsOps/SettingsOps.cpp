@@ -0,0 +1,236 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/** Benchmark: cost of every Settings operation, for each value type and N = 3, 32 and 255.
+ * - Each (type, N) pair gets its own Settings object in its own namespace, with keys built at
+ *   runtime ("k000", "k001", ...). The namespace is erased before and after the run.
+ * - Writes alternate between two values so that every call changes the stored value.
+ * - Operations: setValue, getValue, getValueOrDefault (stored and absent keys), hasKey, format,
+ *   formatAll, and the ISettings pointer paths setValuePtr, getValuePtr, getValuePtrOrDefault.
+ * - Output: `op,type,n,iterations,ops_per_sec,p50_ns,p99_ns,commits`, one line per operation.
+ *
+ * On the ESP32, 255 strings or byte streams do not fit in the default 20 KB NVS partition: use the
+ * `esp32-s3-bench` environment, which also selects bench/partitions.csv (256 KB NVS partition).
+ */
+
+#include "../Bench.h"
+#include "SettingsManagerESP32.h"
+
+#include <memory>
+#include <stdio.h>
+
+enum class BenchKey : uint8_t {};
+
+constexpr size_t MAX_N = 255;
+
+constexpr uint32_t WRITE_ITERATIONS  = 200;
+constexpr uint32_t READ_ITERATIONS   = 1000;
+constexpr uint32_t FORMAT_ITERATIONS = 10;
+
+static char keys[MAX_N][8];
+
+static const uint8_t blob_a[] = {0xDE, 0xAD, 0xBE, 0xEF, 0x00, 0x11, 0x22, 0x33};
+static const uint8_t blob_b[] = {0xCA, 0xFE, 0xBA, 0xBE, 0x44, 0x55, 0x66, 0x77};
+
+// Two alternating values per type, and a default
+template <typename T>
+struct Values;
+
+template <>
+struct Values<bool> {
+  static bool get(uint32_t i) { return (i & 1) != 0; }
+};
+
+template <>
+struct Values<uint32_t> {
+  static uint32_t get(uint32_t i) { return (i & 1) ? 0xA5A5A5A5u : 0x5A5A5A5Au; }
+};
+
+template <>
+struct Values<int32_t> {
+  static int32_t get(uint32_t i) { return (i & 1) ? -123456 : 654321; }
+};
+
+template <>
+struct Values<float> {
+  static float get(uint32_t i) { return (i & 1) ? 1.5f : -2.25f; }
+};
+
+template <>
+struct Values<double> {
+  static double get(uint32_t i) { return (i & 1) ? 1.123456789 : -9.87654321; }
+};
+
+template <>
+struct Values<NVS::Str> {
+  static NVS::StrView get(uint32_t i) { return (i & 1) ? "value-odd" : "value-even"; }
+};
+
+template <>
+struct Values<NVS::ByteStream> {
+  static NVS::ByteStreamView get(uint32_t i) {
+    return (i & 1) ? NVS::ByteStreamView{blob_a, sizeof(blob_a)}
+                   : NVS::ByteStreamView{blob_b, sizeof(blob_b)};
+  }
+};
+
+// Read destination per type. Strings and byte streams need a caller-owned buffer.
+template <typename T>
+struct Reader {
+  T value{};
+  T& out() { return value; }
+};
+
+template <>
+struct Reader<NVS::Str> {
+  char buf[32];
+  NVS::Str value{buf, sizeof(buf)};
+  NVS::Str& out() { return value; }
+};
+
+template <>
+struct Reader<NVS::ByteStream> {
+  uint8_t buf[32];
+  NVS::ByteStream value{buf, sizeof(buf)};
+  NVS::ByteStream& out() {
+    value = NVS::ByteStream{buf, sizeof(buf)};
+    return value;
+  }
+};
+
+void report(const char* op, const char* type, size_t n, const Bench::Result& r) {
+  BENCH_PRINTF("%s,%s,%u,%" PRIu32 ",%.0f,%lld,%lld,%" PRIu32 "\n",
+               op,
+               type,
+               static_cast<unsigned>(n),
+               r.iterations,
+               r.ops_per_sec,
+               static_cast<long long>(r.p50_ns),
+               static_cast<long long>(r.p99_ns),
+               r.commits);
+}
+
+template <typename T, size_t N>
+void runSuite() {
+  using S = NVS::Settings<T, BenchKey, N>;
+
+  std::array<typename S::Struct, N> list;
+  for (size_t i = 0; i < N; i++) {
+    list[i] = {keys[i], "", Values<T>::get(0), true};
+  }
+
+  char ns[16];
+  snprintf(ns, sizeof(ns), "b%u_%u", static_cast<unsigned>(NVS::Internal::PolicyTrait<T>::enum_type),
+           static_cast<unsigned>(N));
+
+  std::unique_ptr<S> settings(new S(ns, list));
+  NVS::ISettings* iface = settings.get();
+  const char* type      = NVS::typeToStr(settings->getType());
+
+  if (!settings->begin() || !settings->eraseAll()) {
+    BENCH_PRINTF("# %s/%u: failed to open namespace %s\n", type, static_cast<unsigned>(N), ns);
+    return;
+  }
+
+  Reader<T> reader;
+
+  // Absent keys first, while the namespace is empty
+  report("getValueOrDefault(absent)", type, N, Bench::measure(READ_ITERATIONS, [&](uint32_t i) {
+           settings->getValueOrDefault(static_cast<BenchKey>(i % N), reader.out());
+         }));
+
+  report("setValue", type, N, Bench::measure(WRITE_ITERATIONS, [&](uint32_t i) {
+           settings->setValue(static_cast<BenchKey>(i % N), Values<T>::get(i / N + 1));
+         }));
+
+  // Make sure every key exists for the read paths
+  settings->formatAll(true);
+
+  report("getValue", type, N, Bench::measure(READ_ITERATIONS, [&](uint32_t i) {
+           settings->getValue(static_cast<BenchKey>(i % N), reader.out());
+         }));
+
+  report("getValueOrDefault", type, N, Bench::measure(READ_ITERATIONS, [&](uint32_t i) {
+           settings->getValueOrDefault(static_cast<BenchKey>(i % N), reader.out());
+         }));
+
+  report("hasKey", type, N, Bench::measure(READ_ITERATIONS, [&](uint32_t i) {
+           size_t index;
+           settings->hasKey(keys[i % N], index);
+         }));
+
+  report("format", type, N, Bench::measure(WRITE_ITERATIONS, [&](uint32_t i) {
+           settings->format(static_cast<BenchKey>(i % N), true);
+         }));
+
+  report("formatAll", type, N, Bench::measure(FORMAT_ITERATIONS, [&](uint32_t) {
+           settings->formatAll(true);
+         }));
+
+  report("setValuePtr", type, N, Bench::measure(WRITE_ITERATIONS, [&](uint32_t i) {
+           auto value = Values<T>::get(i / N + 1);
+           iface->setValuePtr(i % N, &value);
+         }));
+
+  report("getValuePtr", type, N, Bench::measure(READ_ITERATIONS, [&](uint32_t i) {
+           iface->getValuePtr(i % N, &reader.out(), sizeof(T));
+         }));
+
+  report("getValuePtrOrDefault", type, N, Bench::measure(READ_ITERATIONS, [&](uint32_t i) {
+           iface->getValuePtrOrDefault(i % N, &reader.out(), sizeof(T));
+         }));
+
+  settings->eraseAll();
+  settings->end();
+}
+
+template <typename T>
+void runType() {
+  runSuite<T, 3>();
+  runSuite<T, 32>();
+  runSuite<T, MAX_N>();
+}
+
+void runAllBenchmarks() {
+  for (size_t i = 0; i < MAX_N; i++) {
+    snprintf(keys[i], sizeof(keys[i]), "k%03u", static_cast<unsigned>(i));
+  }
+
+  BENCH_PRINTF("op,type,n,iterations,ops_per_sec,p50_ns,p99_ns,commits\n");
+  runType<bool>();
+  runType<uint32_t>();
+  runType<int32_t>();
+  runType<float>();
+  runType<double>();
+  runType<NVS::Str>();
+  runType<NVS::ByteStream>();
+}
+
+#ifdef ARDUINO
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+
+  if (!NVS::init()) {
+    Serial.println("Failed to initialize NVS!");
+    while (true)
+      delay(1000);
+  }
+
+  runAllBenchmarks();
+}
+
+void loop() {}
+#else
+int main() {
+  // 255 strings or byte streams need more than the default 5 pages
+  nvs_host_set_partition_pages(nullptr, 64);
+  if (!NVS::init()) return 1;
+
+  runAllBenchmarks();
+  return 0;
+}
+#endif
@@ -0,0 +1,106 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/** Benchmark: reading a whole object at N = 100.
+ * - One Settings object with 100 `uint32_t` keys built at runtime, of which 0, 10, 50 or all 100
+ *   are stored in NVS.
+ * - `snapshot()` (one namespace scan, then reads of the stored keys only) is compared with the
+ *   `getValuePtrOrDefault()` loop over every index it replaces.
+ * - Output: `op,stored,iterations,ops_per_sec,p50_ns,p99_ns,commits`, one line per case. One op
+ *   reads the whole object.
+ */
+
+#include "../Bench.h"
+#include "SettingsManagerESP32.h"
+
+#include <memory>
+#include <stdio.h>
+
+enum class BenchKey : uint8_t {};
+
+constexpr size_t N            = 100;
+constexpr uint32_t ITERATIONS = 200;
+
+using BenchSettings = NVS::Settings<uint32_t, BenchKey, N>;
+
+static char keys[N][16];
+static std::unique_ptr<BenchSettings> settings;
+static std::array<uint32_t, N> values;
+
+void report(const char* op, size_t stored, const Bench::Result& r) {
+  BENCH_PRINTF("%s,%u,%" PRIu32 ",%.0f,%lld,%lld,%" PRIu32 "\n",
+               op,
+               static_cast<unsigned>(stored),
+               r.iterations,
+               r.ops_per_sec,
+               static_cast<long long>(r.p50_ns),
+               static_cast<long long>(r.p99_ns),
+               r.commits);
+}
+
+void benchStored(size_t stored) {
+  settings->eraseAll();
+  for (size_t i = 0; i < stored; i++) {
+    settings->setValuePtr(i, &i);
+  }
+
+  report("snapshot", stored, Bench::measure(ITERATIONS, [&](uint32_t) {
+           settings->snapshot(values);
+         }));
+
+  report("perKeyLoop", stored, Bench::measure(ITERATIONS, [&](uint32_t) {
+           for (size_t i = 0; i < N; i++) {
+             settings->getValuePtrOrDefault(i, &values[i], sizeof(values[i]));
+           }
+         }));
+}
+
+void runAllBenchmarks() {
+  std::array<BenchSettings::Struct, N> list;
+  for (size_t i = 0; i < N; i++) {
+    snprintf(keys[i], sizeof(keys[i]), "setting_%03u", static_cast<unsigned>(i));
+    list[i] = {keys[i], "", 0, true};
+  }
+
+  settings.reset(new BenchSettings("bench_snap", list));
+  if (!settings->begin()) {
+    BENCH_PRINTF("begin() failed\n");
+    return;
+  }
+
+  BENCH_PRINTF("op,stored,iterations,ops_per_sec,p50_ns,p99_ns,commits\n");
+  benchStored(0);
+  benchStored(N / 10);
+  benchStored(N / 2);
+  benchStored(N);
+
+  settings->eraseAll();
+  settings.reset();
+}
+
+#ifdef ARDUINO
+void setup() {
+  Serial.begin(115200);
+  delay(2000);
+
+  if (!NVS::init()) {
+    Serial.println("Failed to initialize NVS!");
+    while (true)
+      delay(1000);
+  }
+
+  runAllBenchmarks();
+}
+
+void loop() {}
+#else
+int main() {
+  if (!NVS::init()) return 1;
+
+  runAllBenchmarks();
+  return 0;
+}
+#endif
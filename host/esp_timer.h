@@ -0,0 +1,22 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/// Host stand-in for ESP-IDF `esp_timer.h`, backed by `std::chrono::steady_clock`.
+
+#pragma once
+
+#include <chrono>
+#include <stdint.h>
+
+/**
+ * @brief Get the time in microseconds since the first call.
+ * @return Monotonic time in microseconds.
+ */
+inline int64_t esp_timer_get_time() {
+  using namespace std::chrono;
+  static const steady_clock::time_point start = steady_clock::now();
+  return duration_cast<microseconds>(steady_clock::now() - start).count();
+}
@@ -0,0 +1,577 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/**
+ * Host stand-in for the ESP-IDF NVS API (`nvs.h` + `nvs_flash.h`), used to build and test the
+ * library on Linux. Header-only: every function is `inline` and the whole storage lives in a
+ * single process-wide state object guarded by a mutex.
+ *
+ * Behavior mirrors ESP-IDF where the library depends on it:
+ * - Partitions must be initialized before `nvs_open()`; `nvs_flash_erase()` deinitializes them.
+ * - Keys and namespace names are limited to 15 characters.
+ * - Writes are visible immediately; `nvs_commit()` is counted but otherwise a no-op.
+ * - `nvs_get_str()`/`nvs_get_blob()` with a null buffer return the required size, and with a too
+ *   small buffer return `ESP_ERR_NVS_INVALID_LENGTH` and set the required size.
+ * - Reading a key with a different type than it was written with returns `ESP_ERR_NVS_NOT_FOUND`.
+ * - Entry accounting follows the NVS page format (126 entries of 32 bytes per 4 KB page, one page
+ *   kept free for garbage collection), so `nvs_get_stats()` and space errors behave realistically.
+ *
+ * Extra `nvs_host_*` functions expose operation counters and allow resetting the whole storage
+ * between tests.
+ */
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "esp_err.h"
+
+#define ESP_ERR_NVS_BASE              0x1100
+#define ESP_ERR_NVS_NOT_INITIALIZED   (ESP_ERR_NVS_BASE + 0x01)
+#define ESP_ERR_NVS_NOT_FOUND         (ESP_ERR_NVS_BASE + 0x02)
+#define ESP_ERR_NVS_TYPE_MISMATCH     (ESP_ERR_NVS_BASE + 0x03)
+#define ESP_ERR_NVS_READ_ONLY         (ESP_ERR_NVS_BASE + 0x04)
+#define ESP_ERR_NVS_NOT_ENOUGH_SPACE  (ESP_ERR_NVS_BASE + 0x05)
+#define ESP_ERR_NVS_INVALID_NAME      (ESP_ERR_NVS_BASE + 0x06)
+#define ESP_ERR_NVS_INVALID_HANDLE    (ESP_ERR_NVS_BASE + 0x07)
+#define ESP_ERR_NVS_REMOVE_FAILED     (ESP_ERR_NVS_BASE + 0x08)
+#define ESP_ERR_NVS_KEY_TOO_LONG      (ESP_ERR_NVS_BASE + 0x09)
+#define ESP_ERR_NVS_PAGE_FULL         (ESP_ERR_NVS_BASE + 0x0a)
+#define ESP_ERR_NVS_INVALID_STATE     (ESP_ERR_NVS_BASE + 0x0b)
+#define ESP_ERR_NVS_INVALID_LENGTH    (ESP_ERR_NVS_BASE + 0x0c)
+#define ESP_ERR_NVS_NO_FREE_PAGES     (ESP_ERR_NVS_BASE + 0x0d)
+#define ESP_ERR_NVS_VALUE_TOO_LONG    (ESP_ERR_NVS_BASE + 0x0e)
+#define ESP_ERR_NVS_PART_NOT_FOUND    (ESP_ERR_NVS_BASE + 0x0f)
+
+#define NVS_DEFAULT_PART_NAME  "nvs"
+#define NVS_PART_NAME_MAX_SIZE 16 // Without the null terminator
+#define NVS_KEY_NAME_MAX_SIZE  16
+#define NVS_NS_NAME_MAX_SIZE   NVS_KEY_NAME_MAX_SIZE
+
+typedef uint32_t nvs_handle_t;
+
+typedef enum { NVS_READONLY, NVS_READWRITE } nvs_open_mode_t;
+
+typedef enum {
+  NVS_TYPE_U8   = 0x01,
+  NVS_TYPE_I8   = 0x11,
+  NVS_TYPE_U16  = 0x02,
+  NVS_TYPE_I16  = 0x12,
+  NVS_TYPE_U32  = 0x04,
+  NVS_TYPE_I32  = 0x14,
+  NVS_TYPE_U64  = 0x08,
+  NVS_TYPE_I64  = 0x18,
+  NVS_TYPE_STR  = 0x21,
+  NVS_TYPE_BLOB = 0x42,
+  NVS_TYPE_ANY  = 0xff
+} nvs_type_t;
+
+typedef struct {
+  size_t used_entries;
+  size_t free_entries;
+  size_t available_entries;
+  size_t total_entries;
+  size_t namespace_count;
+} nvs_stats_t;
+
+typedef struct {
+  char namespace_name[NVS_NS_NAME_MAX_SIZE];
+  char key[NVS_KEY_NAME_MAX_SIZE];
+  nvs_type_t type;
+} nvs_entry_info_t;
+
+typedef struct nvs_opaque_iterator_t {
+  std::vector<nvs_entry_info_t> entries;
+  size_t pos;
+} nvs_opaque_iterator_t;
+
+typedef nvs_opaque_iterator_t* nvs_iterator_t;
+
+/// @brief Operation counters of the host NVS stand-in, accumulated since the last reset.
+typedef struct {
+  uint32_t opens;           // Successful nvs_open() calls
+  uint32_t gets;            // nvs_get_*() calls (any result)
+  uint32_t sets;            // Successful nvs_set_*() calls
+  uint32_t commits;         // nvs_commit() calls
+  uint32_t erases;          // nvs_erase_key() and nvs_erase_all() calls
+  uint32_t entries_written; // 32-byte entries appended to flash by writes
+} nvs_host_counters_t;
+
+namespace NVSHost {
+
+constexpr size_t ENTRIES_PER_PAGE   = 126;
+constexpr size_t ENTRY_SIZE         = 32;
+constexpr size_t DEFAULT_PAGE_COUNT = 5; // 0x5000 bytes, as the default "nvs" partition
+constexpr size_t MAX_STR_SIZE       = 4000;
+
+struct Item {
+  nvs_type_t type;
+  std::vector<uint8_t> data;
+};
+
+using Namespace = std::map<std::string, Item>;
+
+struct Partition {
+  bool initialized  = false;
+  size_t page_count = DEFAULT_PAGE_COUNT;
+  std::map<std::string, Namespace> namespaces;
+};
+
+struct Handle {
+  std::string partition;
+  std::string ns;
+  nvs_open_mode_t mode;
+};
+
+struct State {
+  std::recursive_mutex mutex;
+  std::map<std::string, Partition> partitions;
+  std::map<nvs_handle_t, Handle> handles;
+  nvs_handle_t next_handle = 1;
+  nvs_host_counters_t counters{};
+};
+
+// Never destroyed, so Settings objects with static storage can still close their handles at exit
+inline State& state() {
+  static State* s = new State;
+  return *s;
+}
+
+inline const char* partName(const char* part_name) {
+  return part_name ? part_name : NVS_DEFAULT_PART_NAME;
+}
+
+// Number of 32-byte entries an item occupies in flash.
+inline size_t itemEntries(const Item& item) {
+  size_t span = 1;
+  if (item.type == NVS_TYPE_STR || item.type == NVS_TYPE_BLOB) {
+    span += (item.data.size() + ENTRY_SIZE - 1) / ENTRY_SIZE;
+  }
+  // Blobs are stored as a data chunk plus a separate index entry
+  if (item.type == NVS_TYPE_BLOB) span++;
+  return span;
+}
+
+inline size_t usedEntries(const Partition& p) {
+  size_t used = 0;
+  for (const auto& ns : p.namespaces) {
+    used++; // Namespace entry
+    for (const auto& kv : ns.second)
+      used += itemEntries(kv.second);
+  }
+  return used;
+}
+
+inline size_t totalEntries(const Partition& p) { return p.page_count * ENTRIES_PER_PAGE; }
+
+inline bool validName(const char* name) {
+  return name && name[0] != '\0' && strlen(name) < NVS_KEY_NAME_MAX_SIZE;
+}
+
+inline Handle* findHandle(nvs_handle_t handle) {
+  auto it = state().handles.find(handle);
+  return it == state().handles.end() ? nullptr : &it->second;
+}
+
+inline Namespace* findNamespace(const Handle& h) {
+  auto& parts = state().partitions;
+  auto p      = parts.find(h.partition);
+  if (p == parts.end() || !p->second.initialized) return nullptr;
+  return &p->second.namespaces[h.ns];
+}
+
+inline esp_err_t setItem(nvs_handle_t handle, const char* key, nvs_type_t type, const void* data,
+                         size_t size) {
+  std::lock_guard<std::recursive_mutex> lock(state().mutex);
+
+  Handle* h = findHandle(handle);
+  if (!h) return ESP_ERR_NVS_INVALID_HANDLE;
+  if (h->mode == NVS_READONLY) return ESP_ERR_NVS_READ_ONLY;
+  if (!key) return ESP_ERR_INVALID_ARG;
+  if (strlen(key) >= NVS_KEY_NAME_MAX_SIZE) return ESP_ERR_NVS_KEY_TOO_LONG;
+  if (!validName(key)) return ESP_ERR_NVS_INVALID_NAME;
+  if (type == NVS_TYPE_STR && size > MAX_STR_SIZE) return ESP_ERR_NVS_VALUE_TOO_LONG;
+
+  Namespace* ns = findNamespace(*h);
+  if (!ns) return ESP_ERR_NVS_INVALID_HANDLE;
+
+  Partition& part = state().partitions[h->partition];
+  Item item{type, std::vector<uint8_t>(static_cast<const uint8_t*>(data),
+                                       static_cast<const uint8_t*>(data) + size)};
+
+  // The old copy of the key is released once the new one is written, so both must fit
+  size_t needed = itemEntries(item);
+  size_t free   = totalEntries(part) - usedEntries(part);
+  if (needed + ENTRIES_PER_PAGE > free) return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+
+  (*ns)[key] = std::move(item);
+  state().counters.sets++;
+  state().counters.entries_written += static_cast<uint32_t>(needed);
+  return ESP_OK;
+}
+
+inline esp_err_t getItem(nvs_handle_t handle, const char* key, nvs_type_t type, const Item** out) {
+  std::lock_guard<std::recursive_mutex> lock(state().mutex);
+  state().counters.gets++;
+
+  Handle* h = findHandle(handle);
+  if (!h) return ESP_ERR_NVS_INVALID_HANDLE;
+  if (!key) return ESP_ERR_INVALID_ARG;
+
+  Namespace* ns = findNamespace(*h);
+  if (!ns) return ESP_ERR_NVS_INVALID_HANDLE;
+
+  auto it = ns->find(key);
+  if (it == ns->end() || it->second.type != type) return ESP_ERR_NVS_NOT_FOUND;
+
+  *out = &it->second;
+  return ESP_OK;
+}
+
+template <typename V>
+inline esp_err_t getScalar(nvs_handle_t handle, const char* key, nvs_type_t type, V* out_value) {
+  std::lock_guard<std::recursive_mutex> lock(state().mutex);
+  const Item* item = nullptr;
+  esp_err_t err    = getItem(handle, key, type, &item);
+  if (err != ESP_OK) return err;
+  if (!out_value) return ESP_ERR_INVALID_ARG;
+  memcpy(out_value, item->data.data(), sizeof(V));
+  return ESP_OK;
+}
+
+inline esp_err_t getVariable(nvs_handle_t handle, const char* key, nvs_type_t type, void* out_value,
+                             size_t* length) {
+  std::lock_guard<std::recursive_mutex> lock(state().mutex);
+  const Item* item = nullptr;
+  esp_err_t err    = getItem(handle, key, type, &item);
+  if (err != ESP_OK) return err;
+  if (!length) return ESP_ERR_NVS_INVALID_LENGTH;
+
+  size_t size = item->data.size();
+  if (!out_value) {
+    *length = size;
+    return ESP_OK;
+  }
+  if (*length < size) {
+    *length = size;
+    return ESP_ERR_NVS_INVALID_LENGTH;
+  }
+
+  memcpy(out_value, item->data.data(), size);
+  *length = size;
+  return ESP_OK;
+}
+
+inline esp_err_t initPartition(const char* part_name) {
+  std::lock_guard<std::recursive_mutex> lock(state().mutex);
+  state().partitions[partName(part_name)].initialized = true;
+  return ESP_OK;
+}
+
+inline esp_err_t deinitPartition(const char* part_name) {
+  std::lock_guard<std::recursive_mutex> lock(state().mutex);
+  auto& parts = state().partitions;
+  auto p      = parts.find(partName(part_name));
+  if (p == parts.end() || !p->second.initialized) return ESP_ERR_NVS_NOT_INITIALIZED;
+
+  p->second.initialized = false;
+  for (auto it = state().handles.begin(); it != state().handles.end();) {
+    it = (it->second.partition == p->first) ? state().handles.erase(it) : std::next(it);
+  }
+  return ESP_OK;
+}
+
+inline esp_err_t erasePartition(const char* part_name) {
+  std::lock_guard<std::recursive_mutex> lock(state().mutex);
+  deinitPartition(part_name);
+  state().partitions[partName(part_name)].namespaces.clear();
+  return ESP_OK;
+}
+
+inline esp_err_t findEntries(const std::string& part, const char* ns_name, nvs_type_t type,
+                             nvs_iterator_t* output_iterator) {
+  if (!output_iterator) return ESP_ERR_INVALID_ARG;
+  *output_iterator = nullptr;
+
+  auto& parts = state().partitions;
+  auto p      = parts.find(part);
+  if (p == parts.end() || !p->second.initialized) return ESP_ERR_NVS_NOT_FOUND;
+
+  auto* it = new nvs_opaque_iterator_t{{}, 0};
+  for (const auto& ns : p->second.namespaces) {
+    if (ns_name && ns.first != ns_name) continue;
+    for (const auto& kv : ns.second) {
+      if (type != NVS_TYPE_ANY && kv.second.type != type) continue;
+      nvs_entry_info_t info{};
+      strncpy(info.namespace_name, ns.first.c_str(), sizeof(info.namespace_name) - 1);
+      strncpy(info.key, kv.first.c_str(), sizeof(info.key) - 1);
+      info.type = kv.second.type;
+      it->entries.push_back(info);
+    }
+  }
+
+  if (it->entries.empty()) {
+    delete it;
+    return ESP_ERR_NVS_NOT_FOUND;
+  }
+
+  *output_iterator = it;
+  return ESP_OK;
+}
+
+} // namespace NVSHost
+
+/* ------------------------------------------ nvs_flash ----------------------------------------- */
+
+inline esp_err_t nvs_flash_init() { return NVSHost::initPartition(nullptr); }
+inline esp_err_t nvs_flash_init_partition(const char* part_name) {
+  return NVSHost::initPartition(part_name);
+}
+inline esp_err_t nvs_flash_deinit() { return NVSHost::deinitPartition(nullptr); }
+inline esp_err_t nvs_flash_deinit_partition(const char* part_name) {
+  return NVSHost::deinitPartition(part_name);
+}
+inline esp_err_t nvs_flash_erase() { return NVSHost::erasePartition(nullptr); }
+inline esp_err_t nvs_flash_erase_partition(const char* part_name) {
+  return NVSHost::erasePartition(part_name);
+}
+
+/* --------------------------------------------- nvs -------------------------------------------- */
+
+inline esp_err_t nvs_open_from_partition(const char* part_name, const char* namespace_name,
+                                         nvs_open_mode_t open_mode, nvs_handle_t* out_handle) {
+  using namespace NVSHost;
+  std::lock_guard<std::recursive_mutex> lock(state().mutex);
+
+  if (!out_handle) return ESP_ERR_INVALID_ARG;
+
+  auto p = state().partitions.find(partName(part_name));
+  if (p == state().partitions.end() || !p->second.initialized) return ESP_ERR_NVS_NOT_INITIALIZED;
+  if (!validName(namespace_name)) return ESP_ERR_NVS_INVALID_NAME;
+
+  // Creating a namespace takes one entry; read-only handles cannot create it
+  auto ns = p->second.namespaces.find(namespace_name);
+  if (ns == p->second.namespaces.end()) {
+    if (open_mode == NVS_READONLY) return ESP_ERR_NVS_NOT_FOUND;
+    p->second.namespaces[namespace_name];
+  }
+
+  nvs_handle_t handle     = state().next_handle++;
+  state().handles[handle] = Handle{p->first, namespace_name, open_mode};
+  state().counters.opens++;
+  *out_handle = handle;
+  return ESP_OK;
+}
+
+inline esp_err_t nvs_open(const char* namespace_name, nvs_open_mode_t open_mode,
+                          nvs_handle_t* out_handle) {
+  return nvs_open_from_partition(nullptr, namespace_name, open_mode, out_handle);
+}
+
+inline void nvs_close(nvs_handle_t handle) {
+  std::lock_guard<std::recursive_mutex> lock(NVSHost::state().mutex);
+  NVSHost::state().handles.erase(handle);
+}
+
+inline esp_err_t nvs_commit(nvs_handle_t handle) {
+  std::lock_guard<std::recursive_mutex> lock(NVSHost::state().mutex);
+  if (!NVSHost::findHandle(handle)) return ESP_ERR_NVS_INVALID_HANDLE;
+  NVSHost::state().counters.commits++;
+  return ESP_OK;
+}
+
+inline esp_err_t nvs_set_u8(nvs_handle_t handle, const char* key, uint8_t value) {
+  return NVSHost::setItem(handle, key, NVS_TYPE_U8, &value, sizeof(value));
+}
+inline esp_err_t nvs_set_i32(nvs_handle_t handle, const char* key, int32_t value) {
+  return NVSHost::setItem(handle, key, NVS_TYPE_I32, &value, sizeof(value));
+}
+inline esp_err_t nvs_set_u32(nvs_handle_t handle, const char* key, uint32_t value) {
+  return NVSHost::setItem(handle, key, NVS_TYPE_U32, &value, sizeof(value));
+}
+inline esp_err_t nvs_set_u64(nvs_handle_t handle, const char* key, uint64_t value) {
+  return NVSHost::setItem(handle, key, NVS_TYPE_U64, &value, sizeof(value));
+}
+inline esp_err_t nvs_set_str(nvs_handle_t handle, const char* key, const char* value) {
+  if (!value) return ESP_ERR_INVALID_ARG;
+  return NVSHost::setItem(handle, key, NVS_TYPE_STR, value, strlen(value) + 1);
+}
+inline esp_err_t nvs_set_blob(nvs_handle_t handle, const char* key, const void* value,
+                              size_t length) {
+  if (!value && length > 0) return ESP_ERR_INVALID_ARG;
+  return NVSHost::setItem(handle, key, NVS_TYPE_BLOB, value, length);
+}
+
+inline esp_err_t nvs_get_u8(nvs_handle_t handle, const char* key, uint8_t* out_value) {
+  return NVSHost::getScalar(handle, key, NVS_TYPE_U8, out_value);
+}
+inline esp_err_t nvs_get_i32(nvs_handle_t handle, const char* key, int32_t* out_value) {
+  return NVSHost::getScalar(handle, key, NVS_TYPE_I32, out_value);
+}
+inline esp_err_t nvs_get_u32(nvs_handle_t handle, const char* key, uint32_t* out_value) {
+  return NVSHost::getScalar(handle, key, NVS_TYPE_U32, out_value);
+}
+inline esp_err_t nvs_get_u64(nvs_handle_t handle, const char* key, uint64_t* out_value) {
+  return NVSHost::getScalar(handle, key, NVS_TYPE_U64, out_value);
+}
+inline esp_err_t nvs_get_str(nvs_handle_t handle, const char* key, char* out_value,
+                             size_t* length) {
+  return NVSHost::getVariable(handle, key, NVS_TYPE_STR, out_value, length);
+}
+inline esp_err_t nvs_get_blob(nvs_handle_t handle, const char* key, void* out_value,
+                              size_t* length) {
+  return NVSHost::getVariable(handle, key, NVS_TYPE_BLOB, out_value, length);
+}
+
+inline esp_err_t nvs_find_key(nvs_handle_t handle, const char* key, nvs_type_t* out_type) {
+  using namespace NVSHost;
+  std::lock_guard<std::recursive_mutex> lock(state().mutex);
+
+  Handle* h = findHandle(handle);
+  if (!h) return ESP_ERR_NVS_INVALID_HANDLE;
+  Namespace* ns = findNamespace(*h);
+  if (!ns || !key) return ESP_ERR_NVS_INVALID_HANDLE;
+
+  auto it = ns->find(key);
+  if (it == ns->end()) return ESP_ERR_NVS_NOT_FOUND;
+  if (out_type) *out_type = it->second.type;
+  return ESP_OK;
+}
+
+inline esp_err_t nvs_erase_key(nvs_handle_t handle, const char* key) {
+  using namespace NVSHost;
+  std::lock_guard<std::recursive_mutex> lock(state().mutex);
+
+  Handle* h = findHandle(handle);
+  if (!h) return ESP_ERR_NVS_INVALID_HANDLE;
+  if (h->mode == NVS_READONLY) return ESP_ERR_NVS_READ_ONLY;
+  Namespace* ns = findNamespace(*h);
+  if (!ns || !key) return ESP_ERR_NVS_INVALID_HANDLE;
+
+  state().counters.erases++;
+  return ns->erase(key) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+inline esp_err_t nvs_erase_all(nvs_handle_t handle) {
+  using namespace NVSHost;
+  std::lock_guard<std::recursive_mutex> lock(state().mutex);
+
+  Handle* h = findHandle(handle);
+  if (!h) return ESP_ERR_NVS_INVALID_HANDLE;
+  if (h->mode == NVS_READONLY) return ESP_ERR_NVS_READ_ONLY;
+  Namespace* ns = findNamespace(*h);
+  if (!ns) return ESP_ERR_NVS_INVALID_HANDLE;
+
+  state().counters.erases++;
+  ns->clear();
+  return ESP_OK;
+}
+
+inline esp_err_t nvs_get_stats(const char* part_name, nvs_stats_t* nvs_stats) {
+  using namespace NVSHost;
+  std::lock_guard<std::recursive_mutex> lock(state().mutex);
+
+  if (!nvs_stats) return ESP_ERR_INVALID_ARG;
+  auto p = state().partitions.find(partName(part_name));
+  if (p == state().partitions.end() || !p->second.initialized) return ESP_ERR_NVS_NOT_INITIALIZED;
+
+  size_t total                  = totalEntries(p->second);
+  size_t used                   = usedEntries(p->second);
+  nvs_stats->used_entries       = used;
+  nvs_stats->free_entries       = total - used;
+  nvs_stats->available_entries  = (total - used > ENTRIES_PER_PAGE) ? total - used - ENTRIES_PER_PAGE
+                                                                    : 0;
+  nvs_stats->total_entries      = total;
+  nvs_stats->namespace_count    = p->second.namespaces.size();
+  return ESP_OK;
+}
+
+inline esp_err_t nvs_get_used_entry_count(nvs_handle_t handle, size_t* used_entries) {
+  using namespace NVSHost;
+  std::lock_guard<std::recursive_mutex> lock(state().mutex);
+
+  if (!used_entries) return ESP_ERR_INVALID_ARG;
+  Handle* h = findHandle(handle);
+  if (!h) return ESP_ERR_NVS_INVALID_HANDLE;
+  Namespace* ns = findNamespace(*h);
+  if (!ns) return ESP_ERR_NVS_INVALID_HANDLE;
+
+  *used_entries = 0;
+  for (const auto& kv : *ns)
+    *used_entries += itemEntries(kv.second);
+  return ESP_OK;
+}
+
+inline esp_err_t nvs_entry_find(const char* part_name, const char* namespace_name,
+                                nvs_type_t type, nvs_iterator_t* output_iterator) {
+  std::lock_guard<std::recursive_mutex> lock(NVSHost::state().mutex);
+  return NVSHost::findEntries(NVSHost::partName(part_name), namespace_name, type, output_iterator);
+}
+
+inline esp_err_t nvs_entry_find_in_handle(nvs_handle_t handle, nvs_type_t type,
+                                          nvs_iterator_t* output_iterator) {
+  using namespace NVSHost;
+  std::lock_guard<std::recursive_mutex> lock(state().mutex);
+
+  Handle* h = findHandle(handle);
+  if (!h) return ESP_ERR_NVS_INVALID_HANDLE;
+  return findEntries(h->partition, h->ns.c_str(), type, output_iterator);
+}
+
+inline esp_err_t nvs_entry_next(nvs_iterator_t* iterator) {
+  if (!iterator || !*iterator) return ESP_ERR_INVALID_ARG;
+  if (++(*iterator)->pos >= (*iterator)->entries.size()) {
+    delete *iterator;
+    *iterator = nullptr;
+    return ESP_ERR_NVS_NOT_FOUND;
+  }
+  return ESP_OK;
+}
+
+inline esp_err_t nvs_entry_info(const nvs_iterator_t iterator, nvs_entry_info_t* out_info) {
+  if (!iterator || !out_info) return ESP_ERR_INVALID_ARG;
+  *out_info = iterator->entries[iterator->pos];
+  return ESP_OK;
+}
+
+inline void nvs_release_iterator(nvs_iterator_t iterator) { delete iterator; }
+
+/* ------------------------------------- Host-only helpers -------------------------------------- */
+
+/**
+ * @brief Drop every partition, namespace, key and open handle, and zero the counters.
+ */
+inline void nvs_host_reset() {
+  using namespace NVSHost;
+  std::lock_guard<std::recursive_mutex> lock(state().mutex);
+  state().partitions.clear();
+  state().handles.clear();
+  state().counters = nvs_host_counters_t{};
+}
+
+/**
+ * @brief Get the operation counters accumulated since the last `nvs_host_reset()`.
+ */
+inline nvs_host_counters_t nvs_host_get_counters() {
+  std::lock_guard<std::recursive_mutex> lock(NVSHost::state().mutex);
+  return NVSHost::state().counters;
+}
+
+/**
+ * @brief Set the size of a partition in 4 KB pages (default 5, as the default "nvs" partition).
+ * @param part_name Partition name, or `nullptr` for the default partition.
+ * @param page_count Number of pages. One page is always kept free for garbage collection.
+ */
+inline void nvs_host_set_partition_pages(const char* part_name, size_t page_count) {
+  std::lock_guard<std::recursive_mutex> lock(NVSHost::state().mutex);
+  NVSHost::state().partitions[NVSHost::partName(part_name)].page_count = page_count;
+}
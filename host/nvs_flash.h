@@ -0,0 +1,11 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/// Host stand-in for ESP-IDF `nvs_flash.h`. The implementation lives in `nvs.h`.
+
+#pragma once
+
+#include "nvs.h"
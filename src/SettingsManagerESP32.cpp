@@ -6,15 +6,69 @@
 
 #include "SettingsManagerESP32.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <esp_timer.h>
+#include <inttypes.h>
+#include <math.h>
+#include <mutex>
 #include <nvs_flash.h>
+#include <stdio.h>
 #include <string.h>
+#include <vector>
+
+#ifdef ESP_PLATFORM
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <thread>
+#endif
+
+#if !defined(ESP_PLATFORM) && defined(__SSE2__)
+#include <emmintrin.h>
+#elif !defined(ESP_PLATFORM) && defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 namespace NVS {
 
-static bool _initialized = false;
+// Partitions: the initialization state of each partition init() was called for, by label. Slots
+// are taken on first use and kept, so a partition keeps its slot across deinit() and erase().
+namespace {
+
+struct Partition {
+  char label[NVS_PART_NAME_MAX_SIZE + 1] = {};
+  bool initialized                       = false;
+};
+
+std::mutex _partitions_mutex;
+std::array<Partition, SETTINGS_MAX_PARTITIONS> _partitions;
+
+// The slot of a partition (the default one for `nullptr`), taking a free one if `take`
+Partition* findPartition(const char* partition_name, bool take) {
+  const char* label = partition_name ? partition_name : NVS_DEFAULT_PART_NAME;
+  Partition* free   = nullptr;
+
+  for (Partition& partition : _partitions) {
+    if (strcmp(partition.label, label) == 0) return &partition;
+    if (!free && partition.label[0] == '\0') free = &partition;
+  }
+
+  if (!take || !free || strlen(label) > NVS_PART_NAME_MAX_SIZE) return nullptr;
+  strcpy(free->label, label);
+  return free;
+}
+
+} // namespace
 
 bool init(const char* partition_name) {
-  if (_initialized) return true;
+  std::lock_guard<std::mutex> lock(_partitions_mutex);
+  Partition* partition = findPartition(partition_name, true);
+  if (!partition) return false;
+  if (partition->initialized) return true;
 
   bool success = false;
 
@@ -26,12 +80,14 @@ bool init(const char* partition_name) {
 
   if (!success) return false;
 
-  _initialized = true;
+  partition->initialized = true;
   return true;
 }
 
 bool deinit(const char* partition_name) {
-  if (!_initialized) return true;
+  std::lock_guard<std::mutex> lock(_partitions_mutex);
+  Partition* partition = findPartition(partition_name, false);
+  if (!partition || !partition->initialized) return true;
 
   bool success = false;
 
@@ -43,12 +99,14 @@ bool deinit(const char* partition_name) {
 
   if (!success) return false;
 
-  _initialized = false;
+  partition->initialized = false;
   return true;
 }
 
 bool erase(const char* partition_name) {
-  if (!_initialized) return false;
+  std::lock_guard<std::mutex> lock(_partitions_mutex);
+  Partition* partition = findPartition(partition_name, false);
+  if (!partition || !partition->initialized) return false;
 
   bool success;
 
@@ -59,10 +117,16 @@ bool erase(const char* partition_name) {
   }
 
   // nvs_flash_erase() implicitly deinitializes the partition
-  if (success) _initialized = false;
+  if (success) partition->initialized = false;
   return success;
 }
 
+bool isInitialized(const char* partition_name) {
+  std::lock_guard<std::mutex> lock(_partitions_mutex);
+  Partition* partition = findPartition(partition_name, false);
+  return partition && partition->initialized;
+}
+
 bool getStats(nvs_stats_t& stats, const char* partition_name) {
   if (partition_name) {
     return (nvs_get_stats(partition_name, &stats) == ESP_OK);
@@ -84,20 +148,188 @@ const char* typeToStr(const NVS::Type t) {
   }
 }
 
+// Hex codec: table lookups, 16 bytes per step with SSE2 or NEON on the host and 4 bytes per step
+// elsewhere. Input characters are validated once per string, not one by one.
+namespace {
+
+constexpr uint8_t HEX_INVALID = 0x80; // Flag of the characters that are not hex digits
+
+struct HexTables {
+  char pairs[256][2];  // Byte -> its two digits
+  uint8_t values[256]; // Character -> nibble, or HEX_INVALID
+};
+
+constexpr HexTables makeHexTables() {
+  constexpr char DIGITS[] = "0123456789ABCDEF";
+  HexTables t{};
+
+  for (size_t i = 0; i < 256; i++) {
+    t.pairs[i][0] = DIGITS[i >> 4];
+    t.pairs[i][1] = DIGITS[i & 0x0F];
+    t.values[i]   = HEX_INVALID;
+  }
+  for (uint8_t i = 0; i < 10; i++)
+    t.values['0' + i] = i;
+  for (uint8_t i = 0; i < 6; i++) {
+    t.values['A' + i] = 10 + i;
+    t.values['a' + i] = 10 + i;
+  }
+  return t;
+}
+
+constexpr HexTables HEX_TABLES = makeHexTables();
+
+#if !defined(ESP_PLATFORM) && defined(__SSE2__)
+// Nibbles to digits: n + '0', plus 7 more for 10-15 ('A' - '9' - 1)
+inline __m128i hexDigits(__m128i n) {
+  __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(n, _mm_set1_epi8(9)), _mm_set1_epi8(7));
+  return _mm_add_epi8(_mm_add_epi8(n, _mm_set1_epi8('0')), letters);
+}
+
+// Digits to nibbles. `valid` loses the lanes that are not hex digits.
+inline __m128i hexNibbles(__m128i c, __m128i& valid) {
+  __m128i digit  = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+  __m128i letter = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+  __m128i is_dig = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+  __m128i is_let = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+
+  valid = _mm_and_si128(valid, _mm_or_si128(is_dig, is_let));
+  return _mm_or_si128(_mm_and_si128(is_dig, digit),
+                      _mm_and_si128(is_let, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+}
+
+// Pairs of nibbles (high one first) to bytes, in the low half of each 16-bit lane
+inline __m128i hexBytes(__m128i n) {
+  __m128i high = _mm_slli_epi16(_mm_and_si128(n, _mm_set1_epi16(0x00FF)), 4);
+  return _mm_or_si128(high, _mm_srli_epi16(n, 8));
+}
+
+size_t encodeHexBlocks(const uint8_t* src, size_t size, char* dst) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16, dst += 32) {
+    __m128i v    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i high = hexDigits(_mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F)));
+    __m128i low  = hexDigits(_mm_and_si128(v, _mm_set1_epi8(0x0F)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi8(high, low));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi8(high, low));
+  }
+  return i;
+}
+
+size_t decodeHexBlocks(const char* src, size_t size, uint8_t* dst, bool& valid) {
+  __m128i ok = _mm_set1_epi8(-1);
+  size_t i   = 0;
+
+  for (; i + 16 <= size; i += 16, src += 32) {
+    __m128i first  = hexNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)), ok);
+    __m128i second = hexNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16)), ok);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_packus_epi16(hexBytes(first), hexBytes(second)));
+  }
+
+  valid = (_mm_movemask_epi8(ok) == 0xFFFF);
+  return i;
+}
+#elif !defined(ESP_PLATFORM) && defined(__ARM_NEON) && defined(__aarch64__)
+inline uint8x16_t hexDigits(uint8x16_t n) {
+  uint8x16_t letters = vandq_u8(vcgtq_u8(n, vdupq_n_u8(9)), vdupq_n_u8(7));
+  return vaddq_u8(vaddq_u8(n, vdupq_n_u8('0')), letters);
+}
+
+inline uint8x16_t hexNibbles(uint8x16_t c, uint8x16_t& valid) {
+  uint8x16_t digit  = vsubq_u8(c, vdupq_n_u8('0'));
+  uint8x16_t letter = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+  uint8x16_t is_dig = vcleq_u8(digit, vdupq_n_u8(9));
+  uint8x16_t is_let = vcleq_u8(letter, vdupq_n_u8(5));
+
+  valid = vandq_u8(valid, vorrq_u8(is_dig, is_let));
+  return vorrq_u8(vandq_u8(is_dig, digit), vandq_u8(is_let, vaddq_u8(letter, vdupq_n_u8(10))));
+}
+
+size_t encodeHexBlocks(const uint8_t* src, size_t size, char* dst) {
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16, dst += 32) {
+    uint8x16_t v = vld1q_u8(src + i);
+    uint8x16x2_t digits;
+    digits.val[0] = hexDigits(vshrq_n_u8(v, 4));
+    digits.val[1] = hexDigits(vandq_u8(v, vdupq_n_u8(0x0F)));
+    vst2q_u8(reinterpret_cast<uint8_t*>(dst), digits);
+  }
+  return i;
+}
+
+size_t decodeHexBlocks(const char* src, size_t size, uint8_t* dst, bool& valid) {
+  uint8x16_t ok = vdupq_n_u8(0xFF);
+  size_t i      = 0;
+
+  for (; i + 16 <= size; i += 16, src += 32) {
+    uint8x16x2_t digits = vld2q_u8(reinterpret_cast<const uint8_t*>(src));
+    uint8x16_t high     = hexNibbles(digits.val[0], ok);
+    uint8x16_t low      = hexNibbles(digits.val[1], ok);
+    vst1q_u8(dst + i, vorrq_u8(vshlq_n_u8(high, 4), low));
+  }
+
+  valid = (vminvq_u8(ok) == 0xFF);
+  return i;
+}
+#else
+// No vector unit: the 4-byte loops below do all the work
+size_t encodeHexBlocks(const uint8_t*, size_t, char*) { return 0; }
+
+size_t decodeHexBlocks(const char*, size_t, uint8_t*, bool& valid) {
+  valid = true;
+  return 0;
+}
+#endif
+
+inline void encodeHexByte(uint8_t byte, char* dst) { memcpy(dst, HEX_TABLES.pairs[byte], 2); }
+
+// Decode the two digits at `src`, flagging invalid ones in `bad`
+inline uint8_t decodeHexByte(const char* src, uint8_t& bad) {
+  uint8_t high = HEX_TABLES.values[static_cast<uint8_t>(src[0])];
+  uint8_t low  = HEX_TABLES.values[static_cast<uint8_t>(src[1])];
+  bad |= high | low;
+  return static_cast<uint8_t>((high << 4) | (low & 0x0F));
+}
+
+} // namespace
+
 bool fromHexToStr(const NVS::ByteStreamView bs, char* buf, const size_t buf_size,
                   const bool with_spaces) {
   if (!bs.data || buf_size < hexStrSize(bs.size, with_spaces)) return false;
 
-  static const char HEX_CHARS[] = "0123456789ABCDEF";
+  const uint8_t* src = bs.data;
+  size_t size        = bs.size;
+
+  if (with_spaces) {
+    // Every byte is followed by a space; the terminator then replaces the last one
+    if (size == 0) {
+      buf[0] = '\0';
+      return true;
+    }
+
+    char* dst = buf;
+    for (size_t i = 0; i < size; i++, dst += 3) {
+      encodeHexByte(src[i], dst);
+      dst[2] = ' ';
+    }
+    dst[-1] = '\0';
+    return true;
+  }
+
+  size_t i  = encodeHexBlocks(src, size, buf);
+  char* dst = buf + i * 2;
 
-  for (size_t i = 0; i < bs.size; i++) {
-    size_t pos   = with_spaces ? i * 3 : i * 2;
-    buf[pos]     = HEX_CHARS[bs.data[i] >> 4];
-    buf[pos + 1] = HEX_CHARS[bs.data[i] & 0x0F];
-    if (with_spaces && i < bs.size - 1) buf[pos + 2] = ' ';
+  for (; i + 4 <= size; i += 4, dst += 8) {
+    encodeHexByte(src[i], dst);
+    encodeHexByte(src[i + 1], dst + 2);
+    encodeHexByte(src[i + 2], dst + 4);
+    encodeHexByte(src[i + 3], dst + 6);
   }
+  for (; i < size; i++, dst += 2)
+    encodeHexByte(src[i], dst);
 
-  buf[with_spaces ? bs.size * 3 - 1 : bs.size * 2] = '\0';
+  *dst = '\0';
   return true;
 }
 
@@ -121,40 +353,458 @@ bool fromStrToHex(const char* hex, NVS::ByteStream& out, const bool with_spaces)
 
   if (byte_count > out.max_size) return false;
 
-  for (size_t i = 0; i < byte_count; i++) {
-    size_t pos = with_spaces ? i * 3 : i * 2;
-    uint8_t high, low;
-    char c = hex[pos];
+  uint8_t* dst = out.data;
+  uint8_t bad  = 0;
+
+  if (with_spaces) {
+    uint8_t separators = 0;
+    for (size_t i = 0; i < byte_count - 1; i++, hex += 3) {
+      dst[i] = decodeHexByte(hex, bad);
+      separators |= static_cast<uint8_t>(hex[2] ^ ' ');
+    }
+    dst[byte_count - 1] = decodeHexByte(hex, bad);
+    if (separators != 0) return false;
+  } else {
+    bool valid = true;
+    size_t i   = decodeHexBlocks(hex, byte_count, dst, valid);
+    if (!valid) return false;
+    hex += i * 2;
+
+    for (; i + 4 <= byte_count; i += 4, hex += 8) {
+      dst[i]     = decodeHexByte(hex, bad);
+      dst[i + 1] = decodeHexByte(hex + 2, bad);
+      dst[i + 2] = decodeHexByte(hex + 4, bad);
+      dst[i + 3] = decodeHexByte(hex + 6, bad);
+    }
+    for (; i < byte_count; i++, hex += 2)
+      dst[i] = decodeHexByte(hex, bad);
+  }
+
+  if (bad & HEX_INVALID) return false;
+
+  out.size = byte_count;
+  return true;
+}
+
+// Base64 codec (RFC 4648): 3 bytes to 4 characters per step through lookup tables, with the same
+// once-per-string validation as the hex codec.
+namespace {
+
+constexpr char BASE64_DIGITS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+constexpr uint8_t BASE64_INVALID = 0x80; // Flag of the characters outside the alphabet
+
+struct Base64Table {
+  uint8_t values[256]; // Character -> 6-bit value, or BASE64_INVALID
+};
+
+constexpr Base64Table makeBase64Table() {
+  Base64Table t{};
+  for (size_t i = 0; i < 256; i++)
+    t.values[i] = BASE64_INVALID;
+  for (uint8_t i = 0; i < 64; i++)
+    t.values[static_cast<uint8_t>(BASE64_DIGITS[i])] = i;
+  return t;
+}
+
+constexpr Base64Table BASE64_TABLE = makeBase64Table();
+
+inline void encodeBase64Block(const uint8_t* src, char* dst) {
+  uint32_t v = (uint32_t(src[0]) << 16) | (uint32_t(src[1]) << 8) | src[2];
+  dst[0]     = BASE64_DIGITS[v >> 18];
+  dst[1]     = BASE64_DIGITS[(v >> 12) & 0x3F];
+  dst[2]     = BASE64_DIGITS[(v >> 6) & 0x3F];
+  dst[3]     = BASE64_DIGITS[v & 0x3F];
+}
+
+// Last 1 or 2 bytes of a blob, padded to a whole block
+inline void encodeBase64Tail(const uint8_t* src, size_t size, char* dst) {
+  uint32_t v = (uint32_t(src[0]) << 16) | (size > 1 ? uint32_t(src[1]) << 8 : 0);
+  dst[0]     = BASE64_DIGITS[v >> 18];
+  dst[1]     = BASE64_DIGITS[(v >> 12) & 0x3F];
+  dst[2]     = size > 1 ? BASE64_DIGITS[(v >> 6) & 0x3F] : '=';
+  dst[3]     = '=';
+}
+
+// Encode the whole blocks of a blob. Returns the number of bytes consumed.
+size_t encodeBase64Blocks(const uint8_t* src, size_t size, char* dst) {
+  size_t i = 0;
+  for (; i + 3 <= size; i += 3, dst += 4)
+    encodeBase64Block(src + i, dst);
+  return i;
+}
+
+// Decode `count` characters (2 to 4) into `count - 1` bytes, flagging invalid ones in `bad`
+inline void decodeBase64Block(const char* src, size_t count, uint8_t* dst, uint8_t& bad) {
+  uint32_t v = 0;
+  for (size_t k = 0; k < 4; k++) {
+    uint8_t value = (k < count) ? BASE64_TABLE.values[static_cast<uint8_t>(src[k])] : 0;
+    bad |= value;
+    v = (v << 6) | (value & 0x3F);
+  }
+
+  dst[0] = static_cast<uint8_t>(v >> 16);
+  if (count > 2) dst[1] = static_cast<uint8_t>(v >> 8);
+  if (count > 3) dst[2] = static_cast<uint8_t>(v);
+}
+
+} // namespace
+
+bool fromBase64ToStr(const NVS::ByteStreamView bs, char* buf, const size_t buf_size) {
+  if (!bs.data || buf_size < base64StrSize(bs.size)) return false;
+
+  size_t i  = encodeBase64Blocks(bs.data, bs.size, buf);
+  char* dst = buf + i / 3 * 4;
+
+  if (i < bs.size) {
+    encodeBase64Tail(bs.data + i, bs.size - i, dst);
+    dst += 4;
+  }
+
+  *dst = '\0';
+  return true;
+}
+
+bool fromStrToBase64(const char* b64, NVS::ByteStream& out) {
+  if (!b64 || !out.data) return false;
 
-    if (c >= '0' && c <= '9')
-      high = c - '0';
-    else if (c >= 'A' && c <= 'F')
-      high = c - 'A' + 10;
-    else if (c >= 'a' && c <= 'f')
-      high = c - 'a' + 10;
-    else
-      return false;
+  size_t len = strlen(b64);
 
-    c = hex[pos + 1];
+  // Padding, if any, completes the last block
+  size_t padding = 0;
+  while (padding < 2 && padding < len && b64[len - 1 - padding] == '=')
+    padding++;
+  if (padding > 0 && len % 4 != 0) return false;
 
-    if (c >= '0' && c <= '9')
-      low = c - '0';
-    else if (c >= 'A' && c <= 'F')
-      low = c - 'A' + 10;
-    else if (c >= 'a' && c <= 'f')
-      low = c - 'a' + 10;
-    else
-      return false;
+  size_t chars = len - padding;
+  size_t tail  = chars % 4;
+  if (tail == 1) return false;
 
-    if (with_spaces && i < byte_count - 1 && hex[pos + 2] != ' ') return false;
+  size_t byte_count = chars / 4 * 3 + (tail ? tail - 1 : 0);
+  if (byte_count > out.max_size) return false;
+
+  uint8_t* dst = out.data;
+  uint8_t bad  = 0;
+  size_t i     = 0;
 
-    out.data[i] = (high << 4) | low;
+  for (; i + 4 <= chars; i += 4, dst += 3) {
+    uint8_t a = BASE64_TABLE.values[static_cast<uint8_t>(b64[i])];
+    uint8_t b = BASE64_TABLE.values[static_cast<uint8_t>(b64[i + 1])];
+    uint8_t c = BASE64_TABLE.values[static_cast<uint8_t>(b64[i + 2])];
+    uint8_t d = BASE64_TABLE.values[static_cast<uint8_t>(b64[i + 3])];
+    bad |= a | b | c | d;
+
+    uint32_t v = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | d;
+    dst[0]     = static_cast<uint8_t>(v >> 16);
+    dst[1]     = static_cast<uint8_t>(v >> 8);
+    dst[2]     = static_cast<uint8_t>(v);
   }
+  if (tail) decodeBase64Block(b64 + i, tail, dst, bad);
+
+  if (bad & BASE64_INVALID) return false;
 
   out.size = byte_count;
   return true;
 }
 
+bool Base64Encoder::update(const NVS::ByteStreamView chunk, char* out, const size_t out_size,
+                           size_t& written) {
+  written = 0;
+  if (!chunk.data || !out) return false;
+
+  size_t total = _pending_count + chunk.size;
+  if (out_size < total / 3 * 4) return false;
+  if (chunk.size == 0) return true;
+
+  const uint8_t* src = chunk.data;
+  size_t size        = chunk.size;
+
+  // Complete the block started by the previous chunk
+  if (_pending_count > 0) {
+    if (total < 3) {
+      _pending[_pending_count++] = src[0];
+      return true;
+    }
+
+    uint8_t block[3] = {_pending[0], _pending[1], 0};
+    size_t taken     = 3 - _pending_count;
+    memcpy(block + _pending_count, src, taken);
+    encodeBase64Block(block, out);
+
+    written        = 4;
+    src           += taken;
+    size          -= taken;
+    _pending_count = 0;
+  }
+
+  size_t i = encodeBase64Blocks(src, size, out + written);
+  written += i / 3 * 4;
+
+  _pending_count = static_cast<uint8_t>(size - i);
+  memcpy(_pending, src + i, _pending_count);
+  return true;
+}
+
+bool Base64Encoder::finish(char* out, const size_t out_size, size_t& written) {
+  written = 0;
+  if (!out || out_size < (_pending_count ? 5u : 1u)) return false;
+
+  if (_pending_count > 0) {
+    encodeBase64Tail(_pending, _pending_count, out);
+    written = 4;
+  }
+
+  out[written]   = '\0';
+  _pending_count = 0;
+  return true;
+}
+
+// Streaming codecs: the one-shot codecs applied to pieces of SETTINGS_CODEC_CHUNK_SIZE characters.
+// Decoders keep the characters of an incomplete unit (a byte, or a Base64 block) for the next read.
+namespace {
+
+constexpr size_t CODEC_CHUNK = SETTINGS_CODEC_CHUNK_SIZE;
+static_assert(CODEC_CHUNK >= 12 && CODEC_CHUNK % 12 == 0,
+              "SETTINGS_CODEC_CHUNK_SIZE must be a multiple of 12");
+
+// Read a source through a chunk buffer, handing `decode(run, length, last)` every run of whole
+// `unit`-character units, null-terminated, and then what is left at the end of the input (`last`).
+// Line breaks are skipped, so wrapped input (e.g. PEM-style Base64) decodes whole. With a
+// `separator`, a line break between two units stands for it; without one, blanks are skipped too.
+template <typename Decode>
+bool readUnits(NVS::Source& source, const size_t unit, const char separator, Decode decode) {
+  char chunk[CODEC_CHUNK + 1];
+  size_t count = 0;
+  char last    = separator; // Last character kept: no separator before the first unit
+  bool broken  = false;     // Line break since the last character kept
+
+  // Read one character past the kept ones, so that a separator standing for a break dropped by a
+  // previous read still fits before the next character
+  while (size_t n = source.read(chunk + count + 1, CODEC_CHUNK - count - 1)) {
+    const size_t end = count + 1 + n; // count moves as characters are kept
+    for (size_t i = count + 1; i < end; i++) {
+      char c = chunk[i];
+      if (c == '\r' || c == '\n') {
+        broken = true;
+        continue;
+      }
+      if (!separator && (c == ' ' || c == '\t')) continue;
+
+      if (broken && separator && last != separator) chunk[count++] = separator;
+      broken         = false;
+      chunk[count++] = c;
+      last           = c;
+    }
+
+    size_t whole = count / unit * unit;
+    if (whole == 0) continue;
+
+    char kept[4];
+    size_t rest = count - whole;
+    memcpy(kept, chunk + whole, rest);
+
+    chunk[whole] = '\0';
+    if (!decode(chunk, whole, false)) return false;
+
+    memcpy(chunk, kept, rest);
+    count = rest;
+  }
+
+  chunk[count] = '\0';
+  return decode(chunk, count, true);
+}
+
+// Decode a run into the free part of `out`, appending to what was decoded before
+template <typename Decode>
+bool appendTo(NVS::ByteStream& out, Decode decode) {
+  NVS::ByteStream part(out.data + out.size, out.max_size - out.size);
+  if (!decode(part)) return false;
+  out.size += part.size;
+  return true;
+}
+
+} // namespace
+
+bool writeHex(Sink& sink, const NVS::ByteStreamView bs, const bool with_spaces) {
+  if (!bs.data) return false;
+
+  char chunk[CODEC_CHUNK + 1];
+  const size_t step = with_spaces ? CODEC_CHUNK / 3 : CODEC_CHUNK / 2;
+
+  for (size_t i = 0; i < bs.size; i += step) {
+    size_t n = std::min(step, bs.size - i);
+    fromHexToStr(NVS::ByteStreamView(bs.data + i, n), chunk, sizeof(chunk), with_spaces);
+
+    // Spaced pieces lack the separator before the next piece
+    size_t length = with_spaces ? n * 3 - 1 : n * 2;
+    if (with_spaces && i + n < bs.size) chunk[length++] = ' ';
+
+    if (!sink.write(chunk, length)) return false;
+  }
+  return true;
+}
+
+bool writeBase64(Sink& sink, const NVS::ByteStreamView bs) {
+  if (!bs.data) return false;
+
+  // Whole blocks per piece, so only the last one is padded
+  char chunk[CODEC_CHUNK + 1];
+  const size_t step = CODEC_CHUNK / 4 * 3;
+
+  for (size_t i = 0; i < bs.size; i += step) {
+    size_t n = std::min(step, bs.size - i);
+    fromBase64ToStr(NVS::ByteStreamView(bs.data + i, n), chunk, sizeof(chunk));
+    if (!sink.write(chunk, (n + 2) / 3 * 4)) return false;
+  }
+  return true;
+}
+
+bool readHex(Source& source, NVS::ByteStream& out, const bool with_spaces) {
+  if (!out.data) return false;
+  out.size = 0;
+
+  // Spaced units are "XX ": the last byte comes without its separator, in the final run
+  size_t unit    = with_spaces ? 3 : 2;
+  char separator = with_spaces ? ' ' : '\0';
+  return readUnits(source, unit, separator, [&](char* run, size_t length, bool last) {
+    if (with_spaces && length > 0 && !last) {
+      if (run[length - 1] != ' ') return false;
+      run[length - 1] = '\0';
+    }
+    if (with_spaces && last && length == 0 && out.size > 0) return false; // Trailing separator
+    return appendTo(out,
+                    [&](NVS::ByteStream& part) { return fromStrToHex(run, part, with_spaces); });
+  });
+}
+
+bool readBase64(Source& source, NVS::ByteStream& out) {
+  if (!out.data) return false;
+  out.size = 0;
+
+  // Padding ends the input: nothing may follow a padded block
+  bool padded = false;
+  return readUnits(source, 4, '\0', [&](char* run, size_t length, bool) {
+    if (length == 0) return true;
+    if (padded) return false;
+    padded = run[length - 1] == '=';
+    return appendTo(out, [&](NVS::ByteStream& part) { return fromStrToBase64(run, part); });
+  });
+}
+
+namespace {
+
+// Append a formatted line to a metrics dump. A line that does not fit is dropped, and so are the
+// following ones.
+class LineWriter {
+  public:
+  LineWriter(char* buf, size_t size)
+      : _buf(buf)
+      , _size(size) {}
+
+  template <typename... Args>
+  void line(const char* format, Args... args) {
+    if (_full) return;
+
+    int len = snprintf(_buf + _len, _size - _len, format, args...);
+    if (len < 0 || static_cast<size_t>(len) >= _size - _len) {
+      _buf[_len] = '\0';
+      _full      = true;
+      return;
+    }
+    _len += static_cast<size_t>(len);
+  }
+
+  size_t length() const { return _len; }
+
+  private:
+  char* _buf;
+  size_t _size;
+  size_t _len = 0;
+  bool _full  = false;
+};
+
+void histogramLine(LineWriter& out, const char* name, const LatencyHistogram& h) {
+  uint32_t avg = h.count ? static_cast<uint32_t>(h.total_us / h.count) : 0;
+  out.line(" %s n=%" PRIu32 " avg=%" PRIu32 " p50=%" PRIu32 " p99=%" PRIu32 " max=%" PRIu32
+           " us\n",
+           name, h.count, avg, h.percentile(50), h.percentile(99), h.max_us);
+}
+
+uint64_t keyActivity(const KeyMetrics& key) {
+  return static_cast<uint64_t>(key.reads) + key.writes;
+}
+
+} // namespace
+
+size_t formatMetrics(ISettings& settings, char* buf, size_t size, size_t max_keys) {
+  Metrics metrics;
+  if (!buf || size == 0 || !settings.getMetrics(metrics)) return 0;
+
+  LineWriter out(buf, size);
+  out.line("%s r=%" PRIu32 " m=%" PRIu32 " w=%" PRIu32 " u=%" PRIu32 " c=%" PRIu32 " f=%" PRIu32
+           "\n",
+           settings.getNamespace(), metrics.reads, metrics.misses, metrics.writes,
+           metrics.unchanged, metrics.commits, metrics.failures);
+  histogramLine(out, "get", metrics.get);
+  histogramLine(out, "set", metrics.set);
+  histogramLine(out, "commit", metrics.commit);
+
+  // Busiest keys first, without sorting: each pass picks the busiest key after the previous one
+  uint64_t prev_activity = UINT64_MAX;
+  size_t prev_index      = SIZE_MAX;
+
+  for (size_t line = 0; line < max_keys; line++) {
+    size_t best          = SIZE_MAX;
+    uint64_t best_active = 0;
+
+    for (size_t i = 0; i < settings.getSize(); i++) {
+      KeyMetrics key;
+      settings.getKeyMetrics(i, key);
+      uint64_t activity = keyActivity(key);
+
+      bool after_prev = activity < prev_activity || (activity == prev_activity && i > prev_index);
+      if (activity > 0 && after_prev && (best == SIZE_MAX || activity > best_active)) {
+        best        = i;
+        best_active = activity;
+      }
+    }
+
+    if (best == SIZE_MAX) break;
+
+    KeyMetrics key;
+    settings.getKeyMetrics(best, key);
+    out.line(" %s r=%" PRIu32 " m=%" PRIu32 " w=%" PRIu32 " f=%" PRIu32 "\n",
+             settings.getKey(best), key.reads, key.misses, key.writes, key.failures);
+
+    prev_activity = best_active;
+    prev_index    = best;
+  }
+
+  return out.length();
+}
+
+namespace Internal {
+
+uint32_t crc32(const void* data, size_t size) {
+  // Nibble table: 64 bytes of flash instead of 1 KB for the byte-wise table
+  static const uint32_t TABLE[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  uint32_t crc         = 0xFFFFFFFF;
+
+  for (size_t i = 0; i < size; i++) {
+    crc ^= bytes[i];
+    crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+    crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+  }
+
+  return ~crc;
+}
+
+} // namespace Internal
+
 const char* formatToStr(const NVS::ByteStream::Format f) {
   switch (f) {
     case NVS::ByteStream::Format::Hex: return "Hex";
@@ -165,4 +815,1183 @@ const char* formatToStr(const NVS::ByteStream::Format f) {
   }
 }
 
+
+// Registry: one open-addressing table from key to (object, index), serving both bare and
+// "namespace/key" lookups. begin() and end() of Option::Registry objects insert and remove only
+// their own keys; the table is reallocated only when it grows past 3/4 full, and freed when empty.
+namespace {
+
+constexpr uint16_t NO_MEMBER = UINT16_MAX;
+
+struct RegistrySlot {
+  uint32_t hash;   // Hash of the bare key
+  uint16_t member; // Index into Registry::members, NO_MEMBER: empty slot
+  uint16_t index;  // Index of the setting in the object
+};
+
+struct Registry {
+  std::mutex mutex;                // Objects may begin() and end() from different tasks
+  std::vector<ISettings*> members; // nullptr: free entry, reused by the next object
+  std::vector<RegistrySlot> slots; // Power-of-two size, or empty
+  size_t used = 0;
+};
+
+// Never destroyed: global Settings objects leave the registry from their destructors, which may run
+// after the destructors of this file's statics
+Registry& registry() {
+  static Registry* r = new Registry;
+  return *r;
+}
+
+void placeSlot(std::vector<RegistrySlot>& slots, const RegistrySlot& slot) {
+  size_t mask = slots.size() - 1;
+  size_t pos  = slot.hash & mask;
+  while (slots[pos].member != NO_MEMBER)
+    pos = (pos + 1) & mask;
+  slots[pos] = slot;
+}
+
+void reserveSlots(Registry& reg, size_t used) {
+  if (used * 4 <= reg.slots.size() * 3) return;
+
+  std::vector<RegistrySlot> slots(Internal::nextPowerOfTwo(used * 2 < 4 ? 4 : used * 2),
+                                  RegistrySlot{0, NO_MEMBER, 0});
+  for (const RegistrySlot& slot : reg.slots) {
+    if (slot.member != NO_MEMBER) placeSlot(slots, slot);
+  }
+  reg.slots.swap(slots);
+}
+
+// Backward-shift deletion: later slots of the same probe run move up, so no tombstones are needed
+void removeSlot(Registry& reg, uint16_t member, size_t index) {
+  std::vector<RegistrySlot>& slots = reg.slots;
+  size_t mask = slots.size() - 1;
+  size_t hole = Internal::hashKey(reg.members[member]->getKey(index)) & mask;
+
+  while (slots[hole].member != member || slots[hole].index != index) {
+    if (slots[hole].member == NO_MEMBER) return;
+    hole = (hole + 1) & mask;
+  }
+
+  for (size_t next = (hole + 1) & mask; slots[next].member != NO_MEMBER; next = (next + 1) & mask) {
+    size_t home = slots[next].hash & mask;
+    if (((next - home) & mask) < ((next - hole) & mask)) continue;
+    slots[hole] = slots[next];
+    hole        = next;
+  }
+
+  slots[hole].member = NO_MEMBER;
+  reg.used--;
+}
+
+} // namespace
+
+bool findSetting(const char* path, SettingRef& out) {
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  if (!path || reg.slots.empty()) return false;
+
+  const char* slash = strchr(path, '/');
+  const char* key   = slash ? slash + 1 : path;
+  size_t ns_len     = slash ? static_cast<size_t>(slash - path) : 0;
+  uint32_t hash     = Internal::hashKey(key);
+  size_t mask       = reg.slots.size() - 1;
+
+  SettingRef found;
+  for (size_t pos = hash & mask; reg.slots[pos].member != NO_MEMBER; pos = (pos + 1) & mask) {
+    const RegistrySlot& slot = reg.slots[pos];
+    if (slot.hash != hash) continue;
+
+    ISettings* settings = reg.members[slot.member];
+    if (strcmp(settings->getKey(slot.index), key) != 0) continue;
+
+    if (slash) {
+      const char* ns = settings->getNamespace();
+      if (strncmp(ns, path, ns_len) != 0 || ns[ns_len] != '\0') continue;
+    }
+
+    if (found.settings) return false; // Ambiguous
+    found.settings = settings;
+    found.index    = slot.index;
+  }
+
+  if (!found.settings) return false;
+  out = found;
+  return true;
+}
+
+namespace Internal {
+
+void registerSettings(ISettings* settings) {
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  std::vector<ISettings*>& members = reg.members;
+  if (std::find(members.begin(), members.end(), settings) != members.end()) return;
+
+  auto free_entry = std::find(members.begin(), members.end(), nullptr);
+  size_t member   = static_cast<size_t>(free_entry - members.begin());
+  if (member >= NO_MEMBER) return;
+  if (free_entry == members.end()) {
+    members.push_back(settings);
+  } else {
+    *free_entry = settings;
+  }
+
+  size_t keys = settings->getSize();
+  reserveSlots(reg, reg.used + keys);
+  for (size_t i = 0; i < keys; i++) {
+    uint32_t hash = hashKey(settings->getKey(i));
+    placeSlot(reg.slots, {hash, static_cast<uint16_t>(member), static_cast<uint16_t>(i)});
+  }
+  reg.used += keys;
+}
+
+void unregisterSettings(ISettings* settings) {
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  std::vector<ISettings*>& members = reg.members;
+
+  auto it = std::find(members.begin(), members.end(), settings);
+  if (it == members.end()) return;
+
+  uint16_t member = static_cast<uint16_t>(it - members.begin());
+  for (size_t i = 0; i < settings->getSize(); i++)
+    removeSlot(reg, member, i);
+  *it = nullptr;
+
+  if (reg.used == 0) {
+    std::vector<RegistrySlot>().swap(reg.slots);
+    std::vector<ISettings*>().swap(members);
+  }
+}
+
+} // namespace Internal
+
+// Writer: the Async objects with writes waiting, drained by one task. Each object has at most one
+// entry, which holds when it is due: the earliest coalescing deadline among its staged values.
+namespace {
+
+constexpr size_t NOT_RUNNING = SIZE_MAX;
+
+struct WriterEntry {
+  Internal::AsyncJob job;
+  int64_t due;     // esp_timer_get_time() at which to drain the object
+  int64_t requeue; // Due time of writes queued while the object is being drained, -1 if none
+};
+
+struct Writer {
+  std::mutex mutex;
+  std::condition_variable queued; // Signaled when a job is queued or a flush starts
+  std::condition_variable idle;   // Signaled when no job is left
+  std::vector<WriterEntry> entries;
+  size_t capacity   = 0;
+  size_t running    = NOT_RUNNING; // Entry being drained
+  uint32_t flushing = 0;           // flush() calls waiting: drain everything now
+  bool started      = false;
+#ifdef ESP_PLATFORM
+  TaskHandle_t task = nullptr;
+#else
+  std::thread::id thread;
+#endif
+};
+
+// Never destroyed, as the registry: global Async objects flush from their destructors
+Writer& writer() {
+  static Writer* w = new Writer;
+  return *w;
+}
+
+bool onWriter() {
+#ifdef ESP_PLATFORM
+  return xTaskGetCurrentTaskHandle() == writer().task;
+#else
+  return std::this_thread::get_id() == writer().thread;
+#endif
+}
+
+void writerLoop() {
+  Writer& w = writer();
+  std::unique_lock<std::mutex> lock(w.mutex);
+
+  while (true) {
+    if (w.entries.empty()) {
+      w.queued.wait(lock);
+      continue;
+    }
+
+    size_t next = 0;
+    for (size_t i = 1; i < w.entries.size(); i++) {
+      if (w.entries[i].due < w.entries[next].due) next = i;
+    }
+
+    int64_t wait_us = w.entries[next].due - esp_timer_get_time();
+    if (w.flushing == 0 && wait_us > 0) {
+      w.queued.wait_for(lock, std::chrono::microseconds(wait_us));
+      continue;
+    }
+
+    // Entries are only appended while the lock is released, so `next` stays valid
+    Internal::AsyncJob job = w.entries[next].job;
+    bool force             = w.flushing > 0;
+    w.running              = next;
+
+    lock.unlock();
+    int64_t again = job.drain(job.target, force);
+    lock.lock();
+
+    WriterEntry& entry = w.entries[next];
+    if (entry.requeue >= 0) again = (again < 0) ? entry.requeue : std::min(again, entry.requeue);
+
+    if (again < 0) {
+      entry = w.entries.back();
+      w.entries.pop_back();
+    } else {
+      entry.due     = again;
+      entry.requeue = -1;
+    }
+
+    w.running = NOT_RUNNING;
+    if (w.entries.empty()) w.idle.notify_all();
+  }
+}
+
+#ifdef ESP_PLATFORM
+void writerTask(void*) { writerLoop(); }
+#endif
+
+} // namespace
+
+bool startWriter(const WriterConfig& config) {
+  Writer& w = writer();
+  std::lock_guard<std::mutex> lock(w.mutex);
+
+  if (w.started) return true;
+  if (config.queue_length == 0) return false;
+
+  w.capacity = config.queue_length;
+  w.entries.reserve(config.queue_length);
+
+#ifdef ESP_PLATFORM
+  BaseType_t core = (config.core < 0) ? tskNO_AFFINITY : static_cast<BaseType_t>(config.core);
+  if (xTaskCreatePinnedToCore(writerTask, "nvs_writer", config.stack_size, nullptr,
+                              config.priority, &w.task, core) != pdPASS) {
+    return false;
+  }
+#else
+  std::thread t(writerLoop);
+  w.thread = t.get_id();
+  t.detach();
+#endif
+
+  w.started = true;
+  return true;
+}
+
+void flush() {
+  Writer& w = writer();
+  if (onWriter()) return;
+
+  std::unique_lock<std::mutex> lock(w.mutex);
+  w.flushing++;
+  w.queued.notify_one();
+  w.idle.wait(lock, [&w] { return w.entries.empty(); });
+  w.flushing--;
+}
+
+namespace Internal {
+
+bool enqueueAsync(const AsyncJob& job, int64_t due) {
+  Writer& w = writer();
+  if (!startWriter()) return false;
+
+  std::lock_guard<std::mutex> lock(w.mutex);
+
+  for (size_t i = 0; i < w.entries.size(); i++) {
+    WriterEntry& entry = w.entries[i];
+    if (entry.job.target != job.target) continue;
+
+    if (i == w.running) {
+      entry.requeue = (entry.requeue < 0) ? due : std::min(entry.requeue, due);
+    } else {
+      entry.due = std::min(entry.due, due);
+    }
+
+    w.queued.notify_one();
+    return true;
+  }
+
+  if (w.entries.size() >= w.capacity) return false;
+
+  w.entries.push_back({job, due, -1});
+  w.queued.notify_one();
+  return true;
+}
+
+} // namespace Internal
+
+// Notifier: the DeferCallbacks objects with change events waiting. A bounded lock-free queue, so
+// that writers (any task, or the background writer) never block on a slow callback; the
+// notification task only sleeps on the condition variable. Deliveries that find the queue full
+// wait in an overflow list instead, so that no event is lost.
+namespace {
+
+constexpr size_t NOTIFY_CAPACITY = SETTINGS_NOTIFY_QUEUE_LENGTH;
+static_assert(NOTIFY_CAPACITY >= 2 && (NOTIFY_CAPACITY & (NOTIFY_CAPACITY - 1)) == 0,
+              "SETTINGS_NOTIFY_QUEUE_LENGTH must be a power of two");
+
+// Bounded multi-producer multi-consumer queue (D. Vyukov): a cell's sequence tells whether it is
+// free for the producer at that position, or holds a job for the consumer at that position.
+class NotifyQueue {
+  public:
+  NotifyQueue() {
+    for (size_t i = 0; i < NOTIFY_CAPACITY; i++)
+      _cells[i].seq.store(i, std::memory_order_relaxed);
+  }
+
+  bool push(const Internal::NotifyJob& job) {
+    size_t pos = _tail.load(std::memory_order_relaxed);
+    while (true) {
+      Cell& cell   = _cells[pos & (NOTIFY_CAPACITY - 1)];
+      size_t seq   = cell.seq.load(std::memory_order_acquire);
+      intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+      if (dif == 0) {
+        if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          cell.job = job;
+          cell.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (dif < 0) {
+        return false; // Full
+      } else {
+        pos = _tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool pop(Internal::NotifyJob& job) {
+    size_t pos = _head.load(std::memory_order_relaxed);
+    while (true) {
+      Cell& cell   = _cells[pos & (NOTIFY_CAPACITY - 1)];
+      size_t seq   = cell.seq.load(std::memory_order_acquire);
+      intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+      if (dif == 0) {
+        if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          job = cell.job;
+          cell.seq.store(pos + NOTIFY_CAPACITY, std::memory_order_release);
+          return true;
+        }
+      } else if (dif < 0) {
+        return false; // Empty
+      } else {
+        pos = _head.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Jobs queued, possibly stale by the time it returns
+  size_t size() const {
+    return _tail.load(std::memory_order_relaxed) - _head.load(std::memory_order_relaxed);
+  }
+
+  private:
+  struct Cell {
+    std::atomic<size_t> seq;
+    Internal::NotifyJob job;
+  };
+
+  std::array<Cell, NOTIFY_CAPACITY> _cells;
+  std::atomic<size_t> _head{0};
+  std::atomic<size_t> _tail{0};
+};
+
+struct Notifier {
+  NotifyQueue queue;
+  std::mutex overflow_mutex;
+  std::vector<Internal::NotifyJob> overflow; // Deliveries that found the queue full
+  std::atomic<bool> overflowed{false};
+  std::mutex mutex;
+  std::condition_variable wake; // Signaled when a job is queued
+  bool signaled = false;
+  std::atomic<bool> started{false};
+};
+
+// Never destroyed, as the writer
+Notifier& notifier() {
+  static Notifier* n = new Notifier;
+  return *n;
+}
+
+void notifierLoop() {
+  Notifier& n = notifier();
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(n.mutex);
+      n.wake.wait(lock, [&n] { return n.signaled; });
+      n.signaled = false;
+    }
+
+    poll();
+  }
+}
+
+#ifdef ESP_PLATFORM
+void notifierTask(void*) { notifierLoop(); }
+#endif
+
+// Identity of the calling task, to tell a callback calling end() on its own object
+const void* currentTask() {
+#ifdef ESP_PLATFORM
+  return xTaskGetCurrentTaskHandle();
+#else
+  static thread_local char tag;
+  return &tag;
+#endif
+}
+
+// Run a delivery, or hand it to the task already delivering the same object, which runs it again
+// once done: no task ever waits for the callbacks of another one
+size_t runDelivery(const Internal::NotifyJob& job) {
+  Internal::NotifyState& state = *job.state;
+  size_t delivered             = 0;
+
+  if (state.requests.fetch_add(1, std::memory_order_acq_rel) == 0) {
+    uint32_t claimed = 1;
+    while (true) {
+      state.deliverer = currentTask();
+      state.queued    = false; // From now on, a new change queues another delivery
+      delivered      += job.deliver(job.target);
+      state.deliverer = nullptr;
+
+      uint32_t requested = state.requests.fetch_sub(claimed, std::memory_order_acq_rel);
+      if (requested == claimed) break;
+      claimed = requested - claimed;
+    }
+  }
+
+  state.busy.fetch_sub(1, std::memory_order_release);
+  return delivered;
+}
+
+} // namespace
+
+bool startNotifier(const NotifierConfig& config) {
+  Notifier& n = notifier();
+  std::lock_guard<std::mutex> lock(n.mutex);
+
+  if (n.started) return true;
+
+#ifdef ESP_PLATFORM
+  BaseType_t core = (config.core < 0) ? tskNO_AFFINITY : static_cast<BaseType_t>(config.core);
+  if (xTaskCreatePinnedToCore(notifierTask, "nvs_notifier", config.stack_size, nullptr,
+                              config.priority, nullptr, core) != pdPASS) {
+    return false;
+  }
+#else
+  (void)config; // Task parameters only
+  std::thread(notifierLoop).detach();
+#endif
+
+  // Events queued before the task started
+  n.signaled = true;
+  n.wake.notify_one();
+  n.started = true;
+  return true;
+}
+
+size_t poll() {
+  Notifier& n      = notifier();
+  size_t delivered = 0;
+
+  // Only the jobs queued so far: callbacks that write again are delivered by the next call
+  Internal::NotifyJob job;
+  for (size_t pending = n.queue.size(); pending > 0 && n.queue.pop(job); pending--)
+    delivered += runDelivery(job);
+
+  if (n.overflowed.load(std::memory_order_acquire)) {
+    std::vector<Internal::NotifyJob> jobs;
+    {
+      std::lock_guard<std::mutex> lock(n.overflow_mutex);
+      jobs.swap(n.overflow);
+      n.overflowed = false;
+    }
+
+    for (const Internal::NotifyJob& overflow_job : jobs)
+      delivered += runDelivery(overflow_job);
+  }
+
+  return delivered;
+}
+
+namespace Internal {
+
+void enqueueNotify(const NotifyJob& job) {
+  Notifier& n = notifier();
+  job.state->busy.fetch_add(1, std::memory_order_relaxed);
+
+  if (!n.queue.push(job)) {
+    std::lock_guard<std::mutex> lock(n.overflow_mutex);
+    n.overflow.push_back(job);
+    n.overflowed = true;
+  }
+
+  if (n.started) {
+    std::lock_guard<std::mutex> lock(n.mutex);
+    n.signaled = true;
+    n.wake.notify_one();
+  }
+}
+
+void drainNotify(const NotifyState& state) {
+  if (state.deliverer.load() == currentTask()) return;
+
+  while (state.busy.load(std::memory_order_acquire) > 0) {
+    // Delivered here, or by another task that already dequeued it
+    if (poll() > 0) continue;
+#ifdef ESP_PLATFORM
+    vTaskDelay(1);
+#else
+    std::this_thread::yield();
+#endif
+  }
+}
+
+} // namespace Internal
+
+// Wear: write counters of the namespaces used by Option::Wear objects, partition totals, and the
+// samples estimateWear() measures the write rate from.
+namespace {
+
+constexpr float SECONDS_PER_YEAR = 31557600.0f; // 365.25 days
+
+struct WearSample {
+  int64_t time_us;  // esp_timer_get_time() when sampled
+  uint32_t entries; // Entries written so far
+  size_t available; // Free entries of the partition, without the page kept for garbage collection
+};
+
+struct Wear {
+  std::mutex mutex; // Guards the namespace names, the samples and the callback
+  std::array<Internal::WearCounter, SETTINGS_WEAR_NAMESPACES> namespaces;
+  std::atomic<uint32_t> entries{0}; // Entries written by every Option::Wear object
+  std::array<WearSample, SETTINGS_WEAR_SAMPLES> samples;
+  size_t sample_count = 0;
+  size_t next_sample  = 0;
+  int64_t start_us    = 0; // Start of the counters: boot, or the last resetWear()
+  WearAlertCb alert;
+};
+
+// Never destroyed, as the registry: counters are used from writes until the very end
+Wear& wear() {
+  static Wear* w = new Wear;
+  return *w;
+}
+
+} // namespace
+
+void setWearAlertCallback(const WearAlertCb& callback) {
+  std::lock_guard<std::mutex> lock(wear().mutex);
+  wear().alert = callback;
+}
+
+bool sampleWear(const char* partition_name) {
+  nvs_stats_t stats;
+  if (!getStats(stats, partition_name)) return false;
+
+  Wear& w = wear();
+  std::lock_guard<std::mutex> lock(w.mutex);
+
+  w.samples[w.next_sample] = {esp_timer_get_time(), w.entries.load(std::memory_order_relaxed),
+                              stats.available_entries};
+  w.next_sample            = (w.next_sample + 1) % w.samples.size();
+  w.sample_count           = std::min(w.sample_count + 1, w.samples.size());
+  return true;
+}
+
+bool estimateWear(WearEstimate& estimate, uint32_t endurance_cycles, const char* partition_name) {
+  nvs_stats_t stats;
+  if (!getStats(stats, partition_name)) return false;
+
+  Wear& w = wear();
+  std::lock_guard<std::mutex> lock(w.mutex);
+
+  int64_t now       = esp_timer_get_time();
+  uint32_t entries  = w.entries.load(std::memory_order_relaxed);
+  size_t available  = stats.available_entries;
+  WearSample oldest = {w.start_us, 0, available};
+
+  // The least free space over the window: less room between erases means more erases
+  for (size_t i = 0; i < w.sample_count; i++)
+    available = std::min(available, w.samples[i].available);
+  if (w.sample_count > 0) oldest = w.samples[w.sample_count < w.samples.size() ? 0 : w.next_sample];
+  if (available == 0) return false;
+
+  float window_s       = static_cast<float>(now - oldest.time_us) / 1e6f;
+  float rate           = window_s > 0 ? static_cast<float>(entries - oldest.entries) / window_s : 0;
+  float cycles_per_sec = rate / static_cast<float>(available);
+
+  estimate.stats            = stats;
+  estimate.entries_written  = entries;
+  estimate.window_s         = static_cast<uint32_t>(window_s);
+  estimate.entries_per_hour = rate * 3600.0f;
+  estimate.erase_cycles     = static_cast<float>(entries) / static_cast<float>(available);
+  estimate.cycles_per_year  = cycles_per_sec * SECONDS_PER_YEAR;
+  estimate.lifetime_years   = estimate.cycles_per_year > 0
+                              ? static_cast<float>(endurance_cycles) / estimate.cycles_per_year
+                              : INFINITY;
+  return true;
+}
+
+bool getNamespaceWear(const char* ns_name, NamespaceWear& out) {
+  if (!ns_name) return false;
+
+  Wear& w = wear();
+  std::lock_guard<std::mutex> lock(w.mutex);
+
+  for (const Internal::WearCounter& counter : w.namespaces) {
+    if (strcmp(counter.name, ns_name) != 0) continue;
+    out.writes  = counter.writes.load(std::memory_order_relaxed);
+    out.entries = counter.entries.load(std::memory_order_relaxed);
+    return true;
+  }
+  return false;
+}
+
+void resetWear() {
+  Wear& w = wear();
+  std::lock_guard<std::mutex> lock(w.mutex);
+
+  for (Internal::WearCounter& counter : w.namespaces) {
+    counter.writes.store(0, std::memory_order_relaxed);
+    counter.entries.store(0, std::memory_order_relaxed);
+  }
+  w.entries.store(0, std::memory_order_relaxed);
+  w.sample_count = 0;
+  w.next_sample  = 0;
+  w.start_us     = esp_timer_get_time();
+}
+
+namespace Internal {
+
+WearCounter* wearCounter(const char* ns_name) {
+  Wear& w = wear();
+  std::lock_guard<std::mutex> lock(w.mutex);
+
+  for (WearCounter& counter : w.namespaces) {
+    if (strcmp(counter.name, ns_name) == 0) return &counter;
+    if (counter.name[0] != '\0') continue;
+
+    strncpy(counter.name, ns_name, sizeof(counter.name) - 1);
+    return &counter;
+  }
+  return nullptr;
+}
+
+void countWear(WearCounter* counter, uint32_t writes, uint32_t entries) {
+  wear().entries.fetch_add(entries, std::memory_order_relaxed);
+
+  if (!counter) return;
+  counter->writes.fetch_add(writes, std::memory_order_relaxed);
+  counter->entries.fetch_add(entries, std::memory_order_relaxed);
+}
+
+void wearAlert(const char* ns_name, const char* key, uint32_t budget, uint32_t period_s) {
+  WearAlertCb alert;
+  {
+    std::lock_guard<std::mutex> lock(wear().mutex);
+    alert = wear().alert;
+  }
+  if (alert) alert(ns_name, key, budget, period_s);
+}
+
+} // namespace Internal
+
+// Chunked blobs (Option::Chunked): an index under the key, and one blob per chunk under a key
+// derived from it. Chunks are read and written straight from the caller's buffers; only partial
+// chunks go through a stack buffer.
+namespace {
+
+using ChunkedBlobPolicy = Internal::ChunkedBlobPolicy;
+
+constexpr uint32_t CHUNK_MAGIC         = 0x314B4843; // "CHK1"
+constexpr uint32_t CHUNK_MAGIC_PENDING = 0x304B4843; // "CHK0": chunks being rewritten
+constexpr size_t CHUNK_HEADER_SIZE     = 12;
+constexpr size_t CHUNK_MAX_KEY_CHUNK   = 0xFFF; // Three hex digits in chunk keys
+
+struct ChunkIndex {
+  uint32_t magic;
+  uint32_t size;
+  uint16_t chunk_size;
+  uint16_t count;
+  uint32_t crcs[ChunkedBlobPolicy::MAX_CHUNKS];
+
+  size_t storedSize() const { return CHUNK_HEADER_SIZE + count * sizeof(uint32_t); }
+  size_t chunkLength(size_t i) const { return std::min<size_t>(chunk_size, size - i * chunk_size); }
+};
+
+static_assert(offsetof(ChunkIndex, crcs) == CHUNK_HEADER_SIZE, "Unexpected index layout");
+static_assert(ChunkedBlobPolicy::MAX_CHUNKS <= CHUNK_MAX_KEY_CHUNK, "Too many chunks");
+
+// What a key holds: nothing, a plain blob, an index, or the index of a write cut short
+enum class Stored { None, Plain, Chunked, Pending };
+
+void chunkKey(const char* key, size_t chunk, char (&out)[NVS_KEY_NAME_MAX_SIZE]) {
+  snprintf(out, sizeof(out), "~%08" PRIx32 "%03x", Internal::crc32(key, strlen(key)),
+           static_cast<unsigned>(chunk));
+}
+
+Stored readIndex(nvs_handle_t handle, const char* key, ChunkIndex& index) {
+  size_t length = sizeof(index);
+  esp_err_t err = nvs_get_blob(handle, key, &index, &length);
+  if (err == ESP_ERR_NVS_INVALID_LENGTH) return Stored::Plain; // Larger than any index
+  if (err != ESP_OK) return Stored::None;
+
+  if (length < CHUNK_HEADER_SIZE) return Stored::Plain;
+
+  bool pending = index.magic == CHUNK_MAGIC_PENDING;
+  bool valid   = (index.magic == CHUNK_MAGIC || pending) && index.chunk_size > 0 &&
+                 index.count <= ChunkedBlobPolicy::MAX_CHUNKS && length == index.storedSize() &&
+                 index.count == (index.size + index.chunk_size - 1) / index.chunk_size;
+
+  if (!valid) return Stored::Plain;
+  return pending ? Stored::Pending : Stored::Chunked;
+}
+
+// Read a whole chunk and check it against its CRC
+bool readChunk(nvs_handle_t handle, const char* key, const ChunkIndex& index, size_t chunk,
+               uint8_t* dst) {
+  char name[NVS_KEY_NAME_MAX_SIZE];
+  chunkKey(key, chunk, name);
+
+  size_t expected = index.chunkLength(chunk);
+  size_t length   = expected;
+  if (nvs_get_blob(handle, name, dst, &length) != ESP_OK || length != expected) return false;
+  return Internal::crc32(dst, length) == index.crcs[chunk];
+}
+
+bool writeChunk(nvs_handle_t handle, const char* key, size_t chunk, const uint8_t* src,
+                size_t length, uint32_t& entries) {
+  char name[NVS_KEY_NAME_MAX_SIZE];
+  chunkKey(key, chunk, name);
+
+  if (nvs_set_blob(handle, name, src, length) != ESP_OK) return false;
+  entries += Internal::blobEntries(length);
+  return true;
+}
+
+bool writeIndex(nvs_handle_t handle, const char* key, const ChunkIndex& index,
+                uint32_t& entries) {
+  if (nvs_set_blob(handle, key, &index, index.storedSize()) != ESP_OK) return false;
+  entries += Internal::blobEntries(index.storedSize());
+  return true;
+}
+
+// Mark the stored index pending before its first chunk is rewritten: if the write is cut short,
+// the value reads as absent and the next write rewrites every chunk instead of trusting the CRCs
+bool markPending(nvs_handle_t handle, const char* key, ChunkIndex index, uint32_t& entries) {
+  index.magic = CHUNK_MAGIC_PENDING;
+  return writeIndex(handle, key, index, entries);
+}
+
+} // namespace
+
+namespace Internal {
+
+bool ChunkedBlobPolicy::setValue(nvs_handle_t handle, const char* key, ByteStreamView value) {
+  _last_entries = 0;
+  if ((!value.data && value.size > 0) || value.size > MAX_SIZE) return false;
+
+  ChunkIndex old;
+  Stored stored = readIndex(handle, key, old);
+  bool indexed  = stored == Stored::Chunked || stored == Stored::Pending;
+  if (!indexed) old.count = 0;
+
+  ChunkIndex index = {};
+  index.magic      = CHUNK_MAGIC;
+  index.size       = static_cast<uint32_t>(value.size);
+  index.chunk_size = static_cast<uint16_t>(CHUNK_SIZE);
+  index.count      = static_cast<uint16_t>((value.size + CHUNK_SIZE - 1) / CHUNK_SIZE);
+
+  // Only the chunks of a complete index can be trusted to hold what their CRC says
+  bool same_layout = stored == Stored::Chunked && old.chunk_size == CHUNK_SIZE;
+  bool marked      = stored != Stored::Chunked;
+
+  for (size_t i = 0; i < index.count; i++) {
+    const uint8_t* src = value.data + i * CHUNK_SIZE;
+    size_t length      = index.chunkLength(i);
+    index.crcs[i]      = crc32(src, length);
+
+    if (same_layout && i < old.count && old.chunkLength(i) == length &&
+        old.crcs[i] == index.crcs[i]) {
+      continue;
+    }
+
+    if (!marked && !markPending(handle, key, old, _last_entries)) return false;
+    marked = true;
+    if (!writeChunk(handle, key, i, src, length, _last_entries)) return false;
+  }
+
+  if (stored != Stored::Chunked || old.storedSize() != index.storedSize() ||
+      memcmp(&old, &index, index.storedSize()) != 0) {
+    if (!writeIndex(handle, key, index, _last_entries)) return false;
+  }
+
+  // Chunks past the new end. A leftover one only costs space: the index no longer points to it.
+  for (size_t i = index.count; i < old.count; i++) {
+    char name[NVS_KEY_NAME_MAX_SIZE];
+    chunkKey(key, i, name);
+    nvs_erase_key(handle, name);
+  }
+  return true;
+}
+
+bool ChunkedBlobPolicy::getValue(nvs_handle_t handle, const char* key, ByteStream& value) {
+  ChunkIndex index;
+  switch (readIndex(handle, key, index)) {
+  case Stored::None:
+  case Stored::Pending:
+    return false;
+  case Stored::Plain:
+    return ByteStreamPolicy().getValue(handle, key, value);
+  case Stored::Chunked:
+    break;
+  }
+
+  if (!value.data || value.max_size == 0 || index.size > value.max_size) return false;
+
+  for (size_t i = 0; i < index.count; i++) {
+    if (!readChunk(handle, key, index, i, value.data + i * index.chunk_size)) return false;
+  }
+
+  value.size = index.size;
+  return true;
+}
+
+bool ChunkedBlobPolicy::getSize(nvs_handle_t handle, const char* key, size_t& size) {
+  ChunkIndex index;
+  switch (readIndex(handle, key, index)) {
+  case Stored::None:
+  case Stored::Pending:
+    return false;
+  case Stored::Plain:
+    return ByteStreamPolicy().getSize(handle, key, size);
+  case Stored::Chunked:
+    break;
+  }
+
+  size = index.size;
+  return true;
+}
+
+bool ChunkedBlobPolicy::readRange(nvs_handle_t handle, const char* key, size_t offset,
+                                  uint8_t* buf, size_t size) {
+  ChunkIndex index;
+  if (readIndex(handle, key, index) != Stored::Chunked) return false;
+  if (offset > index.size || size > index.size - offset) return false;
+  if (size == 0) return true;
+  if (!buf) return false;
+
+  uint8_t partial[CHUNK_SIZE];
+  size_t end = offset + size;
+
+  for (size_t i = offset / index.chunk_size; i * index.chunk_size < end; i++) {
+    size_t start  = i * index.chunk_size;
+    size_t length = index.chunkLength(i);
+    size_t from   = std::max(offset, start);
+    size_t to     = std::min(end, start + length);
+
+    // Whole chunks go straight into the caller's buffer
+    if (from == start && to == start + length) {
+      if (!readChunk(handle, key, index, i, buf + (start - offset))) return false;
+      continue;
+    }
+
+    if (length > sizeof(partial)) return false; // Written with a larger SETTINGS_CHUNK_SIZE
+    if (!readChunk(handle, key, index, i, partial)) return false;
+    memcpy(buf + (from - offset), partial + (from - start), to - from);
+  }
+  return true;
+}
+
+bool ChunkedBlobPolicy::writeRange(nvs_handle_t handle, const char* key, size_t offset,
+                                   ByteStreamView data, bool& changed) {
+  _last_entries = 0;
+  changed       = false;
+
+  ChunkIndex index;
+  if (readIndex(handle, key, index) != Stored::Chunked) return false;
+  if (offset > index.size || data.size > index.size - offset) return false;
+  if (data.size == 0) return true;
+  if (!data.data) return false;
+
+  uint8_t partial[CHUNK_SIZE];
+  size_t end = offset + data.size;
+
+  for (size_t i = offset / index.chunk_size; i * index.chunk_size < end; i++) {
+    size_t start  = i * index.chunk_size;
+    size_t length = index.chunkLength(i);
+    size_t from   = std::max(offset, start);
+    size_t to     = std::min(end, start + length);
+
+    // Whole chunks come straight from `data`; chunks only partly overwritten (where `start` may
+    // precede `offset`) are patched in the stack buffer
+    const uint8_t* src = partial;
+    if (from == start && to == start + length) {
+      src = data.data + (start - offset);
+    } else {
+      if (length > sizeof(partial)) return false;
+      if (!readChunk(handle, key, index, i, partial)) return false;
+      memcpy(partial + (from - start), data.data + (from - offset), to - from);
+    }
+
+    uint32_t crc = crc32(src, length);
+    if (crc == index.crcs[i]) continue;
+
+    if (!changed && !markPending(handle, key, index, _last_entries)) return false;
+    changed = true;
+    if (!writeChunk(handle, key, i, src, length, _last_entries)) return false;
+    index.crcs[i] = crc;
+  }
+
+  if (!changed) return true;
+  return writeIndex(handle, key, index, _last_entries);
+}
+
+} // namespace Internal
+
+// Compression (Option::Compressed): an LZ77 codec in the LZ4 block layout, bounded to a stack
+// buffer of SETTINGS_COMPRESS_BUFFER bytes and a hash table of LZ_HASH_SIZE positions.
+namespace {
+
+constexpr size_t LZ_MIN_MATCH   = 4;
+constexpr size_t LZ_HASH_BITS   = 9;
+constexpr size_t LZ_HASH_SIZE   = 1 << LZ_HASH_BITS;
+constexpr size_t LZ_MAX_INPUT   = UINT16_MAX; // Positions and offsets are 16-bit
+constexpr uint8_t LZ_VERSION    = 1;
+constexpr uint8_t LZ_MAGIC[2]   = {'L', 'Z'};
+constexpr size_t LZ_HEADER_SIZE = Internal::LZ_HEADER_SIZE;
+
+enum LzMethod : uint8_t { LZ_METHOD_LZ = 0, LZ_METHOD_STORED = 1 };
+
+struct LzHeader {
+  uint8_t magic[2];
+  uint8_t version;
+  uint8_t method;
+  uint32_t raw_size;
+  uint32_t crc;
+};
+
+static_assert(sizeof(LzHeader) == LZ_HEADER_SIZE, "Unexpected header layout");
+static_assert(SETTINGS_COMPRESS_BUFFER > LZ_HEADER_SIZE, "SETTINGS_COMPRESS_BUFFER is too small");
+
+uint32_t lzHash(const uint8_t* src) {
+  uint32_t sequence;
+  memcpy(&sequence, src, sizeof(sequence));
+  return (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+// Length past the 15 of a token nibble: 255 per byte, ended by a byte under 255
+bool lzPutLength(uint8_t* dst, size_t capacity, size_t& op, size_t length) {
+  for (; length >= 255; length -= 255) {
+    if (op >= capacity) return false;
+    dst[op++] = 255;
+  }
+  if (op >= capacity) return false;
+  dst[op++] = static_cast<uint8_t>(length);
+  return true;
+}
+
+bool lzGetLength(const uint8_t* src, size_t size, size_t& ip, size_t& length) {
+  uint8_t byte;
+  do {
+    if (ip >= size) return false;
+    byte = src[ip++];
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+// A sequence: token, literals, then the match (offset and length) unless it is the last one
+bool lzPutSequence(uint8_t* dst, size_t capacity, size_t& op, const uint8_t* literals,
+                   size_t literal_length, size_t offset, size_t match_length) {
+  if (op >= capacity) return false;
+
+  size_t match_code = match_length ? match_length - LZ_MIN_MATCH : 0;
+  size_t high       = std::min<size_t>(literal_length, 15);
+  size_t low        = std::min<size_t>(match_code, 15);
+  dst[op++]         = static_cast<uint8_t>(high << 4 | low);
+
+  if (literal_length >= 15 && !lzPutLength(dst, capacity, op, literal_length - 15)) return false;
+  if (literal_length > capacity - op) return false;
+  memcpy(dst + op, literals, literal_length);
+  op += literal_length;
+
+  if (match_length == 0) return true;
+
+  if (capacity - op < 2) return false;
+  dst[op++] = static_cast<uint8_t>(offset);
+  dst[op++] = static_cast<uint8_t>(offset >> 8);
+  return match_code < 15 || lzPutLength(dst, capacity, op, match_code - 15);
+}
+
+// A stored value must match its length and CRC: a blob that does not is a raw one, written before
+// the option was enabled
+bool parseHeader(const uint8_t* buf, size_t length, LzHeader& header) {
+  if (length < LZ_HEADER_SIZE) return false;
+  memcpy(&header, buf, sizeof(header));
+  if (memcmp(header.magic, LZ_MAGIC, sizeof(LZ_MAGIC)) != 0 || header.version != LZ_VERSION) {
+    return false;
+  }
+  if (header.method == LZ_METHOD_LZ) return true;
+  return header.method == LZ_METHOD_STORED && header.raw_size == length - LZ_HEADER_SIZE &&
+         Internal::crc32(buf + LZ_HEADER_SIZE, header.raw_size) == header.crc;
+}
+
+esp_err_t copyOut(const uint8_t* src, size_t length, uint8_t* out, size_t max_size) {
+  if (!out) return ESP_OK;
+  if (length > max_size) return ESP_ERR_NVS_INVALID_LENGTH;
+  if (length > 0) memcpy(out, src, length);
+  return ESP_OK;
+}
+
+} // namespace
+
+namespace Internal {
+
+size_t lzCompress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity) {
+  if (size > LZ_MAX_INPUT) return 0;
+
+  uint16_t table[LZ_HASH_SIZE] = {};
+  size_t ip = 0, anchor = 0, op = 0;
+
+  while (size - ip >= LZ_MIN_MATCH) {
+    uint32_t hash    = lzHash(src + ip);
+    size_t candidate = table[hash];
+    table[hash]      = static_cast<uint16_t>(ip);
+
+    if (candidate >= ip || memcmp(src + candidate, src + ip, LZ_MIN_MATCH) != 0) {
+      ip++;
+      continue;
+    }
+
+    size_t length = LZ_MIN_MATCH;
+    while (ip + length < size && src[candidate + length] == src[ip + length])
+      length++;
+
+    if (!lzPutSequence(dst, capacity, op, src + anchor, ip - anchor, ip - candidate, length)) {
+      return 0;
+    }
+
+    ip     = ip + length;
+    anchor = ip;
+  }
+
+  if (!lzPutSequence(dst, capacity, op, src + anchor, size - anchor, 0, 0)) return 0;
+  return op;
+}
+
+bool lzDecompress(const uint8_t* src, size_t size, uint8_t* dst, size_t raw_size) {
+  size_t ip = 0, op = 0;
+
+  while (ip < size) {
+    uint8_t token = src[ip++];
+
+    size_t literal_length = token >> 4;
+    if (literal_length == 15 && !lzGetLength(src, size, ip, literal_length)) return false;
+    if (literal_length > size - ip || literal_length > raw_size - op) return false;
+    memcpy(dst + op, src + ip, literal_length);
+    ip += literal_length;
+    op += literal_length;
+
+    if (ip == size) break; // The last sequence has no match
+
+    if (size - ip < 2) return false;
+    size_t offset       = src[ip] | (src[ip + 1] << 8);
+    size_t match_length = token & 0x0F;
+    ip                  = ip + 2;
+    if (match_length == 15 && !lzGetLength(src, size, ip, match_length)) return false;
+    match_length += LZ_MIN_MATCH;
+
+    if (offset == 0 || offset > op || match_length > raw_size - op) return false;
+
+    // Byte by byte: a match may overlap the bytes it produces (runs)
+    for (size_t i = 0; i < match_length; i++, op++)
+      dst[op] = dst[op - offset];
+  }
+
+  return op == raw_size;
+}
+
+bool writeCompressed(nvs_handle_t handle, const char* key, const uint8_t* data, size_t size,
+                     uint32_t& entries) {
+  uint8_t buf[SETTINGS_COMPRESS_BUFFER];
+  size_t stored_size      = LZ_HEADER_SIZE + size;
+  uint32_t stored_entries = blobEntries(stored_size);
+  LzHeader header = {{LZ_MAGIC[0], LZ_MAGIC[1]}, LZ_VERSION, LZ_METHOD_LZ,
+                     static_cast<uint32_t>(size), crc32(data, size)};
+
+  // Worth it only if it saves at least one entry, which bounds the compressed size
+  if (stored_entries > blobEntries(LZ_HEADER_SIZE + 1)) {
+    size_t limit  = std::min(sizeof(buf), (stored_entries - 3) * size_t(32));
+    size_t stream = lzCompress(data, size, buf + LZ_HEADER_SIZE, limit - LZ_HEADER_SIZE);
+
+    if (stream > 0) {
+      memcpy(buf, &header, sizeof(header));
+      if (nvs_set_blob(handle, key, buf, LZ_HEADER_SIZE + stream) != ESP_OK) return false;
+      entries = blobEntries(LZ_HEADER_SIZE + stream);
+      return true;
+    }
+  }
+
+  // Stored as is, still behind a header so that no raw value can pass for a compressed one
+  if (stored_size > sizeof(buf)) return false;
+
+  header.method = LZ_METHOD_STORED;
+  memcpy(buf, &header, sizeof(header));
+  if (size > 0) memcpy(buf + LZ_HEADER_SIZE, data, size);
+  if (nvs_set_blob(handle, key, buf, stored_size) != ESP_OK) return false;
+  entries = stored_entries;
+  return true;
+}
+
+esp_err_t readCompressed(nvs_handle_t handle, const char* key, uint8_t* out, size_t max_size,
+                         size_t& size) {
+  uint8_t buf[SETTINGS_COMPRESS_BUFFER];
+  size_t length = sizeof(buf);
+  esp_err_t err = nvs_get_blob(handle, key, buf, &length);
+
+  // Larger than anything writeCompressed() stores: written before the option, read as is
+  if (err == ESP_ERR_NVS_INVALID_LENGTH) {
+    size = length;
+    if (!out) return ESP_OK;
+    if (length > max_size) return ESP_ERR_NVS_INVALID_LENGTH;
+    return nvs_get_blob(handle, key, out, &length);
+  }
+  if (err != ESP_OK) return err;
+
+  LzHeader header;
+  if (!parseHeader(buf, length, header)) {
+    size = length;
+    return copyOut(buf, length, out, max_size);
+  }
+
+  size = header.raw_size;
+  if (header.method == LZ_METHOD_STORED) {
+    return copyOut(buf + LZ_HEADER_SIZE, header.raw_size, out, max_size);
+  }
+
+  if (!out) return ESP_OK;
+  if (header.raw_size > max_size) return ESP_ERR_NVS_INVALID_LENGTH;
+
+  if (!lzDecompress(buf + LZ_HEADER_SIZE, length - LZ_HEADER_SIZE, out, header.raw_size) ||
+      crc32(out, header.raw_size) != header.crc) {
+    return ESP_ERR_INVALID_CRC;
+  }
+  return ESP_OK;
+}
+
+} // namespace Internal
+
 } // namespace NVS
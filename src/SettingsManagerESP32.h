@@ -6,11 +6,26 @@
 
 #pragma once
 
+#include "internal/Cache.h"
+#include "internal/Callback.h"
+#include "internal/Chunked.h"
+#include "internal/Codec.h"
+#include "internal/Compressed.h"
+#include "internal/Counters.h"
 #include "internal/ISettings.h"
+#include "internal/KeyIndex.h"
+#include "internal/Metrics.h"
+#include "internal/Notifier.h"
+#include "internal/Packed.h"
+#include "internal/Record.h"
 #include "internal/Policy.h"
+#include "internal/Registry.h"
 #include "internal/Setting.h"
 #include "internal/Settings.h"
+#include "internal/Transaction.h"
 #include "internal/Types.h"
+#include "internal/Wear.h"
+#include "internal/Writer.h"
 
 /* ---------------------------------- X-macro expansion helpers --------------------------------- */
 
@@ -77,20 +92,36 @@
   NVS::Settings<NVS::ByteStream, name, SETTINGS_COUNT(settings_macro)> st_##name( \
     ns, {settings_macro(SETTINGS_EXPAND_SETTINGS)});
 
+// Declares an NVS::Counters<> object instead, named st_<name> too
+#define SETTINGS_CREATE_COUNTERS(name, ns, settings_macro)                  \
+  enum class name : uint8_t { settings_macro(SETTINGS_EXPAND_ENUM_CLASS) }; \
+  NVS::Counters<name, SETTINGS_COUNT(settings_macro)> st_##name(            \
+    ns, {settings_macro(SETTINGS_EXPAND_SETTINGS)});
+
 /* ----------------------------------- NVS partition lifecycle ---------------------------------- */
 
+/**
+ * @brief Number of partitions whose state `NVS::init()` tracks, the default one included. Define it
+ * before including the library, or as a build flag, to change it.
+ */
+#ifndef SETTINGS_MAX_PARTITIONS
+#define SETTINGS_MAX_PARTITIONS 4
+#endif
+
 namespace NVS {
 
 /**
- * @brief Initialize the default NVS flash partition. Call once in `setup()` before any `begin()`.
+ * @brief Initialize an NVS flash partition. Call once in `setup()` before the `begin()` of any
+ * Settings object on it. Each partition is initialized, deinitialized and erased on its own.
  * @param partition_name Optional custom partition name. If `nullptr`, the default partition is
  * used.
- * @return Initialized successfully or already initialized, false otherwise.
+ * @return Initialized successfully or already initialized, false otherwise (including when
+ * `SETTINGS_MAX_PARTITIONS` partitions are already tracked).
  */
 bool init(const char* partition_name = nullptr);
 
 /**
- * @brief Deinitialize the default NVS flash partition.
+ * @brief Deinitialize an NVS flash partition. Other partitions are not affected.
  * @param partition_name Optional custom partition name. If `nullptr`, the default partition is
  * used.
  * @return Deinitialized successfully or already deinitialized, false otherwise.
@@ -98,8 +129,8 @@ bool init(const char* partition_name = nullptr);
 bool deinit(const char* partition_name = nullptr);
 
 /**
- * @brief Erase the entire default NVS flash partition. All namespaces and keys are lost. After
- * calling this, you must call `init()` again before using any Settings objects.
+ * @brief Erase an entire NVS flash partition. All its namespaces and keys are lost. After calling
+ * this, you must call `init()` again before using any Settings objects on it.
  * @param partition_name Optional custom partition name. If `nullptr`, the default partition is
  * used.
  * @note You need to call `end()` on all open Settings objects before erasing the partition.
@@ -107,6 +138,15 @@ bool deinit(const char* partition_name = nullptr);
  */
 bool erase(const char* partition_name = nullptr);
 
+/**
+ * @brief Check whether a partition was initialized with `init()`.
+ * @param partition_name Optional custom partition name. If `nullptr`, the default partition is
+ * used.
+ * @retval `true` Initialized.
+ * @retval `false` Never initialized, or deinitialized or erased since.
+ */
+bool isInitialized(const char* partition_name = nullptr);
+
 /* ------------------------------------------ Utilities ----------------------------------------- */
 
 /**
@@ -163,6 +203,35 @@ bool fromHexToStr(const NVS::ByteStreamView bs, char* buf, const size_t buf_size
  */
 bool fromStrToHex(const char* hex, NVS::ByteStream& out, const bool with_spaces = false);
 
+/**
+ * @brief Calculate the buffer size required by `fromBase64ToStr()` for a given number of bytes.
+ * @param byte_count Number of bytes to encode.
+ * @return Required buffer size in bytes, including the null terminator (4 characters per 3 bytes,
+ * padded with `=`).
+ */
+constexpr size_t base64StrSize(const size_t byte_count) { return (byte_count + 2) / 3 * 4 + 1; }
+
+/**
+ * @brief Encode a `ByteStreamView` as a null-terminated Base64 string (RFC 4648, padded) into a
+ * caller-provided buffer. To encode a blob in pieces, use `NVS::Base64Encoder`.
+ * @param bs The byte data to encode.
+ * @param buf Output buffer. Must hold at least `base64StrSize(bs.size)` bytes.
+ * @param buf_size Size of the output buffer in bytes.
+ * @retval `true` Encoded successfully.
+ * @retval `false` Buffer too small or `bs.data` is null.
+ */
+bool fromBase64ToStr(const NVS::ByteStreamView bs, char* buf, const size_t buf_size);
+
+/**
+ * @brief Decode a Base64 string (RFC 4648 alphabet) into a `ByteStream` buffer.
+ * @param b64 Null-terminated Base64 string. The `=` padding is optional; whitespace is not allowed.
+ * @param out Destination `ByteStream`. `out.data` must point to a buffer large enough to hold the
+ * decoded bytes. On success, `out.size` is updated.
+ * @retval `true` Decoded successfully.
+ * @retval `false` Invalid characters, malformed string, or buffer too small.
+ */
+bool fromStrToBase64(const char* b64, NVS::ByteStream& out);
+
 /**
  * @brief Convert a `ByteStream::Format` enum value to a string representation.
  * @param f The `ByteStream::Format` value.
@@ -0,0 +1,193 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace NVS {
+
+namespace Internal {
+
+/// @brief What the RAM cache knows about an entry.
+enum class CacheState : uint8_t {
+  Unknown, // Not loaded yet or invalidated: the next read goes to NVS
+  Present, // The key exists in NVS and `value` holds its current value
+  Absent   // The key does not exist in NVS: reads fall back to the default without touching NVS
+};
+
+/**
+ * @brief RAM copy of a single setting, used by `Settings` objects created with `Option::Cache`.
+ * @tparam T Scalar value type.
+ */
+template <typename T>
+struct CacheEntry {
+  CacheState state = CacheState::Unknown;
+  T value{};
+};
+
+/**
+ * @brief RAM copy of N scalar settings, used by `Option::Cache`. Not synchronized.
+ *
+ * Every modification happens between `beginWrite()` and `endWrite()`, and `tryRead()` runs a group
+ * of `peek()` calls that must see a consistent state; both only matter for `SeqValueCache`, which
+ * has the same interface.
+ *
+ * @tparam T Scalar value type.
+ * @tparam N Number of settings.
+ */
+template <typename T, size_t N>
+class ValueCache {
+  public:
+  /// @brief Get what the cache knows about an entry, and its value if `Present`.
+  CacheState peek(size_t index, T& value) const {
+    const CacheEntry<T>& entry = _entries[index];
+    if (entry.state == CacheState::Present) value = entry.value;
+    return entry.state;
+  }
+
+  /**
+   * @brief Run `f`, a group of `peek()` calls, so that it sees the writes of a section entirely.
+   * @retval `true` `f` saw a consistent state.
+   * @retval `false` Writes kept overlapping: run `f` again while holding the writers' lock.
+   */
+  template <typename F>
+  bool tryRead(F&& f, uint32_t = 16) const {
+    f();
+    return true;
+  }
+
+  void beginWrite() {}
+  void endWrite() {}
+
+  /// @brief Store a value, marking the entry `Present`.
+  void set(size_t index, const T& value) {
+    _entries[index].value = value;
+    _entries[index].state = CacheState::Present;
+  }
+
+  /// @brief Mark an entry `Unknown` or `Absent`.
+  void setState(size_t index, CacheState state) { _entries[index].state = state; }
+
+  /// @brief Mark every entry `Unknown`.
+  void clear() {
+    for (auto& entry : _entries)
+      entry.state = CacheState::Unknown;
+  }
+
+  private:
+  std::array<CacheEntry<T>, N> _entries{};
+};
+
+/**
+ * @brief RAM copy of N scalar settings behind a sequence lock, used by `Option::Cache` together
+ * with `Option::ThreadSafe`.
+ *
+ * Writers (serialized by the owner) make the sequence odd while they modify the cache, and even
+ * again when done. Readers never block nor write shared memory: they copy what they need and retry
+ * if the sequence was odd or changed meanwhile, so a group of values read in one `tryRead()` always
+ * comes from the same write section. Values are stored as atomic words, so a torn copy is never
+ * undefined behavior, only a retry; they are written with release and read with acquire ordering
+ * instead of fences, which ThreadSanitizer does not model. After a few failed attempts, the reader
+ * is expected to take the writers' lock instead, so a reader that preempted a writer on the same
+ * core cannot spin forever.
+ *
+ * @tparam T Scalar value type (at most 8 bytes).
+ * @tparam N Number of settings.
+ */
+template <typename T, size_t N>
+class SeqValueCache {
+  public:
+  static_assert(N == 0 || sizeof(T) <= 8, "SeqValueCache stores values of up to 8 bytes");
+
+  CacheState peek(size_t index, T& value) const {
+    CacheState state = static_cast<CacheState>(_states[index].load(std::memory_order_acquire));
+    if (state != CacheState::Present) return state;
+
+    uint32_t words[WORDS];
+    for (size_t w = 0; w < WORDS; w++)
+      words[w] = _values[index][w].load(std::memory_order_acquire);
+    memcpy(&value, words, sizeof(T));
+    return state;
+  }
+
+  template <typename F>
+  bool tryRead(F&& f, uint32_t attempts = 16) const {
+    while (attempts-- > 0) {
+      uint32_t seq = _seq.load(std::memory_order_acquire);
+      if (seq & 1) continue; // Write in progress
+
+      f();
+
+      // Any value read from a later section makes its odd sequence visible here
+      if (_seq.load(std::memory_order_relaxed) == seq) return true;
+    }
+    return false;
+  }
+
+  // Sections may nest: only the outermost one moves the sequence
+  void beginWrite() {
+    if (_depth++ > 0) return;
+    _seq.store(_seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  void endWrite() {
+    if (--_depth > 0) return;
+    _seq.store(_seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  void set(size_t index, const T& value) {
+    uint32_t words[WORDS] = {};
+    memcpy(words, &value, sizeof(T));
+    for (size_t w = 0; w < WORDS; w++)
+      _values[index][w].store(words[w], std::memory_order_release);
+    _states[index].store(static_cast<uint8_t>(CacheState::Present), std::memory_order_release);
+  }
+
+  void setState(size_t index, CacheState state) {
+    _states[index].store(static_cast<uint8_t>(state), std::memory_order_release);
+  }
+
+  void clear() {
+    for (auto& state : _states)
+      state.store(static_cast<uint8_t>(CacheState::Unknown), std::memory_order_release);
+  }
+
+  private:
+  static constexpr size_t WORDS = (sizeof(T) + 3) / 4;
+
+  std::atomic<uint32_t> _seq{0};
+  uint32_t _depth = 0; // Writer only
+  std::array<std::atomic<uint8_t>, N> _states{};
+  std::array<std::array<std::atomic<uint32_t>, WORDS>, N> _values{};
+};
+
+/**
+ * @brief Length and CRC32 of the value stored for a string or byte stream entry. Used by
+ * `Option::ElideWrites` to detect unchanged writes without reading the value back from NVS, and by
+ * `getValueSize()` with `Option::Cache`.
+ */
+struct Fingerprint {
+  bool valid   = false; // Set once the stored value has been written or read by this object
+  size_t size  = 0;     // String length (without null terminator) or blob size
+  uint32_t crc = 0;     // CRC32 of the `size` bytes
+};
+
+/**
+ * @brief Compute the CRC32 (IEEE 802.3, reflected) of a buffer.
+ * @param data Buffer. May be `nullptr` if `size` is 0.
+ * @param size Number of bytes.
+ * @return `uint32_t` CRC32.
+ */
+uint32_t crc32(const void* data, size_t size);
+
+} // namespace Internal
+
+} // namespace NVS
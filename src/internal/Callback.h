@@ -0,0 +1,182 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <array>
+#include <limits>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Maximum number of per-setting change callbacks a Settings object holds at the same time,
+ * or 0 (default) for no limit, so that registering never fails. Callbacks live in a pool that grows
+ * on the heap as they are registered; a limit bounds it, and `setOnChangeCallback()` then returns
+ * `false` once it is reached. Define it before including the library, or as a build flag, to change
+ * it.
+ */
+#ifndef SETTINGS_CALLBACK_SLOTS
+#define SETTINGS_CALLBACK_SLOTS 0
+#endif
+
+namespace NVS {
+
+namespace Internal {
+
+/// @brief Placeholder for members removed at compile time (`Option::NoCallbacks`).
+struct Empty {};
+
+template <typename Signature>
+class Delegate;
+
+/**
+ * @brief Non-owning, allocation-free callable: a function pointer, or a lambda whose captures fit
+ * in two pointers (e.g. `[this]` or `[&counter]`), copied into inline storage. Used instead of
+ * `std::function` for callbacks, which takes more RAM and may allocate.
+ * @note Whatever a lambda captures by reference must outlive the registration.
+ * @tparam R Return type.
+ * @tparam Args Argument types.
+ */
+template <typename R, typename... Args>
+class Delegate<R(Args...)> {
+  public:
+  static constexpr size_t STORAGE_SIZE = 2 * sizeof(void*);
+
+  constexpr Delegate()
+      : _storage{}
+      , _invoke(nullptr) {}
+
+  constexpr Delegate(std::nullptr_t)
+      : Delegate() {}
+
+  template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Delegate> &&
+                                                    std::is_invocable_r_v<R, F&, Args...>>>
+  Delegate(F f)
+      : Delegate() {
+    static_assert(sizeof(F) <= STORAGE_SIZE && alignof(F) <= alignof(void*),
+                  "Callback too large: capture at most two pointers");
+    static_assert(std::is_trivially_copyable_v<F> && std::is_trivially_destructible_v<F>,
+                  "Callback must be a function pointer or a lambda capturing pointers");
+
+    if constexpr (std::is_pointer_v<F>) {
+      if (f == nullptr) return;
+    }
+
+    memcpy(_storage, &f, sizeof(F));
+    _invoke = [](void* storage, Args... args) -> R {
+      return (*static_cast<F*>(storage))(static_cast<Args>(args)...);
+    };
+  }
+
+  /// @brief Check whether a callable is set.
+  explicit operator bool() const { return _invoke != nullptr; }
+
+  R operator()(Args... args) const {
+    return _invoke(const_cast<unsigned char*>(_storage), static_cast<Args>(args)...);
+  }
+
+  private:
+  alignas(void*) unsigned char _storage[STORAGE_SIZE];
+  R (*_invoke)(void* storage, Args... args);
+};
+
+/**
+ * @brief Per-setting callbacks, stored sparsely: one small index per setting into a pool that
+ * holds only the registered callbacks. The pool grows on the heap as callbacks are registered and
+ * is freed when the last one is removed, so an object with hundreds of settings and a few
+ * callbacks costs about a byte per setting. Lookups are constant time.
+ * @tparam Cb Callback type (`Delegate`).
+ * @tparam KEYS Number of settings.
+ * @tparam LIMIT Maximum number of callbacks registered at the same time.
+ */
+template <typename Cb, size_t KEYS, size_t LIMIT = KEYS>
+class CallbackTable {
+  public:
+  static_assert(KEYS < UINT16_MAX, "Too many settings");
+
+  CallbackTable() { _map.fill(NONE); }
+
+  /**
+   * @brief Set the callback of a setting, replacing the previous one.
+   * @param index Setting index.
+   * @param callback Callback. An empty one removes the entry.
+   * @param on_format Whether to invoke it on format operations.
+   * @retval `true` Set (or removed).
+   * @retval `false` `LIMIT` callbacks are already registered for other settings.
+   */
+  bool set(size_t index, const Cb& callback, bool on_format) {
+    if (!callback) {
+      remove(index);
+      return true;
+    }
+
+    if (_map[index] != NONE) {
+      Slot& slot     = _pool[_map[index]];
+      slot.callback  = callback;
+      slot.on_format = on_format;
+      return true;
+    }
+
+    if (_pool.size() >= LIMIT) return false;
+    _pool.push_back({callback, static_cast<Index>(index), on_format});
+    _map[index] = static_cast<Index>(_pool.size() - 1);
+    return true;
+  }
+
+  /// @brief Remove the callback of a setting, if any. The last pool entry takes its place.
+  void remove(size_t index) {
+    Index pos = _map[index];
+    if (pos == NONE) return;
+
+    _map[index] = NONE;
+    if (pos != _pool.size() - 1) {
+      _pool[pos]             = _pool.back();
+      _map[_pool[pos].index] = pos;
+    }
+    _pool.pop_back();
+
+    if (_pool.empty()) std::vector<Slot>().swap(_pool);
+  }
+
+  /**
+   * @brief Get the callback to invoke for a write of a setting.
+   * @param index Setting index.
+   * @param from_format Whether the write comes from a format operation.
+   * @return The callback, or an empty one.
+   */
+  Cb get(size_t index, bool from_format) const {
+    Index pos = _map[index];
+    if (pos == NONE) return Cb();
+
+    const Slot& slot = _pool[pos];
+    if (from_format && !slot.on_format) return Cb();
+    return slot.callback;
+  }
+
+  /// @brief Number of callbacks registered.
+  size_t size() const { return _pool.size(); }
+
+  private:
+  using Index = std::conditional_t<(KEYS <= UINT8_MAX), uint8_t, uint16_t>;
+
+  static constexpr Index NONE = std::numeric_limits<Index>::max(); // No callback
+
+  struct Slot {
+    Cb callback;
+    Index index; // Setting the callback belongs to
+    bool on_format;
+  };
+
+  std::array<Index, KEYS> _map; // Pool position of each setting's callback, or NONE
+  std::vector<Slot> _pool;
+};
+
+} // namespace Internal
+
+} // namespace NVS
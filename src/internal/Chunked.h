@@ -0,0 +1,106 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <nvs.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Types.h"
+
+/**
+ * @brief Size in bytes of the chunks `Option::Chunked` values are split into: the unit rewritten
+ * by a write, and the stack buffer of a partial chunk read. Define it before including the library,
+ * or as a build flag, to change it. Values keep the chunk size they were written with.
+ */
+#ifndef SETTINGS_CHUNK_SIZE
+#define SETTINGS_CHUNK_SIZE 512
+#endif
+
+/**
+ * @brief Maximum number of chunks of an `Option::Chunked` value, which caps its size to
+ * `SETTINGS_CHUNK_SIZE * SETTINGS_CHUNK_MAX` bytes (32 KB by default). Each chunk takes 4 bytes of
+ * the index, which writes hold on the stack. Define it before including the library, or as a build
+ * flag, to change it.
+ */
+#ifndef SETTINGS_CHUNK_MAX
+#define SETTINGS_CHUNK_MAX 64
+#endif
+
+namespace NVS {
+
+namespace Internal {
+
+/**
+ * @brief Storage of `ByteStream` values split into chunks, used by `Option::Chunked`.
+ *
+ * The key holds a small index blob, and each chunk of `SETTINGS_CHUNK_SIZE` bytes a blob of its
+ * own under a key derived from the CRC32 of the key (`~`, 8 and 3 hex digits), so that any key
+ * fits the 15-character limit:
+ *
+ * | Offset | Size      | Content                |
+ * | ------ | --------- | ---------------------- |
+ * | 0      | 4         | Magic (`CHK1`)         |
+ * | 4      | 4         | Value size in bytes    |
+ * | 8      | 2         | Chunk size in bytes    |
+ * | 10     | 2         | Number of chunks       |
+ * | 12     | 4 * count | CRC32 of each chunk    |
+ *
+ * A write only rewrites the chunks whose CRC changed, then the index, then erases the chunks past
+ * the new end. Before the first chunk is rewritten, the stored index is marked pending (magic
+ * `CHK0`): a write cut short by a reset reads as absent instead of as a mix of old and new data,
+ * and the next write rewrites every chunk. Every chunk read is also checked against its CRC. A
+ * plain blob stored under the key (before the option was enabled) is still read whole; the next
+ * write converts it.
+ */
+class ChunkedBlobPolicy {
+  public:
+  static constexpr size_t CHUNK_SIZE = SETTINGS_CHUNK_SIZE;
+  static constexpr size_t MAX_CHUNKS = SETTINGS_CHUNK_MAX;
+  static constexpr size_t MAX_SIZE   = CHUNK_SIZE * MAX_CHUNKS;
+
+  static_assert(CHUNK_SIZE > 0 && CHUNK_SIZE <= UINT16_MAX, "Invalid SETTINGS_CHUNK_SIZE");
+  static_assert(MAX_CHUNKS > 0 && MAX_CHUNKS <= 0xFFF, "SETTINGS_CHUNK_MAX must be 1 to 4095");
+
+  bool setValue(nvs_handle_t handle, const char* key, ByteStreamView value);
+  bool getValue(nvs_handle_t handle, const char* key, ByteStream& value);
+  bool getSize(nvs_handle_t handle, const char* key, size_t& size);
+
+  /**
+   * @brief Read part of a chunked value, touching only the chunks it spans.
+   * @param offset First byte to read.
+   * @param buf Destination buffer.
+   * @param size Number of bytes to read.
+   * @retval `true` Read.
+   * @retval `false` Key not found, not stored chunked, range past the end of the value, or a chunk
+   * failed its CRC check.
+   */
+  bool readRange(nvs_handle_t handle, const char* key, size_t offset, uint8_t* buf, size_t size);
+
+  /**
+   * @brief Overwrite part of a chunked value in place, without committing: chunks only partly
+   * covered are read back and patched, and only the chunks whose CRC changed are rewritten.
+   * @param offset First byte to overwrite.
+   * @param data New bytes. The range must lie within the stored value.
+   * @param changed Set to whether any chunk was rewritten.
+   * @retval `true` Written, or nothing changed.
+   * @retval `false` Key not found, not stored chunked, range past the end of the value, or NVS
+   * error.
+   */
+  bool writeRange(nvs_handle_t handle, const char* key, size_t offset, ByteStreamView data,
+                  bool& changed);
+
+  /// @brief Entries appended by the last `setValue()` or `writeRange()` (`Option::Wear`).
+  uint32_t lastEntries() const { return _last_entries; }
+
+  private:
+  uint32_t _last_entries = 0;
+};
+
+} // namespace Internal
+
+} // namespace NVS
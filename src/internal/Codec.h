@@ -0,0 +1,266 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef ARDUINO
+#include <Print.h>
+#include <Stream.h>
+#endif
+
+#ifndef ESP_PLATFORM
+#include <istream>
+#include <ostream>
+#endif
+
+#include "Types.h"
+
+/**
+ * @brief Size in characters of the stack buffer the streaming codecs (`NVS::writeHex()`,
+ * `NVS::readHex()`...) encode into and read through. A multiple of 12, so that it holds whole
+ * bytes in every format. Define it before including the library, or as a build flag, to change it.
+ */
+#ifndef SETTINGS_CODEC_CHUNK_SIZE
+#define SETTINGS_CODEC_CHUNK_SIZE 96
+#endif
+
+namespace NVS {
+
+/**
+ * @brief Incremental Base64 encoder (RFC 4648, padded): encodes a blob fed in chunks of any size,
+ * writing straight into caller buffers, without heap use. The concatenated outputs of `update()`
+ * and `finish()` equal `fromBase64ToStr()` of the whole blob.
+ *
+ * ```cpp
+ * NVS::Base64Encoder encoder;
+ * char out[NVS::Base64Encoder::maxOutput(64) + 1];
+ * size_t written;
+ * while (readChunk(chunk)) { // Up to 64 bytes
+ *   encoder.update(chunk, out, sizeof(out), written);
+ *   send(out, written);
+ * }
+ * encoder.finish(out, sizeof(out), written);
+ * send(out, written);
+ * ```
+ */
+class Base64Encoder {
+  public:
+  /**
+   * @brief Get the largest output of `update()` for a chunk, whatever was fed before.
+   * @param chunk_size Size of the chunk in bytes.
+   * @return Number of characters.
+   */
+  static constexpr size_t maxOutput(const size_t chunk_size) { return (chunk_size + 2) / 3 * 4; }
+
+  /**
+   * @brief Encode a chunk. Up to two trailing bytes are kept for the next call or `finish()`.
+   * @param chunk Bytes to encode.
+   * @param out Output buffer. Nothing is null-terminated.
+   * @param out_size Size of the output buffer, at least `maxOutput(chunk.size)` is always enough.
+   * @param written Set to the number of characters written.
+   * @retval `true` Encoded.
+   * @retval `false` Output buffer too small, or `chunk.data` is null: nothing was consumed.
+   */
+  bool update(const ByteStreamView chunk, char* out, const size_t out_size, size_t& written);
+
+  /**
+   * @brief Write the last, padded block and a null terminator, then start over.
+   * @param out Output buffer. 5 bytes are always enough.
+   * @param out_size Size of the output buffer.
+   * @param written Set to the number of characters written, without the null terminator.
+   * @retval `true` Done.
+   * @retval `false` Output buffer too small.
+   */
+  bool finish(char* out, const size_t out_size, size_t& written);
+
+  /// @brief Drop the bytes kept from the last chunk and start over.
+  void reset() { _pending_count = 0; }
+
+  private:
+  uint8_t _pending[2]    = {};
+  uint8_t _pending_count = 0;
+};
+
+/**
+ * @brief Destination of the streaming encoders. Adapters are provided for Arduino `Print`
+ * (`PrintSink`), `FILE*` (`FileSink`) and, on the host, `std::ostream` (`OStreamSink`).
+ */
+class Sink {
+  public:
+  /**
+   * @brief Write characters.
+   * @param data Characters to write. Not null-terminated.
+   * @param size Number of characters.
+   * @retval `true` All written.
+   * @retval `false` Write error: the encoder stops.
+   */
+  virtual bool write(const char* data, size_t size) = 0;
+
+  protected:
+  ~Sink() = default;
+};
+
+/**
+ * @brief Origin of the streaming decoders. Adapters are provided for Arduino `Stream`
+ * (`StreamSource`), `FILE*` (`FileSource`) and, on the host, `std::istream` (`IStreamSource`).
+ */
+class Source {
+  public:
+  /**
+   * @brief Read characters.
+   * @param buf Destination buffer.
+   * @param size Maximum number of characters.
+   * @return `size_t` Number of characters read, 0 at the end of the input.
+   */
+  virtual size_t read(char* buf, size_t size) = 0;
+
+  protected:
+  ~Source() = default;
+};
+
+#ifdef ARDUINO
+/// @brief Sink writing to an Arduino `Print` (e.g. `Serial`).
+class PrintSink : public Sink {
+  public:
+  explicit PrintSink(Print& print)
+      : _print(print) {}
+
+  bool write(const char* data, size_t size) override {
+    return _print.write(reinterpret_cast<const uint8_t*>(data), size) == size;
+  }
+
+  private:
+  Print& _print;
+};
+
+/// @brief Source reading from an Arduino `Stream` (e.g. `Serial`). Ends at the stream timeout.
+class StreamSource : public Source {
+  public:
+  explicit StreamSource(Stream& stream)
+      : _stream(stream) {}
+
+  size_t read(char* buf, size_t size) override { return _stream.readBytes(buf, size); }
+
+  private:
+  Stream& _stream;
+};
+#endif
+
+/// @brief Sink writing to a `FILE*` (e.g. `stdout`, or a file on SPIFFS/LittleFS under ESP-IDF).
+class FileSink : public Sink {
+  public:
+  explicit FileSink(FILE* file)
+      : _file(file) {}
+
+  bool write(const char* data, size_t size) override {
+    return fwrite(data, 1, size, _file) == size;
+  }
+
+  private:
+  FILE* _file;
+};
+
+/// @brief Source reading from a `FILE*`.
+class FileSource : public Source {
+  public:
+  explicit FileSource(FILE* file)
+      : _file(file) {}
+
+  size_t read(char* buf, size_t size) override { return fread(buf, 1, size, _file); }
+
+  private:
+  FILE* _file;
+};
+
+#ifndef ESP_PLATFORM
+/// @brief Sink writing to a `std::ostream` (host builds).
+class OStreamSink : public Sink {
+  public:
+  explicit OStreamSink(std::ostream& os)
+      : _os(os) {}
+
+  bool write(const char* data, size_t size) override {
+    return static_cast<bool>(_os.write(data, static_cast<std::streamsize>(size)));
+  }
+
+  private:
+  std::ostream& _os;
+};
+
+/// @brief Source reading from a `std::istream` (host builds).
+class IStreamSource : public Source {
+  public:
+  explicit IStreamSource(std::istream& is)
+      : _is(is) {}
+
+  size_t read(char* buf, size_t size) override {
+    _is.read(buf, static_cast<std::streamsize>(size));
+    return static_cast<size_t>(_is.gcount());
+  }
+
+  private:
+  std::istream& _is;
+};
+#endif
+
+/**
+ * @brief Write a `ByteStreamView` as hex to a sink, through a `SETTINGS_CODEC_CHUNK_SIZE` stack
+ * buffer: the output of `fromHexToStr()` without its null terminator, and without a buffer of
+ * `hexStrSize()` bytes.
+ *
+ * ```cpp
+ * NVS::PrintSink sink(Serial);
+ * NVS::writeHex(sink, blob, true);
+ * ```
+ * @param sink Destination.
+ * @param bs Bytes to encode.
+ * @param with_spaces Whether to separate the bytes with spaces.
+ * @retval `true` Written.
+ * @retval `false` `bs.data` is null, or the sink failed.
+ */
+bool writeHex(Sink& sink, const ByteStreamView bs, const bool with_spaces = false);
+
+/**
+ * @brief Write a `ByteStreamView` as Base64 (RFC 4648, padded) to a sink, through a
+ * `SETTINGS_CODEC_CHUNK_SIZE` stack buffer.
+ * @param sink Destination.
+ * @param bs Bytes to encode.
+ * @retval `true` Written.
+ * @retval `false` `bs.data` is null, or the sink failed.
+ */
+bool writeBase64(Sink& sink, const ByteStreamView bs);
+
+/**
+ * @brief Decode hex read from a source into a `ByteStream`, a `SETTINGS_CODEC_CHUNK_SIZE` chunk at
+ * a time, until the end of the source (e.g. the `Stream` timeout). Line breaks (`\r`, `\n`) are
+ * skipped, so wrapped input decodes whole: with `with_spaces`, a break between two bytes stands for
+ * their separator; without it, blanks are skipped too.
+ * @param source Origin.
+ * @param out Destination. `out.size` is set to the number of bytes decoded.
+ * @param with_spaces Whether the bytes are separated by spaces.
+ * @retval `true` Decoded.
+ * @retval `false` Invalid input, or it does not fit in `out.max_size`. `out.data` may have been
+ * written.
+ */
+bool readHex(Source& source, ByteStream& out, const bool with_spaces = false);
+
+/**
+ * @brief Decode Base64 (RFC 4648 alphabet, padding optional) read from a source into a
+ * `ByteStream`, a `SETTINGS_CODEC_CHUNK_SIZE` chunk at a time, until the end of the source. Line
+ * breaks and blanks are skipped, so wrapped (PEM-style, 64 or 76 columns) input decodes whole.
+ * @param source Origin.
+ * @param out Destination. `out.size` is set to the number of bytes decoded.
+ * @retval `true` Decoded.
+ * @retval `false` Invalid input, or it does not fit in `out.max_size`. `out.data` may have been
+ * written.
+ */
+bool readBase64(Source& source, ByteStream& out);
+
+} // namespace NVS
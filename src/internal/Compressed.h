@@ -0,0 +1,180 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <nvs.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Policy.h"
+#include "Types.h"
+
+/**
+ * @brief Size in bytes of the stack buffer `Option::Compressed` values are compressed into and read
+ * back through: a value is written only if it fits in this size, header included, or compresses
+ * into it. The compressor also takes a 1 KB hash table on the stack. Define it before including
+ * the library, or as a build flag, to change it.
+ */
+#ifndef SETTINGS_COMPRESS_BUFFER
+#define SETTINGS_COMPRESS_BUFFER 1024
+#endif
+
+namespace NVS {
+
+namespace Internal {
+
+/// @brief Size of the header of a compressed value.
+constexpr size_t LZ_HEADER_SIZE = 12;
+
+/**
+ * @brief Compress a buffer with the LZ77 codec of `Option::Compressed`: sequences of literals and
+ * matches of 4 or more bytes up to 64 KB back, in the LZ4 block layout (a token with both lengths,
+ * the literals, a 16-bit offset). Greedy, with a 512-entry hash table of the last position of each
+ * 4-byte prefix.
+ * @param src Input.
+ * @param size Input size, at most 65535 bytes.
+ * @param dst Output buffer.
+ * @param capacity Size of the output buffer. Compression stops once it is exceeded.
+ * @return `size_t` Compressed size, 0 if it does not fit in `capacity` or the input is too large.
+ */
+size_t lzCompress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity);
+
+/**
+ * @brief Decompress the output of `lzCompress()`. Every length and offset is checked, so corrupted
+ * input fails instead of reading or writing out of bounds.
+ * @param src Compressed input.
+ * @param size Compressed size.
+ * @param dst Output buffer.
+ * @param raw_size Exact decompressed size expected.
+ * @retval `true` Decompressed `raw_size` bytes.
+ * @retval `false` Corrupted input, or another decompressed size.
+ */
+bool lzDecompress(const uint8_t* src, size_t size, uint8_t* dst, size_t raw_size);
+
+/**
+ * @brief Store a value as a blob, compressed if that saves NVS entries, as is otherwise. Either way
+ * it starts with a header, so that no stored value can pass for a compressed one:
+ *
+ * | Offset | Size | Content                                      |
+ * | ------ | ---- | -------------------------------------------- |
+ * | 0      | 2    | Magic (`LZ`)                                 |
+ * | 2      | 1    | Format version (1)                           |
+ * | 3      | 1    | Method (0: compressed, 1: stored as is)      |
+ * | 4      | 4    | Raw size                                     |
+ * | 8      | 4    | CRC32 of the raw value                       |
+ * | 12     | ...  | `lzCompress()` output, or the raw value      |
+ *
+ * Nothing is allocated: a value that neither compresses into `SETTINGS_COMPRESS_BUFFER` nor fits
+ * in it as is is not written.
+ *
+ * @param entries Set to the entries appended.
+ * @retval `true` Written, without committing.
+ * @retval `false` Too large, or NVS error.
+ */
+bool writeCompressed(nvs_handle_t handle, const char* key, const uint8_t* data, size_t size,
+                     uint32_t& entries);
+
+/**
+ * @brief Read a value stored by `writeCompressed()`, decompressing it if needed. A blob without a
+ * valid header, or larger than `SETTINGS_COMPRESS_BUFFER`, was written before the option was
+ * enabled and is read as is; a large one costs a second lookup, straight into `out`.
+ * @param out Output buffer, or `nullptr` to only get the size.
+ * @param max_size Size of the output buffer.
+ * @param size Set to the raw size.
+ * @return `esp_err_t` `ESP_OK`, `ESP_ERR_NVS_NOT_FOUND` if no blob is stored under the key,
+ * `ESP_ERR_NVS_INVALID_LENGTH` if `out` is too small, `ESP_ERR_INVALID_CRC` if a compressed value
+ * is corrupted, or another NVS error.
+ */
+esp_err_t readCompressed(nvs_handle_t handle, const char* key, uint8_t* out, size_t max_size,
+                         size_t& size);
+
+/**
+ * @brief Policy of `Option::Compressed`: values are stored through `writeCompressed()`, always as
+ * blobs (strings with their null terminator).
+ * @tparam T `Str` or `ByteStream`.
+ */
+template <typename T>
+class CompressedPolicy;
+
+template <>
+class CompressedPolicy<Str> {
+  public:
+  bool setValue(nvs_handle_t handle, const char* key, StrView value) {
+    if (!value.data) return false;
+    return writeCompressed(handle, key, reinterpret_cast<const uint8_t*>(value.data),
+                           strlen(value.data) + 1, _last_entries);
+  }
+
+  bool getValue(nvs_handle_t handle, const char* key, Str& value) {
+    if (!value.data || value.max_size == 0) return false;
+
+    size_t size;
+    esp_err_t err = readCompressed(handle, key, reinterpret_cast<uint8_t*>(value.data),
+                                   value.max_size, size);
+    if (err == ESP_ERR_NVS_NOT_FOUND) return StringPolicy().getValue(handle, key, value);
+    return err == ESP_OK && size > 0 && value.data[size - 1] == '\0';
+  }
+
+  bool getSize(nvs_handle_t handle, const char* key, size_t& size) {
+    esp_err_t err = readCompressed(handle, key, nullptr, 0, size);
+    if (err == ESP_ERR_NVS_NOT_FOUND) return StringPolicy().getSize(handle, key, size);
+    return err == ESP_OK;
+  }
+
+  /**
+   * @brief Erase a string stored under the key before the option was enabled: it is of another
+   * NVS type, so a blob written under the key would not replace it. `Settings` calls it before the
+   * first write of each key after `begin()`.
+   * @retval `true` No such string is left.
+   * @retval `false` NVS error.
+   */
+  bool dropLegacy(nvs_handle_t handle, const char* key) {
+    size_t length;
+    esp_err_t err = nvs_get_str(handle, key, nullptr, &length);
+    if (err == ESP_OK) return nvs_erase_key(handle, key) == ESP_OK;
+    return err == ESP_ERR_NVS_NOT_FOUND || err == ESP_ERR_NVS_TYPE_MISMATCH;
+  }
+
+  /// @brief Entries appended by the last `setValue()` (`Option::Wear`).
+  uint32_t lastEntries() const { return _last_entries; }
+
+  private:
+  uint32_t _last_entries = 0;
+};
+
+template <>
+class CompressedPolicy<ByteStream> {
+  public:
+  bool setValue(nvs_handle_t handle, const char* key, ByteStreamView value) {
+    if (!value.data && value.size > 0) return false;
+    return writeCompressed(handle, key, value.data, value.size, _last_entries);
+  }
+
+  bool getValue(nvs_handle_t handle, const char* key, ByteStream& value) {
+    if (!value.data || value.max_size == 0) return false;
+
+    size_t size;
+    if (readCompressed(handle, key, value.data, value.max_size, size) != ESP_OK) return false;
+    value.size = size;
+    return true;
+  }
+
+  bool getSize(nvs_handle_t handle, const char* key, size_t& size) {
+    return readCompressed(handle, key, nullptr, 0, size) == ESP_OK;
+  }
+
+  /// @brief Entries appended by the last `setValue()` (`Option::Wear`).
+  uint32_t lastEntries() const { return _last_entries; }
+
+  private:
+  uint32_t _last_entries = 0;
+};
+
+} // namespace Internal
+
+} // namespace NVS
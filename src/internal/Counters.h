@@ -0,0 +1,342 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <esp_timer.h>
+#include <initializer_list>
+#include <mutex>
+#include <nvs.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Record.h"
+#include "Setting.h"
+
+/**
+ * @brief Default flush interval of `NVS::Counters` objects in milliseconds, 0 to flush only on
+ * deltas and explicit flushes. Define it before including the library, or as a build flag, to
+ * change it.
+ */
+#ifndef SETTINGS_COUNTER_FLUSH_MS
+#define SETTINGS_COUNTER_FLUSH_MS 60000
+#endif
+
+namespace NVS {
+
+/// @brief Update and flush counters of an `NVS::Counters` object.
+struct CounterStats {
+  uint32_t updates  = 0; // add() and set() calls
+  uint32_t flushes  = 0; // Records written to NVS and committed
+  uint32_t failures = 0; // Failed flushes, retried by the next trigger
+};
+
+namespace Internal {
+
+/// @brief NVS key holding the values of an `NVS::Counters` object.
+constexpr const char* COUNTERS_KEY = "_counters";
+
+} // namespace Internal
+
+/**
+ * @brief Persistent counters updated often (boot count, operating hours, energy...). Updates
+ * accumulate in RAM and reach NVS only when flushed, so a counter bumped every second does not cost
+ * a flash write every second.
+ *
+ * All counters of an object are stored as one record blob under `Internal::COUNTERS_KEY` (the
+ * CRC-checked layout of `Internal::RecordImage`), read once by `begin()`. A flush writes the record
+ * and commits it. It happens when:
+ * - a counter moved by its flush delta since the last flush (`setFlushDelta()`),
+ * - the flush interval elapsed since the last flush (`setFlushInterval()`), checked by `add()` and
+ *   `poll()`,
+ * - `set()`, `formatAll()`, `flush()` or `end()` is called.
+ *
+ * A reset loses at most the updates since the last flush. NVS appends every write to a fresh entry
+ * and erases its pages in turn, so successive flushes already land in different places: what wears
+ * the flash is the number of writes, which flushing cuts down. Safe to share between tasks.
+ *
+ * @tparam ENUM Enum class whose enumerators index into the counter list.
+ * @tparam N Number of counters (use `SETTINGS_COUNT` macro).
+ */
+template <typename ENUM, size_t N>
+class Counters {
+  public:
+  /// @brief Key, hint, initial value, and whether `formatAll()` resets the counter.
+  using Struct = Internal::Setting<uint64_t>;
+
+  /**
+   * @brief Construct a Counters object. Call `begin()` before any update.
+   * @param ns_name NVS namespace name (max 15 characters). Use a namespace of its own.
+   * @param list Initializer list of Setting structs, one per enum entry.
+   * @param partition_name Optional NVS partition name, initialized with `NVS::init()`. If
+   * `nullptr`, the default partition is used.
+   */
+  Counters(const char* ns_name, std::initializer_list<Struct> list,
+           const char* partition_name = nullptr)
+      : _ns_name(ns_name)
+      , _part_name(partition_name) {
+    std::copy_n(list.begin(), N, _list.begin());
+    for (size_t i = 0; i < N; i++)
+      _values[i] = _list[i].default_value;
+    _flushed = _values;
+    _deltas.fill(0);
+  }
+
+  ~Counters() { end(); }
+
+  Counters(const Counters&)            = delete;
+  Counters& operator=(const Counters&) = delete;
+
+  /* ----------------------------------------- Lifecycle ---------------------------------------- */
+
+  /**
+   * @brief Open the NVS namespace handle and load the counters with a single read. Counters never
+   * stored, or stored in a record that fails its CRC check, start at their initial value.
+   * @retval `true` Opened.
+   * @retval `false` Operation failed (e.g. partition not initialized).
+   */
+  bool begin() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_is_open) return true;
+
+    const char* part_name = _part_name ? _part_name : NVS_DEFAULT_PART_NAME;
+    if (nvs_open_from_partition(part_name, _ns_name, NVS_READWRITE, &_handle) != ESP_OK) {
+      return false;
+    }
+
+    if (!_image.load(_handle, Internal::COUNTERS_KEY)) {
+      nvs_close(_handle);
+      return false;
+    }
+
+    for (size_t i = 0; i < N; i++) {
+      if (!_image.get(i, _values[i])) _values[i] = _list[i].default_value;
+    }
+    _flushed       = _values;
+    _dirty         = false;
+    _last_flush_us = esp_timer_get_time();
+    _is_open       = true;
+    return true;
+  }
+
+  /// @brief Flush pending updates and close the NVS namespace handle.
+  void end() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_is_open) return;
+    if (_dirty) _flush();
+    nvs_close(_handle);
+    _is_open = false;
+  }
+
+  bool isOpen() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _is_open;
+  }
+
+  const char* getNamespace() const { return _ns_name; }
+  const char* getPartition() const { return _part_name; }
+  const char* getKey(ENUM counter) const { return _list[static_cast<size_t>(counter)].key; }
+  const char* getHint(ENUM counter) const { return _list[static_cast<size_t>(counter)].hint; }
+
+  /* ------------------------------------------ Updates ----------------------------------------- */
+
+  /**
+   * @brief Add to a counter in RAM, flushing if its delta or the flush interval is reached.
+   * Counters wrap around on overflow.
+   * @param counter Counter.
+   * @param delta Amount to add.
+   * @retval `true` Counted. A flush that fails is counted in `CounterStats::failures` and retried
+   * by the next trigger.
+   * @retval `false` Handle not open: nothing counted.
+   */
+  bool add(ENUM counter, uint64_t delta = 1) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_is_open) return false;
+
+    size_t index    = static_cast<size_t>(counter);
+    _values[index] += delta;
+    _dirty          = _dirty || delta != 0;
+    _stats.updates++;
+
+    bool delta_due = _deltas[index] > 0 && _values[index] - _flushed[index] >= _deltas[index];
+    if (_dirty && (delta_due || _intervalDue())) _flush();
+    return true;
+  }
+
+  /**
+   * @brief Set a counter (e.g. reset an energy accumulator) and flush at once.
+   * @param counter Counter.
+   * @param value New value.
+   * @retval `true` Set and flushed.
+   * @retval `false` Handle not open, or flush failed (the value is kept in RAM and retried).
+   */
+  bool set(ENUM counter, uint64_t value) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_is_open) return false;
+
+    _values[static_cast<size_t>(counter)] = value;
+    _dirty                                = true;
+    _stats.updates++;
+    return _flush();
+  }
+
+  /**
+   * @brief Reset the formattable counters to their initial value and flush at once.
+   * @retval `true` Reset and flushed.
+   * @retval `false` Handle not open, or flush failed.
+   */
+  bool formatAll() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_is_open) return false;
+
+    for (size_t i = 0; i < N; i++) {
+      if (_list[i].formattable) _values[i] = _list[i].default_value;
+    }
+    _dirty = true;
+    return _flush();
+  }
+
+  /**
+   * @brief Get the current value of a counter, flushed or not.
+   * @param counter Counter.
+   * @return `uint64_t` Value. Before `begin()`, the initial value.
+   */
+  uint64_t get(ENUM counter) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _values[static_cast<size_t>(counter)];
+  }
+
+  /**
+   * @brief Get the value of a counter as last flushed, the one a reset would come back to.
+   * @param counter Counter.
+   * @return `uint64_t` Value.
+   */
+  uint64_t getFlushed(ENUM counter) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _flushed[static_cast<size_t>(counter)];
+  }
+
+  /* ------------------------------------------ Flushing ---------------------------------------- */
+
+  /**
+   * @brief Flush once a counter moved by `delta` since the last flush.
+   * @param counter Counter.
+   * @param delta Amount, 0 to disable.
+   */
+  void setFlushDelta(ENUM counter, uint64_t delta) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _deltas[static_cast<size_t>(counter)] = delta;
+  }
+
+  /// @brief Set the flush delta of every counter. See `setFlushDelta(ENUM, uint64_t)`.
+  void setFlushDelta(uint64_t delta) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _deltas.fill(delta);
+  }
+
+  /**
+   * @brief Flush pending updates once `interval_ms` elapsed since the last flush. Checked by
+   * `add()` and `poll()`.
+   * @param interval_ms Interval in milliseconds, 0 to disable.
+   */
+  void setFlushInterval(uint32_t interval_ms) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _interval_ms = interval_ms;
+  }
+
+  /**
+   * @brief Flush pending updates if the flush interval elapsed. Call it periodically (e.g. from
+   * `loop()`) so that updates followed by a quiet period still reach NVS.
+   * @retval `true` Nothing due, or flushed.
+   * @retval `false` Flush failed.
+   */
+  bool poll() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_is_open || !_dirty || !_intervalDue()) return true;
+    return _flush();
+  }
+
+  /**
+   * @brief Flush pending updates now.
+   * @retval `true` Flushed, or nothing pending.
+   * @retval `false` Handle not open, or flush failed.
+   */
+  bool flush() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_is_open) return false;
+    return !_dirty || _flush();
+  }
+
+  /**
+   * @brief Check whether updates are waiting for a flush.
+   * @retval `true` Pending updates.
+   * @retval `false` Everything flushed.
+   */
+  bool isDirty() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _dirty;
+  }
+
+  /**
+   * @brief Get the update and flush counters.
+   * @param stats Output parameter for the counters.
+   */
+  void getStats(CounterStats& stats) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    stats = _stats;
+  }
+
+  /// @brief Reset the update and flush counters.
+  void resetStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats = CounterStats();
+  }
+
+  private:
+  const char* _ns_name;
+  const char* _part_name;
+  nvs_handle_t _handle = 0;
+  bool _is_open        = false;
+  bool _dirty          = false;
+
+  std::array<Struct, N> _list;
+  std::array<uint64_t, N> _values;  // Current values
+  std::array<uint64_t, N> _flushed; // Values as last flushed
+  std::array<uint64_t, N> _deltas;  // Flush deltas, 0 for none
+  Internal::RecordImage<uint64_t, N> _image;
+
+  uint32_t _interval_ms  = SETTINGS_COUNTER_FLUSH_MS;
+  int64_t _last_flush_us = 0; // Last flush, or its last attempt
+  CounterStats _stats;
+
+  mutable std::mutex _mutex;
+
+  bool _intervalDue() const {
+    int64_t elapsed_us = esp_timer_get_time() - _last_flush_us;
+    return _interval_ms > 0 && elapsed_us >= int64_t(_interval_ms) * 1000;
+  }
+
+  bool _flush() {
+    _last_flush_us = esp_timer_get_time();
+
+    for (size_t i = 0; i < N; i++)
+      _image.set(i, _values[i]);
+
+    if (!_image.store(_handle, Internal::COUNTERS_KEY) || nvs_commit(_handle) != ESP_OK) {
+      _stats.failures++;
+      return false;
+    }
+
+    _flushed = _values;
+    _dirty   = false;
+    _stats.flushes++;
+    return true;
+  }
+};
+
+} // namespace NVS
@@ -6,9 +6,10 @@
 
 #pragma once
 
-#include <functional>
 #include <stddef.h>
 
+#include "Callback.h"
+#include "Metrics.h"
 #include "Types.h"
 
 namespace NVS {
@@ -19,8 +20,8 @@ namespace NVS {
  */
 class ISettings {
   public:
-  using GlobalOnChangeCb = std::function<void(const char* key, const Type type, const size_t index,
-                                              const void* updated_value)>;
+  using GlobalOnChangeCb = Internal::Delegate<void(const char* key, const Type type,
+                                                   const size_t index, const void* updated_value)>;
 
   /**
    * @brief Open the NVS namespace handle. Must be called after `NVS::init()`.
@@ -40,6 +41,12 @@ class ISettings {
    */
   virtual const char* getNamespace() const = 0;
 
+  /**
+   * @brief Get the NVS partition name used by this Settings object.
+   * @return Partition name, or `nullptr` for the default partition.
+   */
+  virtual const char* getPartition() const = 0;
+
   /**
    * @brief Check whether the NVS handle is currently open.
    * @retval `true` Handle is open.
@@ -103,13 +110,13 @@ class ISettings {
   }
 
   /**
-   * @brief Write a new value via untyped pointer.
+   * @brief Write a new value via untyped pointer, or stage it if a transaction is in progress.
    * @param index Index in the list.
    * @param value Pointer to the new value.
-   * @retval `true` Written successfully.
-   * @retval `false` Handle not open, index out of bounds, or NVS write error.
+   * @return `WriteResult`: `Written`, `Unchanged` (`Option::ElideWrites`), `Staged`, or `Failed`
+   * if the handle is not open, the index is out of bounds, or NVS returned an error.
    */
-  virtual bool setValuePtr(size_t index, const void* value) = 0;
+  virtual WriteResult setValuePtr(size_t index, const void* value) = 0;
 
   /**
    * @brief Read the current NVS value into a caller-provided buffer via untyped pointer.
@@ -132,13 +139,61 @@ class ISettings {
    */
   virtual bool getValuePtrOrDefault(size_t index, void* value, size_t size) = 0;
 
+  /**
+   * @brief Get the size of the value stored in NVS, without reading it. Use it to size the buffer
+   * of a `Str` or `ByteStream` read.
+   * @param index Index in the list.
+   * @param size Set to the size in bytes: string length including the null terminator, blob size,
+   * or `sizeof(T)` for scalars.
+   * @retval `true` Key found in NVS.
+   * @retval `false` Handle not open, index out of bounds, or key not found.
+   */
+  virtual bool getValueSize(size_t index, size_t& size) = 0;
+
+  /**
+   * @brief Read every value into a caller-provided array, with fallback to the default value for
+   * keys not found in NVS. The namespace is scanned once to learn which keys exist, so absent keys
+   * cost no NVS lookup.
+   * @param values Destination array of `getSize()` values of the object's type (`Str` and
+   * `ByteStream` entries must point to caller-owned buffers).
+   * @param size Size of the destination array in bytes.
+   * @param found If not null, set to the number of values read from NVS (the others are defaults).
+   * @retval `true` Every value read from NVS or set to its default.
+   * @retval `false` Handle not open, array too small, or NVS error.
+   */
+  virtual bool snapshotPtr(void* values, size_t size, size_t* found = nullptr) = 0;
+
+  /**
+   * @brief Get the operation counters and latency histograms of the object (`Option::Metrics`).
+   * @param metrics Set to the metrics since construction or the last `resetMetrics()`.
+   * @retval `true` Metrics copied.
+   * @retval `false` The object was created without `Option::Metrics`.
+   */
+  virtual bool getMetrics(Metrics& metrics) const = 0;
+
+  /**
+   * @brief Get the operation counters of a single key (`Option::Metrics`).
+   * @param index Index in the list.
+   * @param metrics Set to the counters of the key.
+   * @retval `true` Counters copied.
+   * @retval `false` Created without `Option::Metrics`, or index out of bounds.
+   */
+  virtual bool getKeyMetrics(size_t index, KeyMetrics& metrics) const = 0;
+
+  /**
+   * @brief Reset every counter and histogram of the object (`Option::Metrics`).
+   */
+  virtual void resetMetrics() = 0;
+
   /**
    * @brief Register a callback that fires on every value change across this object.
-   * @param callback Callback function.
+   * @param callback Callback: a function pointer, or a lambda capturing at most two pointers.
    * @param callable_on_format Whether to invoke the callback when a format operation writes a
    * value.
+   * @retval `true` Registered.
+   * @retval `false` The object was created with `Option::NoCallbacks`.
    */
-  virtual void setGlobalOnChangeCallback(GlobalOnChangeCb callback, bool callable_on_format) = 0;
+  virtual bool setGlobalOnChangeCallback(GlobalOnChangeCb callback, bool callable_on_format) = 0;
 
   /**
    * @brief Remove the global change callback.
@@ -166,17 +221,51 @@ class ISettings {
    * @brief Write the default value back to NVS for a single setting.
    * @param index Index in the list.
    * @param force Ignore the formattable flag and write regardless.
-   * @retval `true` Written successfully.
-   * @retval `false` Not formattable (without force), out of bounds, or NVS error.
+   * @return `WriteResult`: `Written`, `Unchanged` (`Option::ElideWrites`), `Staged`, or `Failed`
+   * if not formattable (without force), out of bounds, or NVS error.
    */
-  virtual bool format(size_t index, bool force = false) = 0;
+  virtual WriteResult format(size_t index, bool force = false) = 0;
 
   /**
-   * @brief Write the default value back to NVS for all settings.
+   * @brief Write the default value back to NVS for all settings, with a single commit. Inside a
+   * transaction, the defaults are staged and failures are reported by `commit()`. With
+   * `Option::ElideWrites`, only entries that differ from their default are rewritten.
    * @param force Ignore the formattable flag for all entries.
    * @return `size_t` Number of entries that failed to write.
    */
   virtual size_t formatAll(bool force = false) = 0;
+
+  /**
+   * @brief Start a transaction. Until `commit()` or `abort()`, writes (`setValue()`, `format()`,
+   * `formatAll()`) are staged in RAM instead of being written to NVS, and reads keep returning the
+   * committed values.
+   * @note For `Str` and `ByteStream`, the data passed to a staged write must stay valid until the
+   * transaction ends.
+   * @retval `true` Transaction started.
+   * @retval `false` Handle not open, a transaction is already in progress, or the object was
+   * created without `Option::Transactions`.
+   */
+  virtual bool beginTransaction() = 0;
+
+  /**
+   * @brief Write all staged values to NVS with a single `nvs_commit()`, then fire the change
+   * callbacks once per written key.
+   * @retval `true` All staged values written and committed.
+   * @retval `false` No transaction in progress, or at least one write failed.
+   */
+  virtual bool commit() = 0;
+
+  /**
+   * @brief Discard all staged values and end the transaction. No callbacks fire.
+   */
+  virtual void abort() = 0;
+
+  /**
+   * @brief Check whether a transaction is in progress.
+   * @retval `true` Transaction in progress.
+   * @retval `false` Otherwise.
+   */
+  virtual bool inTransaction() const = 0;
 };
 
 } // namespace NVS
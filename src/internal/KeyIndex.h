@@ -0,0 +1,115 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <array>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+namespace NVS {
+
+namespace Internal {
+
+/**
+ * @brief FNV-1a hash of a null-terminated key. `constexpr`, so keys known at compile time can be
+ * hashed at compile time.
+ * @param key Null-terminated key.
+ * @param hash Hash to continue from, to hash several strings as if they were concatenated.
+ * @return `uint32_t` Hash.
+ */
+constexpr uint32_t hashKey(const char* key, uint32_t hash = 2166136261u) {
+  while (*key) {
+    hash ^= static_cast<uint8_t>(*key++);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/// @brief Smallest power of two greater than or equal to `n`.
+constexpr size_t nextPowerOfTwo(size_t n) {
+  size_t p = 1;
+  while (p < n)
+    p <<= 1;
+  return p;
+}
+
+/**
+ * @brief Open-addressing hash index from key string to position in a fixed list of N keys.
+ *
+ * The table has at least twice as many slots as keys, so a lookup is one hash, about one probe and
+ * a single `strcmp()` on the matching entry: the full hash of every key is kept and compared first.
+ * With duplicate keys, the first one in the list wins, as with a linear scan.
+ *
+ * @tparam N Number of keys.
+ */
+template <size_t N>
+class KeyIndex {
+  public:
+  static constexpr size_t SLOTS = nextPowerOfTwo(N * 2 < 4 ? 4 : N * 2);
+
+  /**
+   * @brief (Re)build the index.
+   * @param list N entries with a `key` member. Keys must stay valid while the index is used.
+   */
+  template <typename LIST>
+  void build(const LIST& list) {
+    _slots.fill(0);
+
+    for (size_t i = 0; i < N; i++) {
+      const char* key = list[i].key;
+      _hashes[i]      = key ? hashKey(key) : 0;
+      if (!key) continue;
+
+      size_t slot = _hashes[i] & (SLOTS - 1);
+      while (_slots[slot] != 0)
+        slot = (slot + 1) & (SLOTS - 1);
+
+      _slots[slot] = static_cast<Slot>(i + 1);
+    }
+  }
+
+  /**
+   * @brief Look a key up.
+   * @param list Same entries the index was built with.
+   * @param key Key to look for.
+   * @param index_found Set to the position of the key if found.
+   * @retval `true` Found.
+   * @retval `false` Not found.
+   */
+  template <typename LIST>
+  bool find(const LIST& list, const char* key, size_t& index_found) const {
+    if (!key) return false;
+
+    uint32_t hash = hashKey(key);
+    size_t slot   = hash & (SLOTS - 1);
+
+    // Load factor <= 0.5: there is always an empty slot to stop at
+    while (_slots[slot] != 0) {
+      size_t i = _slots[slot] - 1;
+      if (_hashes[i] == hash && strcmp(list[i].key, key) == 0) {
+        index_found = i;
+        return true;
+      }
+      slot = (slot + 1) & (SLOTS - 1);
+    }
+
+    return false;
+  }
+
+  private:
+  // Entry index + 1, 0 for an empty slot
+  using Slot = std::conditional_t<(N <= UINT8_MAX), uint8_t, uint16_t>;
+
+  std::array<Slot, SLOTS> _slots{};
+  std::array<uint32_t, N> _hashes{};
+};
+
+} // namespace Internal
+
+} // namespace NVS
@@ -0,0 +1,225 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <initializer_list>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace NVS {
+
+class ISettings;
+
+/**
+ * @brief Latency histogram with log2 buckets: bucket 0 counts operations under 1 us, bucket `b`
+ * those of [2^(b-1), 2^b) us, and the last bucket everything from 2^(BUCKETS-2) us (about 0.5 s).
+ */
+struct LatencyHistogram {
+  static constexpr size_t BUCKETS = 21;
+
+  uint32_t buckets[BUCKETS] = {};
+  uint32_t count            = 0; // Operations timed
+  uint64_t total_us         = 0; // Sum of their durations
+  uint32_t max_us           = 0; // Longest one
+
+  /**
+   * @brief Get the bucket of a duration.
+   * @param us Duration in microseconds.
+   * @return `size_t` Bucket index.
+   */
+  static size_t bucketOf(uint32_t us) {
+    size_t bucket = 0;
+    while (us > 0 && bucket < BUCKETS - 1) {
+      us >>= 1;
+      bucket++;
+    }
+    return bucket;
+  }
+
+  /**
+   * @brief Get an upper bound of a percentile: the end of the bucket holding it.
+   * @param percent Percentile, 0 to 100.
+   * @return `uint32_t` Microseconds, or 0 if nothing was timed. `max_us` for the last bucket.
+   */
+  uint32_t percentile(uint8_t percent) const {
+    if (count == 0) return 0;
+
+    uint64_t rank = (static_cast<uint64_t>(count) * percent + 99) / 100;
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t b = 0; b < BUCKETS - 1; b++) {
+      seen += buckets[b];
+      if (seen >= rank) return static_cast<uint32_t>(1u << b);
+    }
+    return max_us;
+  }
+};
+
+/// @brief Operation counters and latencies of a Settings object created with `Option::Metrics`.
+struct Metrics {
+  uint32_t reads     = 0; // Values read (getValue(), getValues(), snapshot()...)
+  uint32_t misses    = 0; // Reads of keys not in NVS, answered with the default value
+  uint32_t writes    = 0; // setValue() and format() calls
+  uint32_t unchanged = 0; // Writes skipped as equal to the stored value (`Option::ElideWrites`)
+  uint32_t commits   = 0; // nvs_commit() calls
+  uint32_t failures  = 0; // Failed writes and commits
+
+  LatencyHistogram get;    // Single-value reads
+  LatencyHistogram set;    // setValue() and format(), including their commit
+  LatencyHistogram commit; // nvs_commit() alone
+};
+
+/// @brief Operation counters of a single key (`Option::Metrics`).
+struct KeyMetrics {
+  uint32_t reads    = 0;
+  uint32_t misses   = 0;
+  uint32_t writes   = 0;
+  uint32_t failures = 0;
+};
+
+/**
+ * @brief Write the metrics of a Settings object as compact text, e.g. to print over Serial: one
+ * line of counters, one line per histogram, then one line per key that was used, busiest first:
+ * ```
+ * net r=120 m=3 w=41 u=2 c=39 f=0
+ *  get n=120 avg=4 p50=4 p99=16 max=22 us
+ *  set n=41 avg=2210 p50=4096 p99=8192 max=5012 us
+ *  commit n=39 avg=1980 p50=2048 p99=8192 max=4870 us
+ *  ssid r=100 m=0 w=1 f=0
+ * ```
+ * @param settings Settings object.
+ * @param buf Destination buffer. Truncated lines are dropped whole.
+ * @param size Size of the buffer in bytes.
+ * @param max_keys Maximum number of key lines.
+ * @return `size_t` Length of the text written (without null terminator), 0 if the object was not
+ * created with `Option::Metrics` or the buffer is too small.
+ */
+size_t formatMetrics(ISettings& settings, char* buf, size_t size, size_t max_keys = 8);
+
+namespace Internal {
+
+/// @brief Histogram updated from several tasks at once.
+class AtomicHistogram {
+  public:
+  void add(uint32_t us) {
+    _buckets[LatencyHistogram::bucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _total_us.fetch_add(us, std::memory_order_relaxed);
+
+    uint32_t max = _max_us.load(std::memory_order_relaxed);
+    while (us > max && !_max_us.compare_exchange_weak(max, us, std::memory_order_relaxed)) {
+    }
+  }
+
+  void copyTo(LatencyHistogram& out) const {
+    for (size_t b = 0; b < LatencyHistogram::BUCKETS; b++)
+      out.buckets[b] = _buckets[b].load(std::memory_order_relaxed);
+    out.count    = _count.load(std::memory_order_relaxed);
+    out.total_us = _total_us.load(std::memory_order_relaxed);
+    out.max_us   = _max_us.load(std::memory_order_relaxed);
+  }
+
+  void reset() {
+    for (auto& bucket : _buckets)
+      bucket.store(0, std::memory_order_relaxed);
+    _count.store(0, std::memory_order_relaxed);
+    _total_us.store(0, std::memory_order_relaxed);
+    _max_us.store(0, std::memory_order_relaxed);
+  }
+
+  private:
+  std::array<std::atomic<uint32_t>, LatencyHistogram::BUCKETS> _buckets{};
+  std::atomic<uint32_t> _count{0};
+  std::atomic<uint32_t> _total_us{0}; // Wraps after about 71 minutes of operations
+  std::atomic<uint32_t> _max_us{0};
+};
+
+/**
+ * @brief Counters and histograms of a Settings object with `Option::Metrics`. Relaxed atomics:
+ * updated without locks from readers, writers and the background writer.
+ * @tparam N Number of settings.
+ */
+template <size_t N>
+class MetricsStore {
+  public:
+  void read(size_t index, bool found) {
+    _add(_reads, _keys[index].reads);
+    if (!found) _add(_misses, _keys[index].misses);
+  }
+
+  void write(size_t index) { _add(_writes, _keys[index].writes); }
+  void unchanged() { _unchanged.fetch_add(1, std::memory_order_relaxed); }
+  void commit() { _commits.fetch_add(1, std::memory_order_relaxed); }
+  void failure() { _failures.fetch_add(1, std::memory_order_relaxed); }
+  void failure(size_t index) { _add(_failures, _keys[index].failures); }
+
+  AtomicHistogram get;
+  AtomicHistogram set;
+  AtomicHistogram commit_time;
+
+  void copyTo(Metrics& out) const {
+    out.reads     = _reads.load(std::memory_order_relaxed);
+    out.misses    = _misses.load(std::memory_order_relaxed);
+    out.writes    = _writes.load(std::memory_order_relaxed);
+    out.unchanged = _unchanged.load(std::memory_order_relaxed);
+    out.commits   = _commits.load(std::memory_order_relaxed);
+    out.failures  = _failures.load(std::memory_order_relaxed);
+    get.copyTo(out.get);
+    set.copyTo(out.set);
+    commit_time.copyTo(out.commit);
+  }
+
+  void copyTo(size_t index, KeyMetrics& out) const {
+    const Key& key = _keys[index];
+    out.reads      = key.reads.load(std::memory_order_relaxed);
+    out.misses     = key.misses.load(std::memory_order_relaxed);
+    out.writes     = key.writes.load(std::memory_order_relaxed);
+    out.failures   = key.failures.load(std::memory_order_relaxed);
+  }
+
+  void reset() {
+    for (auto* counter : {&_reads, &_misses, &_writes, &_unchanged, &_commits, &_failures})
+      counter->store(0, std::memory_order_relaxed);
+
+    for (Key& key : _keys) {
+      for (auto* counter : {&key.reads, &key.misses, &key.writes, &key.failures})
+        counter->store(0, std::memory_order_relaxed);
+    }
+
+    get.reset();
+    set.reset();
+    commit_time.reset();
+  }
+
+  private:
+  struct Key {
+    std::atomic<uint32_t> reads{0};
+    std::atomic<uint32_t> misses{0};
+    std::atomic<uint32_t> writes{0};
+    std::atomic<uint32_t> failures{0};
+  };
+
+  std::atomic<uint32_t> _reads{0};
+  std::atomic<uint32_t> _misses{0};
+  std::atomic<uint32_t> _writes{0};
+  std::atomic<uint32_t> _unchanged{0};
+  std::atomic<uint32_t> _commits{0};
+  std::atomic<uint32_t> _failures{0};
+  std::array<Key, N> _keys;
+
+  static void _add(std::atomic<uint32_t>& total, std::atomic<uint32_t>& key) {
+    total.fetch_add(1, std::memory_order_relaxed);
+    key.fetch_add(1, std::memory_order_relaxed);
+  }
+};
+
+} // namespace Internal
+
+} // namespace NVS
@@ -0,0 +1,89 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Number of `Option::DeferCallbacks` objects whose change events wait in the lock-free queue
+ * (a power of two). Further objects wait in an overflow list guarded by a mutex, delivered by the
+ * same `NVS::poll()`. Define it before including the library, or as a build flag, to change it.
+ */
+#ifndef SETTINGS_NOTIFY_QUEUE_LENGTH
+#define SETTINGS_NOTIFY_QUEUE_LENGTH 16
+#endif
+
+namespace NVS {
+
+/// @brief Configuration of the notification task used by `Option::DeferCallbacks` objects.
+struct NotifierConfig {
+  uint32_t stack_size = 4096; // Notification task stack in bytes (ESP32 only)
+  uint32_t priority   = 1;    // Notification task priority (ESP32 only)
+  int core            = -1;   // Core to pin the notification task to, -1 for any (ESP32 only)
+};
+
+/**
+ * @brief Start the notification task: a FreeRTOS task on the ESP32, a thread on the host. It
+ * delivers the change events of `Option::DeferCallbacks` objects as soon as they are queued.
+ * Without it, events wait for `NVS::poll()`.
+ * @param config Notification task configuration. Ignored if the task is already running.
+ * @retval `true` Started, or already running.
+ * @retval `false` The task could not be created.
+ */
+bool startNotifier(const NotifierConfig& config = NotifierConfig());
+
+/**
+ * @brief Deliver the change events queued by `Option::DeferCallbacks` objects so far, running their
+ * callbacks on the calling task. Changes made by those callbacks are delivered by the next call.
+ * Call it from one task at a time (e.g. the main loop), or start the notification task instead.
+ * @return `size_t` Number of events delivered. Writes of the same key since the last delivery count
+ * as one event.
+ */
+size_t poll();
+
+namespace Internal {
+
+/// @brief Delivery state of an `Option::DeferCallbacks` object.
+struct NotifyState {
+  std::atomic<bool> queued{false};             // A delivery is in the notify queue
+  std::atomic<uint32_t> busy{0};               // Deliveries queued or running
+  std::atomic<uint32_t> requests{0};           // Deliveries asked of the running one, 0: idle
+  std::atomic<const void*> deliverer{nullptr}; // Task running the object's callbacks
+};
+
+/**
+ * @brief Queued delivery of an `Option::DeferCallbacks` object. `deliver(target)` runs the change
+ * callbacks of its pending events and returns how many it delivered.
+ */
+struct NotifyJob {
+  void* target;
+  size_t (*deliver)(void* target);
+  NotifyState* state;
+};
+
+/**
+ * @brief Hand a delivery to `poll()` or the notification task. Lock-free unless the queue is full
+ * (`SETTINGS_NOTIFY_QUEUE_LENGTH`): the delivery then goes to the overflow list. A delivery found
+ * while another task runs one of the same object is handed to that task, which runs it once done:
+ * the callbacks of an object never run concurrently, and always in order.
+ * @param job Delivery to queue. Each object queues one at a time, through `NotifyState::queued`.
+ */
+void enqueueNotify(const NotifyJob& job);
+
+/**
+ * @brief Wait until an object has no delivery queued or running, delivering queued events
+ * meanwhile. Used by `end()` of `Option::DeferCallbacks` objects. Returns at once when called from
+ * one of the object's own callbacks, whose delivery cannot finish before it returns.
+ * @param state Delivery state of the object.
+ */
+void drainNotify(const NotifyState& state);
+
+} // namespace Internal
+
+} // namespace NVS
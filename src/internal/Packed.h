@@ -0,0 +1,138 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <array>
+#include <nvs.h>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace NVS {
+
+namespace Internal {
+
+/// @brief NVS key holding the flags of a `Settings<bool>` object created with `Option::Packed`.
+constexpr const char* PACKED_KEY = "_packed";
+
+/**
+ * @brief RAM image of N flags stored under a single NVS key, used by `Option::Packed`.
+ *
+ * Each flag has a value bit and a presence bit, so that a flag that was never written still reads
+ * as absent (and falls back to its default). Up to 32 flags are stored as one `u64` (presence bits
+ * in the high word), which takes a single NVS entry; more flags are stored as a blob of presence
+ * bytes followed by value bytes.
+ *
+ * @tparam N Number of flags.
+ */
+template <size_t N>
+class PackedFlags {
+  public:
+  static constexpr bool AS_U64      = N <= 32;
+  static constexpr size_t BYTES     = (N + 7) / 8;
+  static constexpr size_t BLOB_SIZE = BYTES * 2;
+
+  /**
+   * @brief Load the image from NVS. A missing key loads an image where every flag is absent. Flags
+   * appended to the list since the image was stored read as absent; if flags were removed (more
+   * than 32 flags), the whole stored image is dropped.
+   * @retval `true` Loaded.
+   * @retval `false` NVS error.
+   */
+  bool load(nvs_handle_t handle) {
+    _present.fill(0);
+    _value.fill(0);
+
+    esp_err_t err;
+
+    if constexpr (AS_U64) {
+      uint64_t bits = 0;
+      err           = nvs_get_u64(handle, PACKED_KEY, &bits);
+      if (err == ESP_OK) {
+        for (size_t i = 0; i < BYTES; i++) {
+          _value[i]   = static_cast<uint8_t>(bits >> (8 * i));
+          _present[i] = static_cast<uint8_t>(bits >> (32 + 8 * i));
+        }
+      }
+    } else {
+      uint8_t blob[BLOB_SIZE];
+      size_t size = sizeof(blob);
+      err         = nvs_get_blob(handle, PACKED_KEY, blob, &size);
+
+      // Stored by an object with fewer flags: the missing ones read as absent
+      if (err == ESP_OK && size % 2 == 0) {
+        size_t stored_bytes = size / 2;
+        for (size_t i = 0; i < stored_bytes; i++) {
+          _present[i] = blob[i];
+          _value[i]   = blob[stored_bytes + i];
+        }
+      }
+    }
+
+    // Stored by an object with more flags (too long for the buffer): start over, all absent
+    return err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND || err == ESP_ERR_NVS_INVALID_LENGTH;
+  }
+
+  /**
+   * @brief Write the image to NVS, without committing it.
+   * @retval `true` Written.
+   * @retval `false` NVS error.
+   */
+  bool store(nvs_handle_t handle) const {
+    if constexpr (AS_U64) {
+      uint64_t bits = 0;
+      for (size_t i = 0; i < BYTES; i++) {
+        bits |= static_cast<uint64_t>(_value[i]) << (8 * i);
+        bits |= static_cast<uint64_t>(_present[i]) << (32 + 8 * i);
+      }
+      return nvs_set_u64(handle, PACKED_KEY, bits) == ESP_OK;
+    } else {
+      uint8_t blob[BLOB_SIZE];
+      for (size_t i = 0; i < BYTES; i++) {
+        blob[i]         = _present[i];
+        blob[BYTES + i] = _value[i];
+      }
+      return nvs_set_blob(handle, PACKED_KEY, blob, sizeof(blob)) == ESP_OK;
+    }
+  }
+
+  /**
+   * @brief Get a flag.
+   * @param index Flag index.
+   * @param value Set to the flag value if present.
+   * @retval `true` Present.
+   * @retval `false` Never written.
+   */
+  bool get(size_t index, bool& value) const {
+    if (!(_present[index / 8] & _mask(index))) return false;
+    value = (_value[index / 8] & _mask(index)) != 0;
+    return true;
+  }
+
+  /**
+   * @brief Set a flag and mark it present.
+   * @param index Flag index.
+   * @param value New value.
+   */
+  void set(size_t index, bool value) {
+    _present[index / 8] |= _mask(index);
+    if (value) {
+      _value[index / 8] |= _mask(index);
+    } else {
+      _value[index / 8] &= static_cast<uint8_t>(~_mask(index));
+    }
+  }
+
+  private:
+  std::array<uint8_t, BYTES> _present{};
+  std::array<uint8_t, BYTES> _value{};
+
+  static uint8_t _mask(size_t index) { return static_cast<uint8_t>(1u << (index % 8)); }
+};
+
+} // namespace Internal
+
+} // namespace NVS
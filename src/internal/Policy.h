@@ -16,12 +16,16 @@ namespace NVS {
 
 namespace Internal {
 
+/**
+ * Policies only translate values to and from NVS entries. Writes are not committed here: the
+ * owning Settings object issues `nvs_commit()`, once per write or once per transaction.
+ */
+
 /// @brief Policy for bool values. Stored as uint8_t (0 or 1).
 class BoolPolicy {
   public:
   bool setValue(nvs_handle_t handle, const char* key, bool value) {
-    if (nvs_set_u8(handle, key, value ? 1u : 0u) != ESP_OK) return false;
-    return nvs_commit(handle) == ESP_OK;
+    return nvs_set_u8(handle, key, value ? 1u : 0u) == ESP_OK;
   }
 
   bool getValue(nvs_handle_t handle, const char* key, bool& value) {
@@ -36,8 +40,7 @@ class BoolPolicy {
 class UInt32Policy {
   public:
   bool setValue(nvs_handle_t handle, const char* key, uint32_t value) {
-    if (nvs_set_u32(handle, key, value) != ESP_OK) return false;
-    return nvs_commit(handle) == ESP_OK;
+    return nvs_set_u32(handle, key, value) == ESP_OK;
   }
 
   bool getValue(nvs_handle_t handle, const char* key, uint32_t& value) {
@@ -50,8 +53,7 @@ class UInt32Policy {
 class Int32Policy {
   public:
   bool setValue(nvs_handle_t handle, const char* key, int32_t value) {
-    if (nvs_set_i32(handle, key, value) != ESP_OK) return false;
-    return nvs_commit(handle) == ESP_OK;
+    return nvs_set_i32(handle, key, value) == ESP_OK;
   }
 
   bool getValue(nvs_handle_t handle, const char* key, int32_t& value) {
@@ -66,8 +68,7 @@ class FloatPolicy {
   bool setValue(nvs_handle_t handle, const char* key, float value) {
     uint32_t bits;
     memcpy(&bits, &value, sizeof(bits));
-    if (nvs_set_u32(handle, key, bits) != ESP_OK) return false;
-    return nvs_commit(handle) == ESP_OK;
+    return nvs_set_u32(handle, key, bits) == ESP_OK;
   }
 
   bool getValue(nvs_handle_t handle, const char* key, float& value) {
@@ -86,8 +87,7 @@ class DoublePolicy {
   bool setValue(nvs_handle_t handle, const char* key, double value) {
     uint64_t bits;
     memcpy(&bits, &value, sizeof(bits));
-    if (nvs_set_u64(handle, key, bits) != ESP_OK) return false;
-    return nvs_commit(handle) == ESP_OK;
+    return nvs_set_u64(handle, key, bits) == ESP_OK;
   }
 
   bool getValue(nvs_handle_t handle, const char* key, double& value) {
@@ -102,20 +102,20 @@ class DoublePolicy {
 class StringPolicy {
   public:
   bool setValue(nvs_handle_t handle, const char* key, StrView value) {
-    if (nvs_set_str(handle, key, value.data) != ESP_OK) return false;
-    return nvs_commit(handle) == ESP_OK;
+    return nvs_set_str(handle, key, value.data) == ESP_OK;
   }
 
   bool getValue(nvs_handle_t handle, const char* key, Str& value) {
     if (!value.data || value.max_size == 0) return false;
 
-    // Try to read and fit the value in the provided buffer
-    size_t required_size = 0;
-    if (nvs_get_str(handle, key, nullptr, &required_size) != ESP_OK) return false;
-    if (required_size > value.max_size) return false;
-    if (nvs_get_str(handle, key, value.data, &required_size) != ESP_OK) return false;
+    // Single lookup: NVS rejects a too small buffer (ESP_ERR_NVS_INVALID_LENGTH) before copying
+    size_t length = value.max_size;
+    return nvs_get_str(handle, key, value.data, &length) == ESP_OK;
+  }
 
-    return true;
+  // Stored size, including the null terminator
+  bool getSize(nvs_handle_t handle, const char* key, size_t& size) {
+    return nvs_get_str(handle, key, nullptr, &size) == ESP_OK;
   }
 };
 
@@ -123,22 +123,23 @@ class StringPolicy {
 class ByteStreamPolicy {
   public:
   bool setValue(nvs_handle_t handle, const char* key, ByteStreamView value) {
-    if (nvs_set_blob(handle, key, value.data, value.size) != ESP_OK) return false;
-    return nvs_commit(handle) == ESP_OK;
+    return nvs_set_blob(handle, key, value.data, value.size) == ESP_OK;
   }
 
   bool getValue(nvs_handle_t handle, const char* key, ByteStream& value) {
     if (!value.data || value.max_size == 0) return false;
 
-    // Try to read and fit the value in the provided buffer
-    size_t required_size = 0;
-    if (nvs_get_blob(handle, key, nullptr, &required_size) != ESP_OK) return false;
-    if (required_size > value.max_size) return false;
-    if (nvs_get_blob(handle, key, value.data, &required_size) != ESP_OK) return false;
+    // Single lookup: NVS rejects a too small buffer (ESP_ERR_NVS_INVALID_LENGTH) before copying
+    size_t length = value.max_size;
+    if (nvs_get_blob(handle, key, value.data, &length) != ESP_OK) return false;
 
-    value.size = required_size;
+    value.size = length;
     return true;
   }
+
+  bool getSize(nvs_handle_t handle, const char* key, size_t& size) {
+    return nvs_get_blob(handle, key, nullptr, &size) == ESP_OK;
+  }
 };
 
 /**
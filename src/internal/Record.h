@@ -0,0 +1,145 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <array>
+#include <nvs.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Cache.h"
+
+namespace NVS {
+
+namespace Internal {
+
+/// @brief NVS key holding the values of a Settings object created with `Option::Record`.
+constexpr const char* RECORD_KEY = "_record";
+
+/**
+ * @brief RAM image of N scalar values stored as one versioned blob, used by `Option::Record`.
+ *
+ * The image is kept in its stored layout, so loading is a single `nvs_get_blob()` straight into it
+ * and storing a single `nvs_set_blob()` from it:
+ *
+ * | Offset        | Size             | Content                                            |
+ * | ------------- | ---------------- | -------------------------------------------------- |
+ * | 0             | 4                | CRC32 of everything that follows                   |
+ * | 4             | 2                | Schema version (`Settings::setRecordVersion()`)    |
+ * | 6             | 2                | Number of values (N)                               |
+ * | 8             | (N + 7) / 8      | Presence bits: value i was written                 |
+ * | 8 + (N+7)/8   | N * sizeof(T)    | Values, in list order                              |
+ *
+ * A record with another version or count, or a wrong CRC, is dropped on load: every value then
+ * reads as absent and falls back to its default.
+ *
+ * @tparam T Scalar value type.
+ * @tparam N Number of values.
+ */
+template <typename T, size_t N>
+class RecordImage {
+  public:
+  static constexpr size_t HEADER_SIZE    = 8;
+  static constexpr size_t PRESENCE_BYTES = (N + 7) / 8;
+  static constexpr size_t VALUES_OFFSET  = HEADER_SIZE + PRESENCE_BYTES;
+  static constexpr size_t SIZE           = VALUES_OFFSET + N * sizeof(T);
+
+  static_assert(N <= UINT16_MAX, "Too many values for a record");
+
+  /// @brief Schema version written to and expected from the stored record.
+  uint16_t version = 0;
+
+  /**
+   * @brief Load the image from NVS.
+   * @param key Key of the record.
+   * @retval `true` Loaded, or no valid record stored (every value absent, see `found()`).
+   * @retval `false` NVS error.
+   */
+  bool load(nvs_handle_t handle, const char* key = RECORD_KEY) {
+    size_t size   = SIZE;
+    esp_err_t err = nvs_get_blob(handle, key, _blob.data(), &size);
+    _found        = (err == ESP_OK) && size == SIZE && _valid();
+
+    if (!_found) _reset();
+    return err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND || err == ESP_ERR_NVS_INVALID_LENGTH;
+  }
+
+  /**
+   * @brief Write the image to NVS, without committing it.
+   * @param key Key of the record.
+   * @retval `true` Written.
+   * @retval `false` NVS error.
+   */
+  bool store(nvs_handle_t handle, const char* key = RECORD_KEY) {
+    _writeHeader();
+    if (nvs_set_blob(handle, key, _blob.data(), SIZE) != ESP_OK) return false;
+    _found = true;
+    return true;
+  }
+
+  /**
+   * @brief Check whether the last `load()` found a valid record, or the image was stored since.
+   * @retval `true` Valid record in NVS.
+   * @retval `false` No record, or dropped.
+   */
+  bool found() const { return _found; }
+
+  /**
+   * @brief Get a value.
+   * @param index Value index.
+   * @param value Set to the value if present.
+   * @retval `true` Present.
+   * @retval `false` Never written.
+   */
+  bool get(size_t index, T& value) const {
+    if (!(_blob[HEADER_SIZE + index / 8] & _mask(index))) return false;
+    memcpy(&value, &_blob[VALUES_OFFSET + index * sizeof(T)], sizeof(T));
+    return true;
+  }
+
+  /**
+   * @brief Set a value and mark it present.
+   * @param index Value index.
+   * @param value New value.
+   */
+  void set(size_t index, const T& value) {
+    _blob[HEADER_SIZE + index / 8] |= _mask(index);
+    memcpy(&_blob[VALUES_OFFSET + index * sizeof(T)], &value, sizeof(T));
+  }
+
+  private:
+  std::array<uint8_t, SIZE> _blob{};
+  bool _found = false;
+
+  static uint8_t _mask(size_t index) { return static_cast<uint8_t>(1u << (index % 8)); }
+
+  void _writeHeader() {
+    uint16_t count = static_cast<uint16_t>(N);
+    memcpy(&_blob[4], &version, sizeof(version));
+    memcpy(&_blob[6], &count, sizeof(count));
+
+    uint32_t crc = crc32(&_blob[4], SIZE - 4);
+    memcpy(&_blob[0], &crc, sizeof(crc));
+  }
+
+  bool _valid() const {
+    uint32_t crc;
+    uint16_t stored_version, count;
+    memcpy(&crc, &_blob[0], sizeof(crc));
+    memcpy(&stored_version, &_blob[4], sizeof(stored_version));
+    memcpy(&count, &_blob[6], sizeof(count));
+
+    return stored_version == version && count == N && crc == crc32(&_blob[4], SIZE - 4);
+  }
+
+  void _reset() { _blob.fill(0); }
+};
+
+} // namespace Internal
+
+} // namespace NVS
@@ -0,0 +1,56 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include "ISettings.h"
+
+namespace NVS {
+
+/// @brief A single setting of a Settings object, as resolved by `findSetting()`.
+struct SettingRef {
+  ISettings* settings = nullptr; // Owning Settings object
+  size_t index        = 0;       // Index of the setting in the object's list
+};
+
+/**
+ * @brief Resolve a key to the open Settings object that owns it, and its index, across the
+ * Settings objects created with `Option::Registry`. They join the registry on `begin()` and leave
+ * it on `end()`; other objects cost it nothing.
+ *
+ * `path` is either `"namespace/key"` or a bare `"key"`. A bare key only resolves when exactly one
+ * open object has it; a qualified key only resolves when exactly one open object in that namespace
+ * has it. The lookup is a single hash probe, independent of the number of objects and keys. The
+ * registry takes 8 bytes per slot, with at least 4/3 as many slots as registered keys.
+ *
+ * @param path `"namespace/key"` or `"key"`.
+ * @param out Set to the owning object and index if found.
+ * @retval `true` Found and unambiguous.
+ * @retval `false` Not found, or ambiguous.
+ */
+bool findSetting(const char* path, SettingRef& out);
+
+namespace Internal {
+
+/**
+ * @brief Add a Settings object and all its keys to the registry. Called by `Settings::begin()`
+ * with `Option::Registry`.
+ * @param settings Object to add. Adding an object twice has no effect.
+ */
+void registerSettings(ISettings* settings);
+
+/**
+ * @brief Remove a Settings object and its keys from the registry. Called by `Settings::end()`
+ * with `Option::Registry`.
+ * @param settings Object to remove. Removing an object that is not registered has no effect.
+ */
+void unregisterSettings(ISettings* settings);
+
+} // namespace Internal
+
+} // namespace NVS
@@ -8,14 +8,28 @@
 
 #include <algorithm>
 #include <array>
-#include <functional>
+#include <atomic>
+#include <esp_timer.h>
 #include <initializer_list>
+#include <mutex>
 #include <nvs.h>
 #include <string.h>
 #include <type_traits>
 
+#include "Cache.h"
+#include "Callback.h"
+#include "Chunked.h"
+#include "Compressed.h"
 #include "ISettings.h"
+#include "KeyIndex.h"
+#include "Metrics.h"
+#include "Notifier.h"
+#include "Packed.h"
+#include "Record.h"
 #include "Policy.h"
+#include "Registry.h"
+#include "Wear.h"
+#include "Writer.h"
 
 namespace NVS {
 
@@ -26,36 +40,170 @@ namespace NVS {
  * Multiple instances may share the same namespace (keys must then be unique within it) or use
  * independent namespaces, enabling reusable components with the same key set.
  *
+ * With `Option::Cache`, the current value of each entry is kept in RAM: the first read of a key
+ * loads it from NVS (or learns that it is absent), later reads are served from RAM and writes are
+ * write-through. For `Str` and `ByteStream`, only the length and CRC32 of the stored value are
+ * kept, which serves `getValueSize()` from RAM. The cache assumes this object is the only writer of
+ * its keys; call `invalidateCache()` after modifying them through another object sharing the
+ * namespace.
+ *
+ * With `Option::ElideWrites`, a write of the value already stored is skipped and reported as
+ * `WriteStatus::Unchanged`, without commit or callbacks. Scalars are compared with the stored (or
+ * cached) value. Strings and byte streams are compared by length and CRC32 against a fingerprint of
+ * the last value this object wrote or read, so the first write after `begin()` of a key not read
+ * yet is never skipped. The same single-writer assumption as the cache applies.
+ *
+ * With `Option::Packed` (`bool` only), all flags are stored as one bitset under the
+ * `Internal::PACKED_KEY` key instead of one entry each, and kept in RAM: the first access loads
+ * them with a single read, and each write stores the whole set. Only one packed object may use a
+ * given namespace.
+ *
+ * With `Option::Record` (scalar types), all values are stored as one versioned blob under the
+ * `Internal::RECORD_KEY` key (see `Internal::RecordImage`) and kept in RAM: the first access or
+ * `loadAll()` loads them with a single read, and each write or `saveAll()` stores the whole record.
+ * Only one record object may use a given namespace.
+ *
+ * With `Option::Async` (scalar types), `setValue()` only stages the value in RAM and returns
+ * `WriteStatus::Queued`: the background writer (see `NVS::startWriter()`) writes every value staged
+ * since its last pass with a single `nvs_commit()`, so repeated writes of a key collapse into the
+ * last one. Reads return staged values right away. Change callbacks and the
+ * `setWriteDoneCallback()` callback run on the writer task, after the commit. `NVS::flush()` waits
+ * for every queued write.
+ *
+ * With `Option::ThreadSafe`, the object may be shared between tasks: every operation that touches
+ * NVS or the object's state takes a per-object recursive mutex, while reads of cached values
+ * (`Option::Cache`) go through a sequence lock and never block. `getValues()` reads several keys as
+ * one consistent set. Callbacks run with the mutex held, and a transaction belongs to the object,
+ * not to the task that started it.
+ *
+ * Change callbacks are function pointers or small lambdas (`Internal::Delegate`), kept in a sparse
+ * table: a byte per setting, plus a heap pool of the registered ones only;
+ * `Option::NoCallbacks` removes them altogether. With
+ * `Option::DeferCallbacks` (scalar types), a write only records the change: callbacks run later, on
+ * the task calling `NVS::poll()` or on the notification task (`NVS::startNotifier()`), without any
+ * lock held. Changes of a key between two deliveries are reported once, with the latest value.
+ *
+ * With `Option::Metrics`, reads, misses, writes, commits and failures are counted per object and
+ * per key, and reads, writes and commits are timed into log2 histograms (`getMetrics()`,
+ * `NVS::formatMetrics()`). Without it, none of this is compiled in.
+ *
+ * With `Option::Wear`, the values written to NVS and the 32-byte entries they append are counted
+ * per key (`getKeyWear()`) and per namespace, feeding the partition lifetime estimate of
+ * `NVS::estimateWear()`. A key may have a write budget (`setWriteBudget()`) whose overruns fire the
+ * wear alert callback.
+ *
+ * With `Option::Chunked` (`ByteStream` only), each value is split into `SETTINGS_CHUNK_SIZE`-byte
+ * chunks stored under keys of their own, plus a small index under the key (see
+ * `Internal::ChunkedBlobPolicy`). A write rewrites only the chunks that changed, and
+ * `readRange()`/`writeRange()` access a slice of a large value through a buffer of its size.
+ *
+ * With `Option::Compressed` (`Str` and `ByteStream`), values are compressed with a small
+ * LZ77 codec and stored compressed when that saves NVS entries, raw otherwise (see
+ * `Internal::writeCompressed()`). Compression and reads go through a stack buffer of
+ * `SETTINGS_COMPRESS_BUFFER` bytes: a value that neither fits in it nor compresses into it is
+ * not written.
+ *
+ * Every write is committed on its own, unless it happens inside a transaction
+ * (`beginTransaction()` / `commit()` / `abort()`, or the `NVS::Transaction` scope guard, with
+ * `Option::Transactions`): staged writes are then flushed with a single `nvs_commit()`.
+ * `formatAll()` always writes its defaults with a single `nvs_commit()`.
+ *
  * @note NVS namespace names are limited to 15 characters.
  *
  * @tparam T Value type (`bool`, `uint32_t`, `int32_t`, `float`, `double`, `const char*`,
  * `ByteStream`).
  * @tparam ENUM Enum class whose enumerators index into the settings list.
  * @tparam N Number of settings (use `SETTINGS_COUNT` macro).
+ * @tparam OPTIONS Compile-time options (`NVS::Option`), combined with `|`.
  */
-template <typename T, typename ENUM, size_t N>
+template <typename T, typename ENUM, size_t N, Option OPTIONS = Option::None>
 class Settings : public ISettings {
   public:
-  using Policy    = typename Internal::PolicyTrait<T>::policy_type;
+  static constexpr bool CACHED = hasOption(OPTIONS, Option::Cache);
+  static constexpr bool ELIDED = hasOption(OPTIONS, Option::ElideWrites);
+  static constexpr bool PACKED = hasOption(OPTIONS, Option::Packed);
+  static constexpr bool RECORD = hasOption(OPTIONS, Option::Record);
+  static constexpr bool ASYNC  = hasOption(OPTIONS, Option::Async);
+
+  static constexpr bool THREAD_SAFE = hasOption(OPTIONS, Option::ThreadSafe);
+  static constexpr bool CALLBACKS   = !hasOption(OPTIONS, Option::NoCallbacks);
+  static constexpr bool DEFERRED    = hasOption(OPTIONS, Option::DeferCallbacks);
+  static constexpr bool METRICS     = hasOption(OPTIONS, Option::Metrics);
+  static constexpr bool WEAR        = hasOption(OPTIONS, Option::Wear);
+  static constexpr bool CHUNKED     = hasOption(OPTIONS, Option::Chunked);
+  static constexpr bool COMPRESSED  = hasOption(OPTIONS, Option::Compressed);
+  static constexpr bool KEY_INDEXED = hasOption(OPTIONS, Option::KeyIndex);
+  static constexpr bool TRANSACTED  = hasOption(OPTIONS, Option::Transactions);
+  static constexpr bool REGISTERED  = hasOption(OPTIONS, Option::Registry);
+
+  // Strings stored before Option::Compressed are of another NVS type, dropped by a first write
+  static constexpr bool LEGACY_STRINGS = COMPRESSED && std::is_same_v<T, Str>;
+
+  static_assert(!PACKED || std::is_same_v<T, bool>, "Option::Packed supports bool only");
+  static_assert(!RECORD || std::is_arithmetic_v<T>, "Option::Record supports scalar types only");
+  static_assert(!(PACKED && RECORD), "Option::Packed and Option::Record are exclusive");
+  static_assert(!ASYNC || std::is_arithmetic_v<T>, "Option::Async supports scalar types only");
+  static_assert(!ASYNC || !(CACHED || PACKED || RECORD),
+                "Option::Async cannot be combined with Option::Cache, Packed or Record");
+  static_assert(!(ASYNC && THREAD_SAFE), "Option::Async objects are already safe to share");
+  static_assert(!DEFERRED || std::is_arithmetic_v<T>,
+                "Option::DeferCallbacks supports scalar types only");
+  static_assert(!(DEFERRED && !CALLBACKS),
+                "Option::DeferCallbacks and Option::NoCallbacks are exclusive");
+  static_assert(!CHUNKED || std::is_same_v<T, ByteStream>,
+                "Option::Chunked supports ByteStream only");
+  static_assert(!COMPRESSED || std::is_same_v<T, Str> || std::is_same_v<T, ByteStream>,
+                "Option::Compressed supports Str and ByteStream only");
+  static_assert(!(CHUNKED && COMPRESSED), "Option::Chunked and Option::Compressed are exclusive");
+  static_assert(!(ASYNC && TRANSACTED),
+                "Option::Async and Option::Transactions are exclusive: the writer already batches");
+  static_assert(!REGISTERED || N < UINT16_MAX, "Option::Registry supports up to 65534 settings");
+
+  using Policy    = std::conditional_t<
+    CHUNKED, Internal::ChunkedBlobPolicy,
+    std::conditional_t<COMPRESSED, Internal::CompressedPolicy<T>,
+                       typename Internal::PolicyTrait<T>::policy_type>>;
   using Struct    = typename Internal::PolicyTrait<T>::struct_type;
   using WriteType = typename Internal::PolicyTrait<T>::write_type;
   using OnChangeCb =
-    std::function<void(const char* key, const ENUM setting, const WriteType updated_value)>;
+    Internal::Delegate<void(const char* key, const ENUM setting, const WriteType updated_value)>;
+  using WriteDoneCb =
+    Internal::Delegate<void(const char* key, const ENUM setting, const WriteResult result)>;
+
+  /// @brief Number of per-setting callbacks that can be registered at the same time.
+  static constexpr size_t CALLBACK_SLOTS =
+    !CALLBACKS                     ? 0
+    : SETTINGS_CALLBACK_SLOTS == 0 ? N
+                                   : std::min<size_t>(N, SETTINGS_CALLBACK_SLOTS);
 
   /**
    * @brief Construct a Settings object. Call `begin()` before any read/write operation.
    * @param ns_name NVS namespace name (max 15 characters).
    * @param list Initializer list of Setting structs, one per enum entry.
+   * @param partition_name Optional NVS partition name, initialized with `NVS::init()`. If
+   * `nullptr`, the default partition is used.
    */
-  Settings(const char* ns_name, std::initializer_list<Struct> list)
-      : _ns_name(ns_name)
-      , _handle(0)
-      , _is_open(false)
-      , _global_on_change_cb(nullptr)
-      , _global_on_change_cb_callable_on_format(false) {
-    _on_change_cbs.fill(nullptr);
-    _on_change_cbs_callable_on_format.fill(false);
+  Settings(const char* ns_name, std::initializer_list<Struct> list,
+           const char* partition_name = nullptr)
+      : Settings(ns_name, partition_name) {
     std::copy_n(list.begin(), N, _list.begin());
+    if constexpr (KEY_INDEXED) _key_index.build(_list);
+  }
+
+  /**
+   * @brief Construct a Settings object from a list built at runtime. Call `begin()` before any
+   * read/write operation.
+   * @param ns_name NVS namespace name (max 15 characters).
+   * @param list Array of Setting structs, one per enum entry. Key and hint strings, and default
+   * values of `Str` and `ByteStream`, must outlive the Settings object.
+   * @param partition_name Optional NVS partition name, initialized with `NVS::init()`. If
+   * `nullptr`, the default partition is used.
+   */
+  Settings(const char* ns_name, const std::array<Struct, N>& list,
+           const char* partition_name = nullptr)
+      : Settings(ns_name, partition_name) {
+    _list = list;
+    if constexpr (KEY_INDEXED) _key_index.build(_list);
   }
 
   ~Settings() { end(); }
@@ -63,24 +211,53 @@ class Settings : public ISettings {
   /* ----------------------------------------- Lifecycle ---------------------------------------- */
 
   /**
-   * @brief Open the NVS namespace handle. Must be called after `NVS::init()`.
+   * @brief Open the NVS namespace handle. With `Option::Registry`, also join the registry
+   * (`NVS::findSetting()`). Must be called after `NVS::init()` of the object's partition.
    * @retval `true` Handle opened successfully.
    * @retval `false` Operation failed.
    */
   bool begin() override {
+    Lock lock(_mutex);
     if (_is_open) return true;
-    _is_open = (nvs_open(_ns_name, NVS_READWRITE, &_handle) == ESP_OK);
-    return _is_open;
+    _is_open = (nvs_open_from_partition(_part_name ? _part_name : NVS_DEFAULT_PART_NAME, _ns_name,
+                                        NVS_READWRITE, &_handle) == ESP_OK);
+    if (!_is_open) return false;
+    if constexpr (REGISTERED) Internal::registerSettings(this);
+    if constexpr (WEAR) _wear.attach(_ns_name);
+    if constexpr (LEGACY_STRINGS) _legacy_checked.fill(false);
+    if constexpr (ASYNC) {
+      std::lock_guard<AsyncMutex> async_lock(_async_mutex);
+      _async.open = true;
+    }
+    return true;
   }
 
   /**
-   * @brief Close the NVS namespace handle.
+   * @brief Close the NVS namespace handle and leave the registry, if joined. A transaction in
+   * progress is aborted. The cache and fingerprints are invalidated. With `Option::Async`, queued
+   * writes are flushed first.
    */
   void end() override {
+    if constexpr (ASYNC) {
+      flush();
+
+      // Closed to the writer: writes queued from now on fail, and a drain already running finishes
+      // before the handle is closed
+      {
+        std::lock_guard<AsyncMutex> async_lock(_async_mutex);
+        _async.open = false;
+      }
+      flush();
+    }
+    if constexpr (DEFERRED) Internal::drainNotify(_notify);
+    Lock lock(_mutex);
     if (!_is_open) return;
+    abort();
+    if constexpr (REGISTERED) Internal::unregisterSettings(this);
     nvs_close(_handle);
     _handle  = 0;
     _is_open = false;
+    invalidateCache();
   }
 
   /**
@@ -89,24 +266,111 @@ class Settings : public ISettings {
    */
   virtual const char* getNamespace() const override { return _ns_name; }
 
+  /**
+   * @brief Get the NVS partition name used by this Settings object.
+   * @return Partition name, or `nullptr` for the default partition.
+   */
+  virtual const char* getPartition() const override { return _part_name; }
+
   /**
    * @brief Check whether the NVS handle is currently open.
    * @retval `true` Handle is open.
    * @retval `false` Handle is closed.
    */
-  bool isOpen() const override { return _is_open; }
+  bool isOpen() const override {
+    Lock lock(_mutex);
+    return _is_open;
+  }
 
   /**
-   * @brief Erase all keys in the namespace.
+   * @brief Erase all keys in the namespace. The cache and fingerprints are invalidated. With
+   * `Option::Async`, queued writes are flushed first.
    * @retval `true` All keys erased successfully.
    * @retval `false` Operation failed.
    */
   bool eraseAll() override {
+    if constexpr (ASYNC) flush();
+    Lock lock(_mutex);
     if (!_is_open) return false;
+    invalidateCache();
     if (nvs_erase_all(_handle) != ESP_OK) return false;
     return nvs_commit(_handle) == ESP_OK;
   }
 
+  /**
+   * @brief Drop every cached value or length, so the next read of each key goes to NVS, and every
+   * `Option::ElideWrites` fingerprint. With `Option::Packed` or `Option::Record`, the values are
+   * reloaded on next access.
+   */
+  void invalidateCache() {
+    Lock lock(_mutex);
+
+    if constexpr (VALUE_CACHED) {
+      _cache.beginWrite();
+      _cache.clear();
+      _cache.endWrite();
+    }
+
+    if constexpr (FINGERPRINTED) _fingerprints.fill(Internal::Fingerprint{});
+
+    if constexpr (IMAGED) {
+      _image_loaded = false;
+      _image_dirty  = false;
+    }
+  }
+
+  /* ------------------------------------------ Record ------------------------------------------ */
+
+  /**
+   * @brief Set the schema version of the record (`Option::Record`). A stored record with another
+   * version is dropped when loaded. Call it before the first access, and bump it whenever the list
+   * changes in a way that keeps the same count (reordered or retyped entries).
+   * @param version Schema version, 0 by default.
+   */
+  void setRecordVersion(uint16_t version) {
+    static_assert(RECORD, "setRecordVersion() requires Option::Record");
+    Lock lock(_mutex);
+    _image.version = version;
+    _image_loaded  = false;
+  }
+
+  /**
+   * @brief Reload every value from NVS with a single read (`Option::Record`). Without this call,
+   * values are loaded on first access.
+   * @retval `true` A valid record was loaded.
+   * @retval `false` Handle not open, NVS error, or no valid record stored (absent, other version or
+   * count, or corrupted): every value then reads as absent and falls back to its default.
+   */
+  bool loadAll() {
+    static_assert(RECORD, "loadAll() requires Option::Record");
+    Lock lock(_mutex);
+    invalidateCache();
+    return _imageReady() && _image.found();
+  }
+
+  /**
+   * @brief Store the whole record with a single write and commit (`Option::Record`). Values never
+   * written are stored with their default, so the stored record is complete. No callbacks fire.
+   * @retval `true` Stored and committed.
+   * @retval `false` Handle not open, transaction in progress, or NVS error.
+   */
+  bool saveAll() {
+    static_assert(RECORD, "saveAll() requires Option::Record");
+    Lock lock(_mutex);
+    if (!_is_open || _in_transaction) return false;
+    if (!_imageReady()) return false;
+
+    for (size_t i = 0; i < N; i++) {
+      T value;
+      if (_image.get(i, value)) continue;
+      _image.set(i, _list[i].default_value);
+      _forget(i);
+    }
+
+    _image_dirty = true;
+    return _commit();
+  }
+
   /* ------------------------------------ ISettings interface ----------------------------------- */
 
   /**
@@ -155,14 +419,14 @@ class Settings : public ISettings {
   }
 
   /**
-   * @brief Write a new value via untyped pointer.
+   * @brief Write a new value via untyped pointer, or stage it if a transaction is in progress.
    * @param index Index in the list.
    * @param value Pointer to the new value.
-   * @retval `true` Written successfully.
-   * @retval `false` Handle not open, index out of bounds, or NVS write error.
+   * @return `WriteResult`: `Written`, `Unchanged` (`Option::ElideWrites`), `Staged`, or `Failed`
+   * if the handle is not open, the index is out of bounds, or NVS returned an error.
    */
-  bool setValuePtr(size_t index, const void* value) override {
-    if (index >= N) return false;
+  WriteResult setValuePtr(size_t index, const void* value) override {
+    if (index >= N) return WriteStatus::Failed;
     return setValueImpl(static_cast<ENUM>(index), *static_cast<const WriteType*>(value), false);
   }
 
@@ -178,7 +442,7 @@ class Settings : public ISettings {
     if (index >= N) return false;
     if (size < sizeof(T)) return false;
     T& out = *static_cast<T*>(value);
-    return _policy.getValue(_handle, _list[index].key, out);
+    return _get(index, out);
   }
 
   /**
@@ -195,46 +459,154 @@ class Settings : public ISettings {
     if (size < sizeof(T)) return false;
 
     T& out = *static_cast<T*>(value);
-    if (!_policy.getValue(_handle, _list[index].key, out)) {
+    if (!_get(index, out)) {
       _applyDefault(out, _list[index].default_value);
     }
     return true;
   }
 
+  /**
+   * @brief Get the size of the value stored in NVS, without reading it. Use it to size the buffer
+   * of a `Str` or `ByteStream` read. With `Option::Cache` or `Option::ElideWrites`, the length of a
+   * `Str` or `ByteStream` this object wrote or read is served from RAM.
+   * @param index Index in the list.
+   * @param size Set to the size in bytes: string length including the null terminator, blob size,
+   * or `sizeof(T)` for scalars.
+   * @retval `true` Key found in NVS.
+   * @retval `false` Handle not open, index out of bounds, or key not found.
+   */
+  bool getValueSize(size_t index, size_t& size) override {
+    if (index >= N) return false;
+    Lock lock(_mutex);
+
+    if constexpr (std::is_arithmetic_v<T>) {
+      T value;
+      if (!_readValue(index, value)) return false;
+      size = sizeof(T);
+      return true;
+    } else {
+      if constexpr (FINGERPRINTED) {
+        const Internal::Fingerprint& fp = _fingerprints[index];
+        if (fp.valid) {
+          size = std::is_same_v<T, Str> ? fp.size + 1 : fp.size;
+          return true;
+        }
+      }
+
+      if (!_is_open) return false;
+      return _policy.getSize(_handle, _list[index].key, size);
+    }
+  }
+
+  /**
+   * @brief Read every value into a caller-provided array, with fallback to the default value for
+   * keys not found in NVS. See `snapshot()`.
+   * @param values Destination array of N values of type T.
+   * @param size Size of the destination array in bytes.
+   * @param found If not null, set to the number of values read from NVS.
+   * @retval `true` Every value read from NVS or set to its default.
+   * @retval `false` Handle not open, array too small, or NVS error.
+   */
+  bool snapshotPtr(void* values, size_t size, size_t* found = nullptr) override {
+    if (size < N * sizeof(T)) return false;
+    return _snapshot(static_cast<T*>(values), found);
+  }
+
+  /**
+   * @brief Get the operation counters and latency histograms of the object (`Option::Metrics`).
+   * @param metrics Set to the metrics since construction or the last `resetMetrics()`.
+   * @retval `true` Metrics copied.
+   * @retval `false` Created without `Option::Metrics`.
+   */
+  bool getMetrics(Metrics& metrics) const override {
+    if constexpr (METRICS) {
+      _metrics.copyTo(metrics);
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  /**
+   * @brief Get the operation counters of a single key (`Option::Metrics`).
+   * @param index Index in the list.
+   * @param metrics Set to the counters of the key.
+   * @retval `true` Counters copied.
+   * @retval `false` Created without `Option::Metrics`, or index out of bounds.
+   */
+  bool getKeyMetrics(size_t index, KeyMetrics& metrics) const override {
+    if constexpr (METRICS) {
+      if (index >= N) return false;
+      _metrics.copyTo(index, metrics);
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  /**
+   * @brief Reset every counter and histogram of the object (`Option::Metrics`).
+   */
+  void resetMetrics() override {
+    if constexpr (METRICS) _metrics.reset();
+  }
+
   /**
    * @brief Register a callback that fires on every value change across this object.
-   * @param callback Callback function.
+   * @param callback Callback: a function pointer, or a lambda capturing at most two pointers.
    * @param callable_on_format Whether to invoke the callback when a format operation writes a
    * value.
+   * @retval `true` Registered.
+   * @retval `false` Created with `Option::NoCallbacks`.
    */
-  void setGlobalOnChangeCallback(GlobalOnChangeCb callback, bool callable_on_format) override {
-    _global_on_change_cb                    = callback;
-    _global_on_change_cb_callable_on_format = callable_on_format;
+  bool setGlobalOnChangeCallback(GlobalOnChangeCb callback, bool callable_on_format) override {
+    if constexpr (CALLBACKS) {
+      Lock lock(_mutex);
+      std::lock_guard<DeferMutex> defer_lock(_defer_mutex);
+      std::lock_guard<AsyncMutex> async_lock(_async_mutex);
+      _global_on_change_cb.callback  = callback;
+      _global_on_change_cb.on_format = callable_on_format;
+      return true;
+    } else {
+      return false;
+    }
   }
 
   /**
    * @brief Remove the global change callback.
    */
   void clearGlobalOnChangeCallback() override {
-    _global_on_change_cb                    = nullptr;
-    _global_on_change_cb_callable_on_format = false;
+    if constexpr (CALLBACKS) {
+      Lock lock(_mutex);
+      std::lock_guard<DeferMutex> defer_lock(_defer_mutex);
+      std::lock_guard<AsyncMutex> async_lock(_async_mutex);
+      _global_on_change_cb = GlobalSlot();
+    }
   }
 
   /**
-   * @brief Check whether the given key string exists in this object's list.
+   * @brief Check whether the given key string exists in this object's list. A scan of the keys, or
+   * constant time with `Option::KeyIndex`: the keys are then hashed once, when the object is
+   * constructed.
    * @param key Key string to search.
    * @param index_found Set to the matching index if found.
    * @retval `true` Found.
    * @retval `false` Not found.
    */
   bool hasKey(const char* key, size_t& index_found) const override {
-    for (size_t i = 0; i < N; i++) {
-      if (strcmp(_list[i].key, key) == 0) {
-        index_found = i;
-        return true;
+    if constexpr (KEY_INDEXED) {
+      return _key_index.find(_list, key, index_found);
+    } else {
+      if (!key) return false;
+
+      for (size_t i = 0; i < N; i++) {
+        if (_list[i].key && strcmp(_list[i].key, key) == 0) {
+          index_found = i;
+          return true;
+        }
       }
+      return false;
     }
-    return false;
   }
 
   /**
@@ -252,29 +624,105 @@ class Settings : public ISettings {
    * @brief Write the default value back to NVS for a single setting.
    * @param index Index in the list.
    * @param force Ignore the formattable flag and write regardless.
-   * @retval `true` Written successfully.
-   * @retval `false` Not formattable (without force), out of bounds, or NVS error.
+   * @return `WriteResult`: `Written`, `Unchanged` (`Option::ElideWrites`), `Staged`, or `Failed`
+   * if not formattable (without force), out of bounds, or NVS error.
    */
-  bool format(size_t index, bool force = false) override {
-    if (index >= N) return false;
-    if (!isFormattable(index) && !force) return false;
+  WriteResult format(size_t index, bool force = false) override {
+    if (index >= N) return WriteStatus::Failed;
+    if (!isFormattable(index) && !force) return WriteStatus::Failed;
     return setValueImpl(static_cast<ENUM>(index), getDefaultValue(index), true);
   }
 
   /**
-   * @brief Write the default value back to NVS for all settings.
+   * @brief Write the default value back to NVS for all settings, with a single commit. Inside a
+   * transaction, the defaults are staged and failures are reported by `commit()`. With
+   * `Option::ElideWrites`, only entries that differ from their default are rewritten.
    * @param force Ignore the formattable flag for all entries.
    * @return `size_t` Number of entries that failed to write.
    */
   size_t formatAll(bool force = false) override {
-    size_t errors = 0;
-    for (size_t i = 0; i < N; i++) {
-      if (!isFormattable(i) && !force) continue;
-      if (!setValueImpl(static_cast<ENUM>(i), getDefaultValue(i), true)) errors++;
+    Lock lock(_mutex);
+
+    if constexpr (ASYNC || TRANSACTED) {
+      // Joins the caller's transaction if there is one: failures are then reported by commit()
+      bool own_transaction = beginTransaction();
+
+      size_t errors = 0;
+      for (size_t i = 0; i < N; i++) {
+        if (!isFormattable(i) && !force) continue;
+        if (!setValueImpl(static_cast<ENUM>(i), getDefaultValue(i), true)) errors++;
+      }
+
+      if (own_transaction) errors += _commitStaged();
+      return errors;
+    } else {
+      // The defaults are in the list: a batch needs no staging
+      std::array<Staged, N> batch;
+      size_t count = 0;
+      for (size_t i = 0; i < N; i++) {
+        batch[i] = (isFormattable(i) || force) ? Staged::Format : Staged::None;
+        if (batch[i] == Staged::None) continue;
+        count++;
+        if constexpr (METRICS) _metrics.write(i);
+      }
+
+      if (!_is_open) {
+        if constexpr (METRICS) {
+          for (size_t i = 0; i < N; i++)
+            if (batch[i] != Staged::None) _metrics.failure(i);
+        }
+        return count;
+      }
+      return _writeBatch(batch, [this](size_t i) { return getDefaultValue(i); });
     }
-    return errors;
   }
 
+  /**
+   * @brief Start a transaction. Until `commit()` or `abort()`, writes (`setValue()`, `format()`,
+   * `formatAll()`) are staged in RAM instead of being written to NVS, and reads keep returning the
+   * committed values.
+   * @note For `Str` and `ByteStream`, the data passed to a staged write must stay valid until the
+   * transaction ends.
+   * @retval `true` Transaction started.
+   * @retval `false` Handle not open, a transaction is already in progress, or created without
+   * `Option::Transactions` (the staging arrays take `N` values of RAM).
+   */
+  bool beginTransaction() override {
+    if constexpr (!TRANSACTED) return false;
+    Lock lock(_mutex);
+    if (!_is_open || _in_transaction) return false;
+    _in_transaction = true;
+    return true;
+  }
+
+  /**
+   * @brief Write all staged values to NVS with a single `nvs_commit()`, then fire the change
+   * callbacks once per written key.
+   * @retval `true` All staged values written and committed.
+   * @retval `false` No transaction in progress, or at least one write failed.
+   */
+  bool commit() override {
+    Lock lock(_mutex);
+    if (!_in_transaction) return false;
+    return _commitStaged() == 0;
+  }
+
+  /**
+   * @brief Discard all staged values and end the transaction. No callbacks fire.
+   */
+  void abort() override {
+    Lock lock(_mutex);
+    _staged.fill(Staged::None);
+    _in_transaction = false;
+  }
+
+  /**
+   * @brief Check whether a transaction is in progress.
+   * @retval `true` Transaction in progress.
+   * @retval `false` Otherwise.
+   */
+  bool inTransaction() const override { return _in_transaction; }
+
   /* ----------------------------------------- Typed API ---------------------------------------- */
 
   /**
@@ -311,13 +759,15 @@ class Settings : public ISettings {
   }
 
   /**
-   * @brief Write a new value to NVS.
+   * @brief Write a new value to NVS, or stage it if a transaction is in progress.
    * @param setting Enum entry.
    * @param value Value to write.
-   * @retval `true` Written successfully.
-   * @retval `false` Handle not open or NVS write error.
+   * @return `WriteResult`: `Written`, `Unchanged` (`Option::ElideWrites`), `Staged`, or `Failed`
+   * if the handle is not open or NVS returned an error.
    */
-  bool setValue(ENUM setting, const WriteType value) { return setValueImpl(setting, value, false); }
+  WriteResult setValue(ENUM setting, const WriteType value) {
+    return setValueImpl(setting, value, false);
+  }
 
   /**
    * @brief Read the current value from NVS into `out`.
@@ -331,9 +781,7 @@ class Settings : public ISettings {
    * @retval `true` Value was read from NVS.
    * @retval `false` Value not found in NVS, handle not open, or buffer too small.
    */
-  bool getValue(ENUM setting, T& out) {
-    return _policy.getValue(_handle, getKey(static_cast<size_t>(setting)), out);
-  }
+  bool getValue(ENUM setting, T& out) { return _get(static_cast<size_t>(setting), out); }
 
   /**
    * @brief Read the current value from NVS into `out`, with fallback to the default value if the
@@ -348,19 +796,225 @@ class Settings : public ISettings {
    * @return The value read from NVS, or the default value if not found in NVS or on error.
    */
   T getValueOrDefault(ENUM setting, T& out) {
-    if (!_policy.getValue(_handle, getKey(static_cast<size_t>(setting)), out)) {
+    if (!_get(static_cast<size_t>(setting), out)) {
       _applyDefault(out, _list[static_cast<size_t>(setting)].default_value);
     }
     return out;
   }
 
+  /**
+   * @brief Read several values as one consistent set, with fallback to the default value for keys
+   * not found in NVS. With `Option::ThreadSafe`, the values all come from before or all from after
+   * any concurrent write or transaction; with `Option::Cache` too, this takes no lock once the keys
+   * are cached.
+   *
+   * For NVS::Str and NVS::ByteStream: set `data` and `max_size` of every element of `out` to a
+   * caller-owned buffer before calling.
+   *
+   * @param settings Enum entries to read.
+   * @param out Set to the values, in the order of `settings`.
+   * @retval `true` Every value read from NVS (or the cache).
+   * @retval `false` At least one value set to its default.
+   */
+  template <size_t K>
+  bool getValues(const std::array<ENUM, K>& settings, std::array<T, K>& out) {
+    if constexpr (VALUE_CACHED) {
+      // Load the keys the cache does not know yet, then copy every value in one section
+      for (size_t k = 0; k < K; k++)
+        _readValue(static_cast<size_t>(settings[k]), out[k]);
+
+      bool known = true;
+      bool found = true;
+      std::array<bool, METRICS ? K : 0> present;
+      _cacheRead([&] {
+        known = found = true;
+        for (size_t k = 0; k < K; k++) {
+          size_t index = static_cast<size_t>(settings[k]);
+          Internal::CacheState state = _cache.peek(index, out[k]);
+
+          if constexpr (METRICS) present[k] = (state == Internal::CacheState::Present);
+          if (state == Internal::CacheState::Unknown) known = false;
+          if (state != Internal::CacheState::Present) {
+            found = false;
+            _applyDefault(out[k], _list[index].default_value);
+          }
+        }
+      });
+
+      if (known) {
+        if constexpr (METRICS) {
+          for (size_t k = 0; k < K; k++)
+            _metrics.read(static_cast<size_t>(settings[k]), present[k]);
+        }
+        return found;
+      }
+    }
+
+    // Invalidated meanwhile, or no cache: writers are locked out while reading
+    Lock lock(_mutex);
+    bool found = true;
+    for (size_t k = 0; k < K; k++) {
+      size_t index = static_cast<size_t>(settings[k]);
+      bool present = _readValue(index, out[k]);
+      if constexpr (METRICS) _metrics.read(index, present);
+
+      if (!present) {
+        found = false;
+        _applyDefault(out[k], _list[index].default_value);
+      }
+    }
+    return found;
+  }
+
+  /**
+   * @brief Get the size of the value stored in NVS, without reading it. See
+   * `getValueSize(size_t, size_t&)`.
+   * @param setting Enum entry.
+   * @param size Set to the size in bytes.
+   * @retval `true` Key found in NVS.
+   * @retval `false` Handle not open or key not found.
+   */
+  bool getValueSize(ENUM setting, size_t& size) {
+    return getValueSize(static_cast<size_t>(setting), size);
+  }
+
+  /**
+   * @brief Get the operation counters of a single setting (`Option::Metrics`). See
+   * `getKeyMetrics(size_t, KeyMetrics&)`.
+   * @param setting Enum entry.
+   * @param metrics Set to the counters of the setting.
+   * @retval `true` Counters copied.
+   * @retval `false` Created without `Option::Metrics`.
+   */
+  bool getKeyMetrics(ENUM setting, KeyMetrics& metrics) const {
+    return getKeyMetrics(static_cast<size_t>(setting), metrics);
+  }
+
+  /**
+   * @brief Get the flash wear of a setting (`Option::Wear`): values written to NVS and the entries
+   * they appended since construction or the last `resetWear()`, and its write budget.
+   * @param setting Enum entry.
+   * @param wear Set to the counters of the setting.
+   */
+  void getKeyWear(ENUM setting, KeyWear& wear) const {
+    static_assert(WEAR, "getKeyWear() requires Option::Wear");
+    _wear.copyTo(static_cast<size_t>(setting), wear);
+  }
+
+  /**
+   * @brief Set the write budget of a setting (`Option::Wear`). The first write over the budget in
+   * a period fires the wear alert callback (`NVS::setWearAlertCallback()`). Writes are not refused.
+   * @param setting Enum entry.
+   * @param max_writes Writes allowed per period, 0 to remove the budget.
+   * @param period_s Budget period in seconds.
+   */
+  void setWriteBudget(ENUM setting, uint32_t max_writes, uint32_t period_s = 3600) {
+    static_assert(WEAR, "setWriteBudget() requires Option::Wear");
+    _wear.setBudget(static_cast<size_t>(setting), max_writes, period_s, _nowSeconds());
+  }
+
+  /**
+   * @brief Reset the wear counters of every setting (`Option::Wear`). Budgets are kept and their
+   * periods restart. Namespace and partition counters are reset by `NVS::resetWear()`.
+   */
+  void resetWear() {
+    static_assert(WEAR, "resetWear() requires Option::Wear");
+    _wear.reset(_nowSeconds());
+  }
+
+  /**
+   * @brief Read part of a value (`Option::Chunked`), reading only the chunks it spans: a 64-byte
+   * slice of a 16 KB table costs one chunk read, straight into `buf` unless it straddles chunks.
+   * @param setting Enum entry.
+   * @param offset First byte to read.
+   * @param buf Destination buffer.
+   * @param size Number of bytes to read.
+   * @retval `true` Read.
+   * @retval `false` Handle not open, key not found or not written since `Option::Chunked` was
+   * enabled, range past the end of the value, or a chunk failed its CRC check.
+   */
+  bool readRange(ENUM setting, size_t offset, uint8_t* buf, size_t size) {
+    static_assert(CHUNKED, "readRange() requires Option::Chunked");
+    size_t index = static_cast<size_t>(setting);
+    Lock lock(_mutex);
+
+    int64_t start = _metricsStart();
+    bool found    = _is_open && _policy.readRange(_handle, _list[index].key, offset, buf, size);
+    if constexpr (METRICS) {
+      _metrics.get.add(_elapsed(start));
+      _metrics.read(index, found);
+    }
+    return found;
+  }
+
+  /**
+   * @brief Overwrite part of a stored value in place and commit it (`Option::Chunked`), without
+   * the whole value in RAM: only the chunks whose content changed are rewritten. Change callbacks
+   * do not fire, as they take the whole value.
+   * @param setting Enum entry.
+   * @param offset First byte to overwrite.
+   * @param data New bytes. The range must lie within the stored value: use `setValue()` to resize.
+   * @return `WriteResult`: `Written`, `Unchanged` (the bytes were already stored), or `Failed` if
+   * the handle is not open, a transaction is in progress, the key is not found or not written
+   * since `Option::Chunked` was enabled, the range is past the end of the value, or NVS error.
+   */
+  WriteResult writeRange(ENUM setting, size_t offset, const ByteStreamView data) {
+    static_assert(CHUNKED, "writeRange() requires Option::Chunked");
+    size_t index = static_cast<size_t>(setting);
+    Lock lock(_mutex);
+    if (!_is_open || _in_transaction) return WriteStatus::Failed;
+
+    int64_t start      = _metricsStart();
+    bool changed       = false;
+    WriteResult result = WriteStatus::Failed;
+
+    if (_policy.writeRange(_handle, _list[index].key, offset, data, changed)) {
+      result = changed ? WriteStatus::Written : WriteStatus::Unchanged;
+    }
+    if (changed) {
+      if constexpr (WEAR) _countWear(index, _policy.lastEntries());
+      if (result && !_commit()) result = WriteStatus::Failed;
+    }
+    if (changed || !result) _forget(index);
+
+    if constexpr (METRICS) {
+      _metrics.set.add(_elapsed(start));
+      _metrics.write(index);
+      if (result.status() == WriteStatus::Unchanged) _metrics.unchanged();
+      if (!result) _metrics.failure(index);
+    }
+    return result;
+  }
+
+  /**
+   * @brief Read every value into `values`, with fallback to the default value for keys not found
+   * in NVS.
+   *
+   * Instead of one keyed lookup per entry, the namespace is scanned once with the NVS entry
+   * iterator to learn which keys exist: only those are read, and absent keys get their default
+   * without touching NVS. With `Option::Cache`, the scan also records absent keys in the cache, and
+   * is skipped altogether once every entry is cached. With `Option::Packed` or `Option::Record`,
+   * values are served from the RAM image.
+   *
+   * For NVS::Str and NVS::ByteStream: set `data` and `max_size` of every element to a caller-owned
+   * buffer before calling.
+   *
+   * @param values Destination array, in list order.
+   * @param found If not null, set to the number of values read from NVS (the others are defaults).
+   * @retval `true` Every value read from NVS or set to its default.
+   * @retval `false` Handle not open, or NVS error.
+   */
+  bool snapshot(std::array<T, N>& values, size_t* found = nullptr) {
+    return _snapshot(values.data(), found);
+  }
+
   /**
    * @brief Format a single setting to its default value.
    * @param force Ignore the formattable flag and write regardless.
-   * @retval `true` Written successfully.
-   * @retval `false` Not formattable (without force), out of bounds, or NVS error.
+   * @return `WriteResult`: `Written`, `Unchanged` (`Option::ElideWrites`), `Staged`, or `Failed`
+   * if not formattable (without force), out of bounds, or NVS error.
    */
-  bool format(ENUM setting, bool force = false) {
+  WriteResult format(ENUM setting, bool force = false) {
     return format(static_cast<size_t>(setting), force);
   }
 
@@ -372,37 +1026,198 @@ class Settings : public ISettings {
   bool isFormattable(ENUM setting) const { return _list[static_cast<size_t>(setting)].formattable; }
 
   /**
-   * @brief Register a callback for a specific setting.
+   * @brief Register a callback for a specific setting, replacing its previous one. Registered
+   * callbacks take heap from a pool that grows on demand, up to `CALLBACK_SLOTS` of them
+   * (every setting, unless `SETTINGS_CALLBACK_SLOTS` is defined).
+   * @param callback Callback: a function pointer, or a lambda capturing at most two pointers.
    * @param callable_on_format Whether to invoke when a format operation writes this setting.
+   * @retval `true` Registered.
+   * @retval `false` `SETTINGS_CALLBACK_SLOTS` callbacks are already registered for other settings.
    */
-  void setOnChangeCallback(ENUM setting, OnChangeCb callback, bool callable_on_format) {
-    size_t index                             = static_cast<size_t>(setting);
-    _on_change_cbs[index]                    = callback;
-    _on_change_cbs_callable_on_format[index] = callable_on_format;
+  bool setOnChangeCallback(ENUM setting, OnChangeCb callback, bool callable_on_format) {
+    static_assert(CALLBACKS, "setOnChangeCallback() is not available with Option::NoCallbacks");
+    Lock lock(_mutex);
+    std::lock_guard<DeferMutex> defer_lock(_defer_mutex);
+    std::lock_guard<AsyncMutex> async_lock(_async_mutex);
+    return _on_change_cbs.set(static_cast<size_t>(setting), callback, callable_on_format);
   }
 
   /**
-   * @brief Remove the callback for a specific setting.
+   * @brief Remove the callback for a specific setting, freeing its pool entry.
    */
   void clearOnChangeCallback(ENUM setting) {
-    size_t index                             = static_cast<size_t>(setting);
-    _on_change_cbs[index]                    = nullptr;
-    _on_change_cbs_callable_on_format[index] = false;
+    static_assert(CALLBACKS, "clearOnChangeCallback() is not available with Option::NoCallbacks");
+    Lock lock(_mutex);
+    std::lock_guard<DeferMutex> defer_lock(_defer_mutex);
+    std::lock_guard<AsyncMutex> async_lock(_async_mutex);
+    _on_change_cbs.remove(static_cast<size_t>(setting));
+  }
+
+  /**
+   * @brief Register a callback that fires on the writer task once a queued write is done
+   * (`Option::Async`): `Written`, `Unchanged` (`Option::ElideWrites`) or `Failed`. Writes of the
+   * same key collapsed by the writer report once.
+   * @param callback Callback function, or `nullptr` to remove it.
+   */
+  void setWriteDoneCallback(WriteDoneCb callback) {
+    static_assert(ASYNC, "setWriteDoneCallback() requires Option::Async");
+    static_assert(CALLBACKS, "setWriteDoneCallback() is not available with Option::NoCallbacks");
+    std::lock_guard<AsyncMutex> lock(_async_mutex);
+    _write_done_cb = callback;
+  }
+
+  /**
+   * @brief Set the coalescing window of every setting (`Option::Async`). A written value is kept in
+   * RAM for up to `window_ms` before the writer stores it, and further writes of the same key
+   * meanwhile only replace it: a burst costs a single NVS write of its last value. Change callbacks
+   * of a key with a window fire on every `setValue()`, from the calling task, instead of after the
+   * write. `NVS::flush()` writes pending values at once. 0 (default) disables coalescing.
+   * @param window_ms Window in milliseconds, counted from the first write of a burst.
+   */
+  void setCoalesceWindow(uint32_t window_ms) {
+    static_assert(ASYNC, "setCoalesceWindow() requires Option::Async");
+    std::lock_guard<AsyncMutex> lock(_async_mutex);
+    _coalesce_ms.fill(window_ms);
+  }
+
+  /**
+   * @brief Set the coalescing window of a single setting (`Option::Async`). See
+   * `setCoalesceWindow(uint32_t)`.
+   * @param setting Enum entry.
+   * @param window_ms Window in milliseconds, 0 to disable coalescing.
+   */
+  void setCoalesceWindow(ENUM setting, uint32_t window_ms) {
+    static_assert(ASYNC, "setCoalesceWindow() requires Option::Async");
+    std::lock_guard<AsyncMutex> lock(_async_mutex);
+    _coalesce_ms[static_cast<size_t>(setting)] = window_ms;
+  }
+
+  /**
+   * @brief Get the write counters (`Option::Async`). `coalesced` counts the NVS writes avoided.
+   * @return `WriteStats` since construction or the last `resetWriteStats()`.
+   */
+  WriteStats getWriteStats() const {
+    static_assert(ASYNC, "getWriteStats() requires Option::Async");
+    std::lock_guard<AsyncMutex> lock(_async_mutex);
+    return _async.stats;
+  }
+
+  /// @brief Reset the write counters (`Option::Async`).
+  void resetWriteStats() {
+    static_assert(ASYNC, "resetWriteStats() requires Option::Async");
+    std::lock_guard<AsyncMutex> lock(_async_mutex);
+    _async.stats = WriteStats();
   }
 
   private:
+  Settings(const char* ns_name, const char* partition_name)
+      : _ns_name(ns_name)
+      , _part_name(partition_name)
+      , _handle(0)
+      , _is_open(false)
+      , _in_transaction(false)
+      , _image_loaded(false)
+      , _image_dirty(false) {
+    _staged.fill(Staged::None);
+    _async_state.fill(Staged::None);
+    _async_notified.fill(false);
+    _inflight_state.fill(Staged::None);
+    _deferred_state.fill(Staged::None);
+    _coalesce_ms.fill(0);
+  }
+
+  // Pending write of an entry inside a transaction
+  enum class Staged : uint8_t { None, Set, Format };
+
   const char* _ns_name;
+  const char* _part_name;
   nvs_handle_t _handle;
   bool _is_open;
 
-  GlobalOnChangeCb _global_on_change_cb;
-  bool _global_on_change_cb_callable_on_format;
+  // Only allocated with Option::Transactions
+  bool _in_transaction;
+  std::array<Staged, TRANSACTED ? N : 0> _staged;
+  std::array<WriteType, TRANSACTED ? N : 0> _staged_values;
 
-  std::array<OnChangeCb, N> _on_change_cbs;
-  std::array<bool, N> _on_change_cbs_callable_on_format;
+  // Sparse: only settings with a callback take a pool entry. Nothing at all with
+  // Option::NoCallbacks.
+  struct GlobalSlot {
+    GlobalOnChangeCb callback;
+    bool on_format = false;
+  };
+  std::conditional_t<CALLBACKS, GlobalSlot, Internal::Empty> _global_on_change_cb;
+  std::conditional_t<CALLBACKS, Internal::CallbackTable<OnChangeCb, N, CALLBACK_SLOTS>,
+                     Internal::Empty>
+    _on_change_cbs;
 
   std::array<Struct, N> _list;
+
+  // Only allocated with Option::KeyIndex
+  std::conditional_t<KEY_INDEXED, Internal::KeyIndex<N>, Internal::Empty> _key_index;
   Policy _policy;
+  std::array<bool, LEGACY_STRINGS ? N : 0> _legacy_checked{}; // No legacy string under the key
+
+  // Only a real lock with Option::ThreadSafe. Recursive: callbacks run with it held and may use
+  // the object again.
+  using Mutex = std::conditional_t<THREAD_SAFE, std::recursive_mutex, Internal::NoMutex>;
+  using Lock  = std::lock_guard<Mutex>;
+  mutable Mutex _mutex;
+
+  // Only allocated with Option::Cache, for scalars. Read without locking with Option::ThreadSafe.
+  static constexpr bool VALUE_CACHED = CACHED && std::is_arithmetic_v<T>;
+  static constexpr size_t CACHE_SIZE = VALUE_CACHED ? N : 0;
+  using CacheStore = std::conditional_t<THREAD_SAFE, Internal::SeqValueCache<T, CACHE_SIZE>,
+                                        Internal::ValueCache<T, CACHE_SIZE>>;
+  CacheStore _cache;
+
+  // Only allocated with Option::Cache or Option::ElideWrites, for Str and ByteStream
+  static constexpr bool FINGERPRINTED = (CACHED || ELIDED) && !std::is_arithmetic_v<T>;
+  std::array<Internal::Fingerprint, FINGERPRINTED ? N : 0> _fingerprints;
+
+  // Only used with Option::Packed or Option::Record: every value in RAM, stored under one key
+  static constexpr bool IMAGED = PACKED || RECORD;
+  using Image = std::conditional_t<RECORD, Internal::RecordImage<T, N>,
+                                   Internal::PackedFlags<PACKED ? N : 0>>;
+  Image _image;
+  bool _image_loaded;
+  bool _image_dirty;
+
+  // Only used with Option::Async: values waiting for the writer, and the ones it is writing, both
+  // served to readers until committed. The mutex guards them and the callbacks against the writer
+  // task, and is never held while a callback runs.
+  using AsyncMutex = std::conditional_t<ASYNC, std::mutex, Internal::NoMutex>;
+  mutable AsyncMutex _async_mutex;
+  std::array<Staged, ASYNC ? N : 0> _async_state;
+  std::array<T, ASYNC ? N : 0> _async_values;
+  std::array<int64_t, ASYNC ? N : 0> _async_due;    // When the writer may write the value
+  std::array<bool, ASYNC ? N : 0> _async_notified;  // Change callbacks already fired
+  std::array<uint32_t, ASYNC ? N : 0> _coalesce_ms; // Coalescing window of each entry
+  std::array<Staged, ASYNC ? N : 0> _inflight_state;
+  std::array<T, ASYNC ? N : 0> _inflight_values;
+  std::array<bool, ASYNC ? N : 0> _inflight_notified;
+  std::array<WriteStatus, ASYNC ? N : 0> _inflight_results;
+  struct AsyncStatus {
+    bool inflight_visible = false; // The _inflight_* values are served to readers
+    bool open             = false; // Handle usable by the writer task
+    WriteStats stats;
+  };
+  std::conditional_t<ASYNC, AsyncStatus, Internal::Empty> _async;
+  std::conditional_t<ASYNC && CALLBACKS, WriteDoneCb, Internal::Empty> _write_done_cb;
+
+  // Only used with Option::DeferCallbacks: the latest change of each key not delivered yet. The
+  // mutex guards them and the callbacks against the delivering task, and is never held while a
+  // callback runs.
+  using DeferMutex = std::conditional_t<DEFERRED, std::mutex, Internal::NoMutex>;
+  mutable DeferMutex _defer_mutex;
+  std::array<Staged, DEFERRED ? N : 0> _deferred_state;
+  std::array<T, DEFERRED ? N : 0> _deferred_values;
+  std::conditional_t<DEFERRED, Internal::NotifyState, Internal::Empty> _notify;
+
+  // Only allocated with Option::Metrics
+  std::conditional_t<METRICS, Internal::MetricsStore<N>, Internal::Empty> _metrics;
+
+  // Only allocated with Option::Wear
+  std::conditional_t<WEAR, Internal::WearStore<N>, Internal::Empty> _wear;
 
   /* -------------------------------------- Private helpers ------------------------------------- */
 
@@ -422,26 +1237,622 @@ class Settings : public ISettings {
     }
   }
 
-  bool setValueImpl(ENUM setting, const WriteType value, bool called_from_format) {
+  // Load the packed flags or the record on first access
+  bool _imageReady() {
+    if (_image_loaded) return true;
     if (!_is_open) return false;
+    _image_loaded = _image.load(_handle);
+    return _image_loaded;
+  }
 
-    size_t index = static_cast<size_t>(setting);
+  // Read a value from NVS, or from the packed flags or the record
+  bool _load(size_t index, T& out) {
+    if constexpr (IMAGED) {
+      return _imageReady() && _image.get(index, out);
+    } else {
+      return _policy.getValue(_handle, _list[index].key, out);
+    }
+  }
+
+  // Write a value to NVS without committing it, or to the packed flags or the record, which
+  // _commit() stores
+  bool _store(size_t index, const WriteType& value) {
+    if constexpr (IMAGED) {
+      if (!_imageReady()) return false;
+      _image.set(index, value);
+      _image_dirty = true;
+      if constexpr (WEAR) _countWear(index, 0);
+      return true;
+    } else {
+      if constexpr (LEGACY_STRINGS) {
+        // Checked once per key and begin(), not on every write
+        if (!_legacy_checked[index]) {
+          if (!_policy.dropLegacy(_handle, _list[index].key)) return false;
+          _legacy_checked[index] = true;
+        }
+      }
+      if (!_policy.setValue(_handle, _list[index].key, value)) return false;
+      if constexpr (WEAR) {
+        if constexpr (CHUNKED || COMPRESSED) {
+          // Nothing reached flash if every chunk was unchanged
+          if (_policy.lastEntries() > 0) _countWear(index, _policy.lastEntries());
+        } else {
+          _countWear(index, Internal::entriesOf(value));
+        }
+      }
+      return true;
+    }
+  }
+
+  // Count a value written to NVS (Option::Wear). With Option::Packed or Option::Record, entries
+  // are counted for the whole image when _commit() stores it.
+  void _countWear(size_t index, uint32_t entries) {
+    if (!_wear.write(index, entries, _nowSeconds())) return;
 
-    if (!_policy.setValue(_handle, getKey(index), value)) return false;
+    KeyWear wear;
+    _wear.copyTo(index, wear);
+    Internal::wearAlert(_ns_name, _list[index].key, wear.budget, wear.period_s);
+  }
+
+  // Entries appended by a store of the packed flags or the record
+  static constexpr uint32_t _imageEntries() {
+    if constexpr (RECORD) {
+      return Internal::blobEntries(Image::SIZE);
+    } else if constexpr (PACKED) {
+      return Image::AS_U64 ? 1 : Internal::blobEntries(Image::BLOB_SIZE);
+    } else {
+      return 0;
+    }
+  }
 
-    bool call_global = called_from_format ? _global_on_change_cb_callable_on_format : true;
-    bool call_local  = called_from_format ? _on_change_cbs_callable_on_format[index] : true;
+  static uint32_t _nowSeconds() { return static_cast<uint32_t>(esp_timer_get_time() / 1000000); }
 
-    if (call_global && _global_on_change_cb) {
-      _global_on_change_cb(getKey(setting), getType(), index, &value);
+  // Single-value reads of the public API: _readValue(), counted and timed with Option::Metrics
+  bool _get(size_t index, T& out) {
+    if constexpr (METRICS) {
+      int64_t start = esp_timer_get_time();
+      bool found    = _readValue(index, out);
+      _metrics.get.add(_elapsed(start));
+      _metrics.read(index, found);
+      return found;
+    } else {
+      return _readValue(index, out);
     }
+  }
 
-    if (call_local && _on_change_cbs[index]) {
-      _on_change_cbs[index](getKey(setting), setting, value);
+  // Start time of an operation with Option::Metrics, nothing without it
+  static int64_t _metricsStart() {
+    if constexpr (METRICS) {
+      return esp_timer_get_time();
+    } else {
+      return 0;
     }
+  }
+
+  static uint32_t _elapsed(int64_t start) {
+    return static_cast<uint32_t>(esp_timer_get_time() - start);
+  }
+
+  // Read a value from the cache or NVS. Returns false if the key is not in NVS.
+  bool _readValue(size_t index, T& out) {
+    if constexpr (ASYNC) {
+      if (_readQueued(index, out)) return true;
+    }
+
+    if constexpr (VALUE_CACHED) {
+      // Without blocking with Option::ThreadSafe
+      Internal::CacheState state;
+      _cacheRead([&] { state = _cache.peek(index, out); });
+
+      if (state == Internal::CacheState::Present) return true;
+      if (state == Internal::CacheState::Absent) return false;
+
+      Lock lock(_mutex);
+      if (!_is_open) return false;
+
+      bool found = _load(index, out);
+      _cache.beginWrite();
+      if (found) {
+        _cache.set(index, out);
+      } else {
+        _cache.setState(index, Internal::CacheState::Absent);
+      }
+      _cache.endWrite();
+      return found;
+    } else {
+      Lock lock(_mutex);
+      if (!_load(index, out)) return false;
+      if constexpr (FINGERPRINTED) _fingerprints[index] = _fingerprintOf(out);
+      return true;
+    }
+  }
+
+  // Run a group of cache peeks that must see a consistent state: lock-free with
+  // Option::ThreadSafe, unless writes keep overlapping
+  template <typename F>
+  void _cacheRead(F&& f) const {
+    if (_cache.tryRead(f)) return;
+    Lock lock(_mutex);
+    f();
+  }
 
+  // Read every value, or its default. Keys are matched against one scan of the namespace, so that
+  // absent keys cost no lookup.
+  bool _snapshot(T* values, size_t* found) {
+    Lock lock(_mutex);
+    if (!_is_open) return false;
+
+    std::array<bool, N> stored{};
+
+    if constexpr (IMAGED) {
+      if (!_imageReady()) return false;
+      stored.fill(true);
+    } else {
+      bool scan = true;
+
+      if constexpr (VALUE_CACHED) {
+        scan = false;
+        for (size_t i = 0; i < N && !scan; i++) {
+          T value;
+          scan = (_cache.peek(i, value) == Internal::CacheState::Unknown);
+        }
+      }
+
+      if (scan) {
+        nvs_iterator_t it = nullptr;
+        esp_err_t err     = nvs_entry_find_in_handle(_handle, NVS_TYPE_ANY, &it);
+
+        while (err == ESP_OK) {
+          nvs_entry_info_t info;
+          size_t index;
+          nvs_entry_info(it, &info);
+          if (hasKey(info.key, index)) stored[index] = true;
+          err = nvs_entry_next(&it);
+        }
+
+        nvs_release_iterator(it);
+        if (err != ESP_ERR_NVS_NOT_FOUND) return false;
+      } else {
+        stored.fill(true);
+      }
+
+      if constexpr (ASYNC) {
+        std::lock_guard<AsyncMutex> lock(_async_mutex);
+        for (size_t i = 0; i < N; i++) {
+          if (_async_state[i] != Staged::None) stored[i] = true;
+          if (_async.inflight_visible && _inflight_state[i] != Staged::None) stored[i] = true;
+        }
+      }
+
+      if constexpr (VALUE_CACHED) {
+        _cache.beginWrite();
+        for (size_t i = 0; i < N; i++) {
+          T value;
+          if (!stored[i] && _cache.peek(i, value) == Internal::CacheState::Unknown) {
+            _cache.setState(i, Internal::CacheState::Absent);
+          }
+        }
+        _cache.endWrite();
+      }
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < N; i++) {
+      bool present = stored[i] && _readValue(i, values[i]);
+      if constexpr (METRICS) _metrics.read(i, present);
+
+      if (present) {
+        count++;
+      } else {
+        _applyDefault(values[i], _list[i].default_value);
+      }
+    }
+
+    if (found) *found = count;
     return true;
   }
+
+  static Internal::Fingerprint _fingerprintOf(const WriteType& value) {
+    Internal::Fingerprint fp;
+    fp.valid = true;
+
+    if constexpr (std::is_same_v<T, Str>) {
+      fp.size = value.data ? strlen(value.data) : 0;
+    } else {
+      fp.size = value.data ? value.size : 0;
+    }
+
+    fp.crc = Internal::crc32(value.data, fp.size);
+    return fp;
+  }
+
+  // Whether `value` is the value currently stored in NVS (Option::ElideWrites)
+  bool _isUnchanged(size_t index, const WriteType& value) {
+    if constexpr (FINGERPRINTED) {
+      const Internal::Fingerprint& stored = _fingerprints[index];
+      if (!stored.valid) return false;
+
+      Internal::Fingerprint fp = _fingerprintOf(value);
+      return fp.size == stored.size && fp.crc == stored.crc;
+    } else {
+      // Bitwise, so that e.g. 0.0 and -0.0 are different values
+      T stored;
+      if (!_readValue(index, stored)) return false;
+      return memcmp(&stored, &value, sizeof(T)) == 0;
+    }
+  }
+
+  // Write a value to NVS without committing it. Once committed, _remember() it.
+  bool _writeValue(size_t index, const WriteType& value) {
+    if (_store(index, value)) return true;
+
+    // The write may have partially succeeded: reload from NVS on the next read
+    _forget(index);
+    return false;
+  }
+
+  // Keep a committed value in the cache and fingerprints
+  void _remember(size_t index, const WriteType& value) {
+    if constexpr (VALUE_CACHED) {
+      _cache.beginWrite();
+      _cache.set(index, value);
+      _cache.endWrite();
+    }
+
+    if constexpr (FINGERPRINTED) _fingerprints[index] = _fingerprintOf(value);
+  }
+
+  // Drop what the cache and fingerprints know about an entry
+  void _forget(size_t index) {
+    if constexpr (VALUE_CACHED) {
+      _cache.beginWrite();
+      _cache.setState(index, Internal::CacheState::Unknown);
+      _cache.endWrite();
+    }
+
+    if constexpr (FINGERPRINTED) _fingerprints[index].valid = false;
+  }
+
+  bool _commit() {
+    if constexpr (IMAGED) {
+      if (_image_dirty) {
+        _image_dirty = false;
+        if (!_image.store(_handle)) {
+          invalidateCache();
+          return false;
+        }
+        if constexpr (WEAR) _wear.image(_imageEntries());
+      }
+    }
+
+    int64_t start  = _metricsStart();
+    bool committed = (nvs_commit(_handle) == ESP_OK);
+    if constexpr (METRICS) {
+      _metrics.commit_time.add(_elapsed(start));
+      _metrics.commit();
+      if (!committed) _metrics.failure();
+    }
+
+    if (committed) return true;
+    invalidateCache();
+    return false;
+  }
+
+  void _notifyChange(size_t index, const WriteType& value, bool called_from_format) {
+    if constexpr (DEFERRED) {
+      {
+        std::lock_guard<DeferMutex> lock(_defer_mutex);
+        bool set                = !called_from_format || _deferred_state[index] == Staged::Set;
+        _deferred_values[index] = value;
+        _deferred_state[index]  = set ? Staged::Set : Staged::Format;
+      }
+
+      // Queue a delivery unless one is pending
+      if (!_notify.queued.exchange(true)) {
+        Internal::enqueueNotify({this, &Settings::_deliverDeferred, &_notify});
+      }
+    } else if constexpr (CALLBACKS) {
+      // Copies: a callback may replace or clear itself. With Option::Async, taken under the lock
+      // the setters share with the writer task, which runs this for written values.
+      GlobalOnChangeCb global;
+      OnChangeCb local;
+      {
+        std::lock_guard<AsyncMutex> lock(_async_mutex);
+        global = _globalCallback(called_from_format);
+        local  = _on_change_cbs.get(index, called_from_format);
+      }
+      _invokeCallbacks(index, value, global, local);
+    }
+  }
+
+  GlobalOnChangeCb _globalCallback(bool called_from_format) const {
+    if (called_from_format && !_global_on_change_cb.on_format) return nullptr;
+    return _global_on_change_cb.callback;
+  }
+
+  void _invokeCallbacks(size_t index, const WriteType& value, const GlobalOnChangeCb& global,
+                        const OnChangeCb& local) {
+    ENUM setting = static_cast<ENUM>(index);
+    if (global) global(getKey(setting), getType(), index, &value);
+    if (local) local(getKey(setting), setting, value);
+  }
+
+  // Run the callbacks of every change recorded since the last delivery (Option::DeferCallbacks),
+  // on the task calling NVS::poll() or the notification task, one task at a time (see
+  // Internal::enqueueNotify()). Returns the number of changes.
+  static size_t _deliverDeferred(void* target) {
+    Settings& self = *static_cast<Settings*>(target);
+
+    size_t delivered = 0;
+    for (size_t i = 0; i < N; i++) {
+      T value;
+      GlobalOnChangeCb global;
+      OnChangeCb local;
+      {
+        std::lock_guard<DeferMutex> lock(self._defer_mutex);
+        if (self._deferred_state[i] == Staged::None) continue;
+
+        bool from_format        = (self._deferred_state[i] == Staged::Format);
+        self._deferred_state[i] = Staged::None;
+        value                   = self._deferred_values[i];
+        global                  = self._globalCallback(from_format);
+        local                   = self._on_change_cbs.get(i, from_format);
+      }
+
+      self._invokeCallbacks(i, value, global, local);
+      delivered++;
+    }
+
+    return delivered;
+  }
+
+  // Write all staged values, commit once and end the transaction. Returns the number of failures.
+  size_t _commitStaged() {
+    Lock lock(_mutex);
+    _in_transaction = false;
+
+    std::array<Staged, N> batch{};
+    std::copy(_staged.begin(), _staged.end(), batch.begin());
+    _staged.fill(Staged::None);
+    return _writeBatch(batch, [this](size_t i) -> const WriteType& { return _staged_values[i]; });
+  }
+
+  // Write the entries of a batch (`value(i)` for each entry not `Staged::None`), commit once, then
+  // run their callbacks. Returns the number of failures.
+  template <typename VALUE>
+  size_t _writeBatch(std::array<Staged, N>& batch, VALUE&& value) {
+    size_t errors  = 0;
+    size_t written = 0;
+
+    for (size_t i = 0; i < N; i++) {
+      if (batch[i] == Staged::None) continue;
+
+      if constexpr (ELIDED) {
+        if (_isUnchanged(i, value(i))) {
+          batch[i] = Staged::None;
+          continue;
+        }
+      }
+
+      if (_writeValue(i, value(i))) {
+        written++;
+      } else {
+        batch[i] = Staged::None;
+        errors++;
+        if constexpr (METRICS) _metrics.failure(i);
+      }
+    }
+
+    if (written > 0 && !_commit()) return errors + written;
+
+    // One cache section: readers see every value of the batch, or none
+    _cache.beginWrite();
+    for (size_t i = 0; i < N; i++) {
+      if (batch[i] != Staged::None) _remember(i, value(i));
+    }
+    _cache.endWrite();
+
+    // Callbacks run after the commit and may write to this object again
+    for (size_t i = 0; i < N; i++) {
+      if (batch[i] == Staged::None) continue;
+      _notifyChange(i, value(i), batch[i] == Staged::Format);
+    }
+
+    return errors;
+  }
+
+  // Serve a value the writer has not committed yet
+  bool _readQueued(size_t index, T& out) const {
+    std::lock_guard<AsyncMutex> lock(_async_mutex);
+
+    if (_async_state[index] != Staged::None) {
+      out = _async_values[index];
+      return true;
+    }
+
+    if (_async.inflight_visible && _inflight_state[index] != Staged::None) {
+      out = _inflight_values[index];
+      return true;
+    }
+
+    return false;
+  }
+
+  // Stage a value for the writer. A value replacing one not written yet keeps its due time.
+  WriteResult _queueWrite(size_t index, const WriteType& value, bool called_from_format) {
+    bool notify_now;
+
+    {
+      std::lock_guard<AsyncMutex> lock(_async_mutex);
+      if (!_async.open) return WriteStatus::Failed;
+
+      bool replaced        = (_async_state[index] != Staged::None);
+      _async_values[index] = value;
+      _async_state[index]  = called_from_format ? Staged::Format : Staged::Set;
+
+      // Coalesced keys notify every logical change now, the writer only sees the last one
+      notify_now              = (_coalesce_ms[index] > 0);
+      _async_notified[index] |= notify_now;
+
+      if (replaced) {
+        _async.stats.queued++;
+        _async.stats.coalesced++;
+      } else {
+        int64_t due = esp_timer_get_time() + int64_t(_coalesce_ms[index]) * 1000;
+        if (!Internal::enqueueAsync({this, &Settings::_drainQueued}, due)) {
+          _async_state[index]    = Staged::None;
+          _async_notified[index] = false;
+          return WriteStatus::Failed;
+        }
+
+        _async_due[index] = due;
+        _async.stats.queued++;
+      }
+    }
+
+    if (notify_now) _notifyChange(index, value, called_from_format);
+    return WriteStatus::Queued;
+  }
+
+  // Writer task: write the staged values that are due with one commit, then run the callbacks.
+  // Returns when the next staged value is due, or -1.
+  static int64_t _drainQueued(void* target, bool force) {
+    Settings& self = *static_cast<Settings*>(target);
+    int64_t next   = -1;
+    bool open;
+
+    {
+      std::lock_guard<AsyncMutex> lock(self._async_mutex);
+      int64_t now = esp_timer_get_time();
+
+      // end() waits for this drain before closing the handle, so it stays valid until the end
+      open = self._async.open;
+
+      for (size_t i = 0; i < N; i++) {
+        self._inflight_state[i] = Staged::None;
+        if (self._async_state[i] == Staged::None) continue;
+
+        if (!force && self._async_due[i] > now) {
+          next = (next < 0) ? self._async_due[i] : std::min(next, self._async_due[i]);
+          continue;
+        }
+
+        self._inflight_state[i]    = self._async_state[i];
+        self._inflight_values[i]   = self._async_values[i];
+        self._inflight_notified[i] = self._async_notified[i];
+        self._async_state[i]       = Staged::None;
+        self._async_notified[i]    = false;
+      }
+
+      self._async.inflight_visible = true;
+    }
+
+    size_t written = 0;
+
+    for (size_t i = 0; i < N; i++) {
+      if (self._inflight_state[i] == Staged::None) continue;
+      const T& value = self._inflight_values[i];
+
+      if constexpr (ELIDED) {
+        // Bitwise, as _isUnchanged(), but against NVS: _readValue() would see the value itself
+        T stored;
+        if (open && self._load(i, stored) && memcmp(&stored, &value, sizeof(T)) == 0) {
+          self._inflight_results[i] = WriteStatus::Unchanged;
+          continue;
+        }
+      }
+
+      if (open && self._store(i, value)) {
+        self._inflight_results[i] = WriteStatus::Written;
+        written++;
+      } else {
+        self._inflight_results[i] = WriteStatus::Failed;
+      }
+    }
+
+    bool committed = (written == 0) || self._commit();
+
+    WriteDoneCb done;
+    {
+      std::lock_guard<AsyncMutex> lock(self._async_mutex);
+      self._async.inflight_visible = false;
+      if constexpr (CALLBACKS) done = self._write_done_cb;
+
+      for (size_t i = 0; i < N; i++) {
+        if (self._inflight_state[i] == Staged::None) continue;
+        WriteStatus& status = self._inflight_results[i];
+        if (status == WriteStatus::Written && !committed) status = WriteStatus::Failed;
+
+        if (status == WriteStatus::Written) self._async.stats.written++;
+        if (status == WriteStatus::Unchanged) self._async.stats.unchanged++;
+        if (status == WriteStatus::Failed) self._async.stats.failed++;
+
+        if constexpr (METRICS) {
+          if (status == WriteStatus::Unchanged) self._metrics.unchanged();
+          if (status == WriteStatus::Failed) self._metrics.failure(i);
+        }
+      }
+    }
+
+    // Callbacks run after the commit and may write to this object again
+    for (size_t i = 0; i < N; i++) {
+      if (self._inflight_state[i] == Staged::None) continue;
+      WriteStatus status = self._inflight_results[i];
+
+      bool from_format = (self._inflight_state[i] == Staged::Format);
+      if (status == WriteStatus::Written && !self._inflight_notified[i]) {
+        self._notifyChange(i, self._inflight_values[i], from_format);
+      }
+      if (done) done(self.getKey(static_cast<ENUM>(i)), static_cast<ENUM>(i), status);
+    }
+
+    return next;
+  }
+
+  // Every write: _setValue(), counted and timed with Option::Metrics
+  WriteResult setValueImpl(ENUM setting, const WriteType value, bool called_from_format) {
+    if constexpr (METRICS) {
+      size_t index       = static_cast<size_t>(setting);
+      int64_t start      = esp_timer_get_time();
+      WriteResult result = _setValue(setting, value, called_from_format);
+
+      _metrics.set.add(_elapsed(start));
+      _metrics.write(index);
+      if (result.status() == WriteStatus::Unchanged) _metrics.unchanged();
+      if (!result) _metrics.failure(index);
+      return result;
+    } else {
+      return _setValue(setting, value, called_from_format);
+    }
+  }
+
+  WriteResult _setValue(ENUM setting, const WriteType value, bool called_from_format) {
+    Lock lock(_mutex);
+    size_t index = static_cast<size_t>(setting);
+
+    // Checked under the writer's lock instead, as end() may run on another task
+    if constexpr (ASYNC) return _queueWrite(index, value, called_from_format);
+    if (!_is_open) return WriteStatus::Failed;
+
+    if constexpr (TRANSACTED) {
+      if (_in_transaction) {
+        _staged_values[index] = value;
+        _staged[index]        = called_from_format ? Staged::Format : Staged::Set;
+        return WriteStatus::Staged;
+      }
+    }
+
+    if constexpr (ELIDED) {
+      if (_isUnchanged(index, value)) return WriteStatus::Unchanged;
+    }
+
+    if (!_writeValue(index, value)) return WriteStatus::Failed;
+    if (!_commit()) return WriteStatus::Failed;
+    _remember(index, value);
+
+    _notifyChange(index, value, called_from_format);
+    return WriteStatus::Written;
+  }
 };
 
 } // namespace NVS
@@ -0,0 +1,73 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "ISettings.h"
+
+namespace NVS {
+
+/**
+ * @brief Scope guard for a Settings transaction. Starts the transaction on construction and
+ * aborts it on destruction unless `commit()` was called.
+ *
+ * @code
+ * {
+ *   NVS::Transaction tx(st_Network);
+ *   st_Network.setValue(Network::SSID, ssid);
+ *   st_Network.setValue(Network::Password, password);
+ *   tx.commit(); // One nvs_commit(), then the callbacks fire
+ * }
+ * @endcode
+ */
+class Transaction {
+  public:
+  /**
+   * @brief Start a transaction on a Settings object.
+   * @param settings Settings object. Must outlive the guard.
+   */
+  explicit Transaction(ISettings& settings)
+      : _settings(settings)
+      , _active(settings.beginTransaction()) {}
+
+  ~Transaction() { abort(); }
+
+  Transaction(const Transaction&)            = delete;
+  Transaction& operator=(const Transaction&) = delete;
+
+  /**
+   * @brief Commit the staged writes. See `ISettings::commit()`.
+   * @retval `true` All staged values written and committed.
+   * @retval `false` The transaction could not be started, was already ended, or a write failed.
+   */
+  bool commit() {
+    if (!_active) return false;
+    _active = false;
+    return _settings.commit();
+  }
+
+  /**
+   * @brief Discard the staged writes. No-op if the transaction was already ended.
+   */
+  void abort() {
+    if (!_active) return;
+    _active = false;
+    _settings.abort();
+  }
+
+  /**
+   * @brief Check whether the transaction was started and has not ended yet.
+   * @retval `true` Transaction in progress.
+   * @retval `false` Otherwise.
+   */
+  bool isActive() const { return _active; }
+
+  private:
+  ISettings& _settings;
+  bool _active;
+};
+
+} // namespace NVS
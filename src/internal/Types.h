@@ -15,6 +15,71 @@ namespace NVS {
 /// @brief Type of a Settings object. Useful when using ISettings pointers.
 enum class Type : uint8_t { Bool, UInt32, Int32, Float, Double, String, ByteStream };
 
+/**
+ * @brief Compile-time options of a Settings object, passed as its fourth template argument.
+ * Combine several options with `|`, e.g. `NVS::Option::Cache | NVS::Option::ElideWrites`.
+ */
+enum class Option : uint32_t {
+  None           = 0,
+  Cache          = 1u << 0,  // Keep each value in RAM (length and CRC32 for Str and ByteStream).
+  ElideWrites    = 1u << 1,  // Skip writes of values equal to the stored ones.
+  Packed         = 1u << 2,  // Store all flags of a Settings<bool> under a single NVS key.
+  Record         = 1u << 3,  // Store all values as one versioned blob. Scalar types only.
+  Async          = 1u << 4,  // Write from a background task; setValue() returns at once. Scalars.
+  ThreadSafe     = 1u << 5,  // Safe to share between tasks; cached reads never block.
+  NoCallbacks    = 1u << 6,  // No change callbacks: no RAM for them, no dispatch code.
+  DeferCallbacks = 1u << 7,  // Run change callbacks later, from NVS::poll(). Scalar types only.
+  Metrics        = 1u << 8,  // Count operations per key and time them, see getMetrics().
+  Wear           = 1u << 9,  // Count flash entries written per key, see getKeyWear().
+  Chunked        = 1u << 10, // Store ByteStream values in chunks: ranged reads and writes.
+  Compressed     = 1u << 11, // Store Str and ByteStream values compressed when that saves flash.
+  KeyIndex       = 1u << 12, // Resolve hasKey() in constant time through a hash index in RAM.
+  Transactions   = 1u << 13, // Stage writes in RAM and commit them at once, see beginTransaction().
+  Registry       = 1u << 14, // Join the key registry on begin(), see NVS::findSetting().
+};
+
+constexpr Option operator|(const Option a, const Option b) {
+  return static_cast<Option>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+}
+
+/**
+ * @brief Check whether an option set contains a given option.
+ * @param set Option set.
+ * @param option Option to look for.
+ * @retval `true` `option` is part of `set`.
+ * @retval `false` Otherwise.
+ */
+constexpr bool hasOption(const Option set, const Option option) {
+  return (static_cast<uint32_t>(set) & static_cast<uint32_t>(option)) != 0;
+}
+
+/// @brief Outcome of a write operation (`setValue()`, `setValuePtr()`, `format()`).
+enum class WriteStatus : uint8_t {
+  Failed,    // Handle not open, index out of bounds, not formattable, or NVS error
+  Written,   // Written to NVS and committed
+  Unchanged, // Equal to the stored value, nothing written (`Option::ElideWrites`)
+  Staged,    // Transaction in progress, written on `commit()`
+  Queued     // Handed to the background writer, written later (`Option::Async`)
+};
+
+/**
+ * @brief Result of a write operation. Converts to `true` unless the write failed, so it can be used
+ * as a plain `bool`; `status()` tells a write apart from a skipped or staged one.
+ */
+class WriteResult {
+  public:
+  constexpr WriteResult(const WriteStatus status)
+      : _status(status) {}
+
+  constexpr operator bool() const { return _status != WriteStatus::Failed; }
+
+  /// @brief Get the outcome of the write.
+  constexpr WriteStatus status() const { return _status; }
+
+  private:
+  WriteStatus _status;
+};
+
 /// @brief Read-only view of a string. Used for default values and write operations.
 struct StrView {
   // Pointer to a null-terminated string. Must be valid for the lifetime of the Settings object.
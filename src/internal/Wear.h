@@ -0,0 +1,270 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <nvs.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+#include "Callback.h"
+#include "Types.h"
+
+/**
+ * @brief Number of namespaces whose flash wear is tracked (`Option::Wear`). Objects of further
+ * namespaces still count towards the partition totals. Define it before including the library, or
+ * as a build flag, to change it.
+ */
+#ifndef SETTINGS_WEAR_NAMESPACES
+#define SETTINGS_WEAR_NAMESPACES 8
+#endif
+
+/**
+ * @brief Number of `NVS::sampleWear()` samples kept: the write rate of `NVS::estimateWear()` is
+ * measured from the oldest one. Define it before including the library, or as a build flag, to
+ * change it.
+ */
+#ifndef SETTINGS_WEAR_SAMPLES
+#define SETTINGS_WEAR_SAMPLES 8
+#endif
+
+namespace NVS {
+
+/**
+ * @brief Flash wear of a key of a Settings object created with `Option::Wear`.
+ *
+ * NVS appends every write to the current page as 32-byte entries and erases a page only once
+ * garbage collection has moved its live entries away, so wear follows the entries written, not the
+ * bytes: a `uint32_t` takes one entry, a string `1 + ceil(length / 32)`, a blob two more.
+ */
+struct KeyWear {
+  uint32_t writes        = 0; // Values written to NVS (elided and coalesced writes do not count)
+  uint32_t entries       = 0; // 32-byte entries appended by those writes
+  uint32_t budget        = 0; // Writes allowed per budget period, 0 for none
+  uint32_t period_s      = 0; // Budget period in seconds
+  uint32_t period_writes = 0; // Writes in the current budget period
+  uint32_t alerts        = 0; // Budget periods in which the budget was exceeded
+};
+
+/// @brief Flash wear of a namespace: every `Option::Wear` object using it.
+struct NamespaceWear {
+  uint32_t writes  = 0; // Values written to NVS
+  uint32_t entries = 0; // 32-byte entries appended
+};
+
+/**
+ * @brief Flash wear and lifetime estimate of a partition (`NVS::estimateWear()`).
+ *
+ * Pages are erased in turn: once the free entries are used up, garbage collection erases the
+ * oldest page, so every page is erased about once per `available_entries` entries written. The
+ * estimate only sees the writes of `Option::Wear` objects since boot (or `NVS::resetWear()`), on
+ * any partition.
+ */
+struct WearEstimate {
+  nvs_stats_t stats        = {}; // Partition statistics when estimated
+  uint32_t entries_written = 0;  // Entries written by Option::Wear objects
+  uint32_t window_s        = 0;  // Time the write rate was measured over
+  float entries_per_hour   = 0;  // Write rate over that time
+  float erase_cycles       = 0;  // Erase cycles of each page caused by entries_written
+  float cycles_per_year    = 0;  // Erase cycles of each page per year at the current rate
+  float lifetime_years     = 0;  // Years until pages reach their endurance at that rate
+};
+
+/**
+ * @brief Callback fired when a key of an `Option::Wear` object goes over its write budget
+ * (`Settings::setWriteBudget()`), once per budget period. Runs on the writing task (the background
+ * writer with `Option::Async`), with the object locked: keep it short.
+ * @param ns_name Namespace of the object.
+ * @param key Key written.
+ * @param budget Writes allowed per period.
+ * @param period_s Budget period in seconds.
+ */
+using WearAlertCb = Internal::Delegate<void(const char* ns_name, const char* key, uint32_t budget,
+                                             uint32_t period_s)>;
+
+/**
+ * @brief Set the callback fired when a key goes over its write budget.
+ * @param callback Callback, or `nullptr` to remove it.
+ */
+void setWearAlertCallback(const WearAlertCb& callback);
+
+/**
+ * @brief Record the entries written so far and the free space of a partition. Call it periodically
+ * (e.g. hourly): `estimateWear()` measures the write rate from the oldest sample kept, so the last
+ * `SETTINGS_WEAR_SAMPLES` periods. Without samples, the rate is measured since boot.
+ * @param partition_name Optional custom partition name. If `nullptr`, the default partition is
+ * used.
+ * @retval `true` Sampled.
+ * @retval `false` Statistics not available (e.g. not initialized).
+ */
+bool sampleWear(const char* partition_name = nullptr);
+
+/**
+ * @brief Estimate the page erase cycles caused by the writes of `Option::Wear` objects, and the
+ * partition lifetime at their current write rate.
+ * @param estimate Output parameter for the estimate.
+ * @param endurance_cycles Erase cycles a flash sector is rated for.
+ * @param partition_name Optional custom partition name. If `nullptr`, the default partition is
+ * used.
+ * @retval `true` Estimated. `lifetime_years` is infinite if nothing was written.
+ * @retval `false` Statistics not available, or the partition is full.
+ */
+bool estimateWear(WearEstimate& estimate, uint32_t endurance_cycles = 100000,
+                  const char* partition_name = nullptr);
+
+/**
+ * @brief Get the flash wear of a namespace.
+ * @param ns_name Namespace name.
+ * @param out Output parameter for the counters.
+ * @retval `true` Found.
+ * @retval `false` No `Option::Wear` object uses the namespace, or `SETTINGS_WEAR_NAMESPACES`
+ * namespaces were tracked before it.
+ */
+bool getNamespaceWear(const char* ns_name, NamespaceWear& out);
+
+/// @brief Reset the namespace counters and the samples. Per-key counters are kept.
+void resetWear();
+
+namespace Internal {
+
+/// @brief Entries a write of a scalar appends to NVS.
+template <typename V>
+constexpr uint32_t entriesOf(const V&) {
+  static_assert(std::is_arithmetic_v<V>, "Unsupported value type");
+  return 1;
+}
+
+/// @brief Entries a string write appends: a header and the string with its null terminator.
+inline uint32_t entriesOf(const StrView& value) {
+  size_t size = value.data ? strlen(value.data) + 1 : 1;
+  return static_cast<uint32_t>(1 + (size + 31) / 32);
+}
+
+/// @brief Entries a blob of a given size appends: an index, a chunk header and the data.
+constexpr uint32_t blobEntries(size_t size) { return static_cast<uint32_t>(2 + (size + 31) / 32); }
+
+inline uint32_t entriesOf(const ByteStreamView& value) { return blobEntries(value.size); }
+
+/// @brief Write counters of a namespace, shared by its `Option::Wear` objects.
+struct WearCounter {
+  char name[16] = {};
+  std::atomic<uint32_t> writes{0};
+  std::atomic<uint32_t> entries{0};
+};
+
+/**
+ * @brief Get the counters of a namespace, taking a free one on first use.
+ * @param ns_name Namespace name.
+ * @return The counters, or `nullptr` if `SETTINGS_WEAR_NAMESPACES` are taken.
+ */
+WearCounter* wearCounter(const char* ns_name);
+
+/**
+ * @brief Count a write in the partition totals and, if any, its namespace counters.
+ * @param counter Namespace counters, or `nullptr`.
+ * @param writes Values written.
+ * @param entries Entries appended.
+ */
+void countWear(WearCounter* counter, uint32_t writes, uint32_t entries);
+
+/// @brief Fire the wear alert callback, if set.
+void wearAlert(const char* ns_name, const char* key, uint32_t budget, uint32_t period_s);
+
+/**
+ * @brief Per-key wear counters and write budgets of a Settings object with `Option::Wear`.
+ * Relaxed atomics: readers may run on any task, while writes to one object never overlap (they hold
+ * its lock, or run on the background writer).
+ * @tparam N Number of settings.
+ */
+template <size_t N>
+class WearStore {
+  public:
+  /// @brief Attach to the counters of the object's namespace (once its handle is open).
+  void attach(const char* ns_name) {
+    if (!_counter) _counter = wearCounter(ns_name);
+  }
+
+  /**
+   * @brief Count a write of a key.
+   * @param index Setting index.
+   * @param entries Entries appended, 0 if they are counted with `image()`.
+   * @param now_s Current time in seconds.
+   * @retval `true` The key just went over its budget for this period.
+   * @retval `false` Within budget, or over it already.
+   */
+  bool write(size_t index, uint32_t entries, uint32_t now_s) {
+    Key& key = _keys[index];
+    key.writes.fetch_add(1, std::memory_order_relaxed);
+    key.entries.fetch_add(entries, std::memory_order_relaxed);
+    countWear(_counter, 1, entries);
+
+    uint32_t budget = key.budget.load(std::memory_order_relaxed);
+    if (budget == 0) return false;
+
+    if (now_s - key.period_start.load(std::memory_order_relaxed) >=
+        key.period_s.load(std::memory_order_relaxed)) {
+      key.period_start.store(now_s, std::memory_order_relaxed);
+      key.period_writes.store(0, std::memory_order_relaxed);
+    }
+
+    uint32_t writes = key.period_writes.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (writes != budget + 1) return false;
+    key.alerts.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /// @brief Count the entries of a whole image (`Option::Packed` or `Option::Record`).
+  void image(uint32_t entries) { countWear(_counter, 0, entries); }
+
+  void setBudget(size_t index, uint32_t budget, uint32_t period_s, uint32_t now_s) {
+    Key& key = _keys[index];
+    key.budget.store(budget, std::memory_order_relaxed);
+    key.period_s.store(period_s, std::memory_order_relaxed);
+    key.period_start.store(now_s, std::memory_order_relaxed);
+    key.period_writes.store(0, std::memory_order_relaxed);
+  }
+
+  void copyTo(size_t index, KeyWear& out) const {
+    const Key& key    = _keys[index];
+    out.writes        = key.writes.load(std::memory_order_relaxed);
+    out.entries       = key.entries.load(std::memory_order_relaxed);
+    out.budget        = key.budget.load(std::memory_order_relaxed);
+    out.period_s      = key.period_s.load(std::memory_order_relaxed);
+    out.period_writes = key.period_writes.load(std::memory_order_relaxed);
+    out.alerts        = key.alerts.load(std::memory_order_relaxed);
+  }
+
+  /// @brief Reset the counters of every key. Budgets are kept, their periods restart.
+  void reset(uint32_t now_s) {
+    for (Key& key : _keys) {
+      for (auto* counter : {&key.writes, &key.entries, &key.period_writes, &key.alerts})
+        counter->store(0, std::memory_order_relaxed);
+      key.period_start.store(now_s, std::memory_order_relaxed);
+    }
+  }
+
+  private:
+  struct Key {
+    std::atomic<uint32_t> writes{0};
+    std::atomic<uint32_t> entries{0};
+    std::atomic<uint32_t> budget{0};
+    std::atomic<uint32_t> period_s{0};
+    std::atomic<uint32_t> period_start{0};
+    std::atomic<uint32_t> period_writes{0};
+    std::atomic<uint32_t> alerts{0};
+  };
+
+  WearCounter* _counter = nullptr;
+  std::array<Key, N> _keys;
+};
+
+} // namespace Internal
+
+} // namespace NVS
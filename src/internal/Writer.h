@@ -0,0 +1,78 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace NVS {
+
+/// @brief Configuration of the background writer used by `Option::Async` objects.
+struct WriterConfig {
+  size_t queue_length = 8;    // Max number of Async objects with writes waiting at the same time
+  uint32_t stack_size = 4096; // Writer task stack in bytes (ESP32 only)
+  uint32_t priority   = 1;    // Writer task priority (ESP32 only)
+  int core            = -1;   // Core to pin the writer task to, -1 for any (ESP32 only)
+};
+
+/// @brief Write counters of an `Option::Async` object (`Settings::getWriteStats()`).
+struct WriteStats {
+  uint32_t queued    = 0; // setValue() / format() calls accepted
+  uint32_t coalesced = 0; // Accepted values replaced by a later one before being written
+  uint32_t written   = 0; // Values written to NVS
+  uint32_t unchanged = 0; // Values skipped by the writer (`Option::ElideWrites`)
+  uint32_t failed    = 0; // Values the writer failed to write or commit
+};
+
+/**
+ * @brief Start the background writer: a FreeRTOS task on the ESP32, a thread on the host. Optional:
+ * the first write of an `Option::Async` object starts it with the default configuration.
+ * @param config Writer configuration. Ignored if the writer is already running.
+ * @retval `true` Started, or already running.
+ * @retval `false` Invalid configuration, or the task could not be created.
+ */
+bool startWriter(const WriterConfig& config = WriterConfig());
+
+/**
+ * @brief Block until every write queued by `Option::Async` objects so far is written and committed,
+ * and its callbacks have run. Values still inside their coalescing window are written at once. Call
+ * it before deep sleep or a restart. Returns at once when called from the writer itself (inside a
+ * callback).
+ */
+void flush();
+
+namespace Internal {
+
+/**
+ * @brief Queued work of an `Option::Async` object. `drain(target, force)` writes its staged values
+ * that are due (all of them if `force`), and returns when it has more to write
+ * (`esp_timer_get_time()` microseconds), or -1.
+ */
+struct AsyncJob {
+  void* target;
+  int64_t (*drain)(void* target, bool force);
+};
+
+/**
+ * @brief Hand a job to the background writer, starting it if needed. Never blocks on NVS. If the
+ * target is already queued, its due time is moved earlier if needed.
+ * @param job Job to queue.
+ * @param due When to run it, in `esp_timer_get_time()` microseconds.
+ * @retval `true` Queued.
+ * @retval `false` Queue full, or the writer could not be started.
+ */
+bool enqueueAsync(const AsyncJob& job, int64_t due);
+
+/// @brief Lock type of objects without `Option::Async`: no lock at all.
+struct NoMutex {
+  void lock() {}
+  void unlock() {}
+};
+
+} // namespace Internal
+
+} // namespace NVS
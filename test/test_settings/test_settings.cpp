@@ -0,0 +1,4549 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Maximiliano Ramirez <maximiliano.ramirezbravo@gmail.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <stdio.h>
+#include <thread>
+#endif
+
+#include <inttypes.h>
+#include <math.h>
+
+#define UNITY_INCLUDE_DOUBLE
+#include <unity.h>
+
+#include <SettingsManagerESP32.h>
+
+/* ---------------------------------------------------------------------------------------------- */
+// - 3 settings for each type. The test will write to NVS only 2 of them, the third will be
+//   undefined (not written to NVS), to test the behavior of the library when trying to read a
+//   non-existent key (should return the default value).
+// - Made all not-formatteable to test two different outcomes (force format and normal format)
+
+// key, hint, default value, formatteable
+#define BOOLS(X)                       \
+  X(Bool_1, "My Bool 1", false, false) \
+  X(Bool_2, "My Bool 2", true, false)  \
+  X(Bool_3, "My Bool 3", false, false)
+
+#define UINT32S(X)                     \
+  X(UInt32_1, "My UInt32 1", 1, false) \
+  X(UInt32_2, "My UInt32 2", 2, false) \
+  X(UInt32_3, "My UInt32 3", 3, false)
+
+#define INT32S(X)                     \
+  X(Int32_1, "My Int32 1", -1, false) \
+  X(Int32_2, "My Int32 2", -2, false) \
+  X(Int32_3, "My Int32 3", -3, false)
+
+#define FLOATS(X)                      \
+  X(Float_1, "My Float 1", 1.1, false) \
+  X(Float_2, "My Float 2", 2.2, false) \
+  X(Float_3, "My Float 3", 3.3, false)
+
+#define DOUBLES(X)                               \
+  X(Double_1, "My Double 1", 1.123456789, false) \
+  X(Double_2, "My Double 2", 2.123456789, false) \
+  X(Double_3, "My Double 3", 3.123456789, false)
+
+#define STRINGS(X)                           \
+  X(String_1, "My String 1", "str 1", false) \
+  X(String_2, "My String 2", "str 2", false) \
+  X(String_3, "My String 3", "str 3", false)
+
+const NVS::ByteStreamView bytestream1_default = {
+  reinterpret_cast<const uint8_t*>("nvs1"), 5, NVS::ByteStream::Format::Hex};
+const NVS::ByteStreamView bytestream2_default = {
+  reinterpret_cast<const uint8_t*>("nvs2"), 5, NVS::ByteStream::Format::Base64};
+const NVS::ByteStreamView bytestream3_default = {
+  reinterpret_cast<const uint8_t*>("nvs3"), 5, NVS::ByteStream::Format::JSONObject};
+#define BYTESTREAMS(X)                                       \
+  X(Stream_1, "My ByteStream 1", bytestream1_default, false) \
+  X(Stream_2, "My ByteStream 2", bytestream2_default, false) \
+  X(Stream_3, "My ByteStream 3", bytestream3_default, false)
+
+constexpr uint8_t TOTAL_VALUES = 3;
+constexpr uint8_t NVS_VALUES   = 2;
+
+// New values
+bool new_bool[NVS_VALUES]          = {true, false};
+uint32_t new_uint32[NVS_VALUES]    = {11, 12};
+int32_t new_int32[NVS_VALUES]      = {-11, -12};
+float new_float[NVS_VALUES]        = {10.1, 10.2};
+double new_double[NVS_VALUES]      = {11.123456789, 22.123456789};
+const char* new_string[NVS_VALUES] = {"hello 1", "hello 2"};
+
+// Bytestream new values
+NVS::ByteStreamView new_bytestream[NVS_VALUES] = {
+  {reinterpret_cast<const uint8_t*>("test1"), 5, NVS::ByteStream::Format::JSONArray},
+  {reinterpret_cast<const uint8_t*>("test2"), 5, NVS::ByteStream::Format::Base64   }
+};
+
+// Instantiation of settings
+enum class Bools : uint8_t { BOOLS(SETTINGS_EXPAND_ENUM_CLASS) };
+NVS::Settings<bool, Bools, SETTINGS_COUNT(BOOLS), NVS::Option::Registry>
+  bools("test", {BOOLS(SETTINGS_EXPAND_SETTINGS)});
+
+enum class UInt32s : uint8_t { UINT32S(SETTINGS_EXPAND_ENUM_CLASS) };
+NVS::Settings<uint32_t, UInt32s, SETTINGS_COUNT(UINT32S), NVS::Option::Registry>
+  uint32s("test", {UINT32S(SETTINGS_EXPAND_SETTINGS)});
+
+enum class Int32s : uint8_t { INT32S(SETTINGS_EXPAND_ENUM_CLASS) };
+NVS::Settings<int32_t, Int32s, SETTINGS_COUNT(INT32S)> int32s("test",
+                                                              {INT32S(SETTINGS_EXPAND_SETTINGS)});
+
+enum class Floats : uint8_t { FLOATS(SETTINGS_EXPAND_ENUM_CLASS) };
+NVS::Settings<float, Floats, SETTINGS_COUNT(FLOATS)> floats("test",
+                                                            {FLOATS(SETTINGS_EXPAND_SETTINGS)});
+
+enum class Doubles : uint8_t { DOUBLES(SETTINGS_EXPAND_ENUM_CLASS) };
+NVS::Settings<double, Doubles, SETTINGS_COUNT(DOUBLES)>
+  doubles("test", {DOUBLES(SETTINGS_EXPAND_SETTINGS)});
+
+enum class Strings : uint8_t { STRINGS(SETTINGS_EXPAND_ENUM_CLASS) };
+NVS::Settings<NVS::Str, Strings, SETTINGS_COUNT(STRINGS)>
+  strings("test", {STRINGS(SETTINGS_EXPAND_SETTINGS)});
+
+enum class ByteStreams : uint8_t { BYTESTREAMS(SETTINGS_EXPAND_ENUM_CLASS) };
+NVS::Settings<NVS::ByteStream, ByteStreams, SETTINGS_COUNT(BYTESTREAMS)>
+  bytestreams("test", {BYTESTREAMS(SETTINGS_EXPAND_SETTINGS)});
+
+NVS::ISettings* settings[] = {&bools, &uint32s, &int32s, &floats, &doubles, &strings, &bytestreams};
+constexpr size_t settings_size = sizeof(settings) / sizeof(settings[0]);
+
+// Indexes for pointers
+enum SettingIndex {
+  ID_Bools = 0,
+  ID_UInt32s,
+  ID_Int32s,
+  ID_Floats,
+  ID_Doubles,
+  ID_Strings,
+  ID_ByteStreams
+};
+
+// Cached object and a plain twin sharing its namespace and keys, to observe what the cache serves
+NVS::Settings<uint32_t, UInt32s, SETTINGS_COUNT(UINT32S),
+              NVS::Option::Cache | NVS::Option::Registry>
+  cached_uint32s("test_cache", {UINT32S(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<uint32_t, UInt32s, SETTINGS_COUNT(UINT32S), NVS::Option::Registry>
+  uncached_uint32s("test_cache", {UINT32S(SETTINGS_EXPAND_SETTINGS)});
+
+// Transactions: own namespace and callback counter, so the global callback totals are unaffected
+NVS::Settings<uint32_t, UInt32s, SETTINGS_COUNT(UINT32S),
+              NVS::Option::Transactions | NVS::Option::Registry>
+  tx_uint32s("test_tx", {UINT32S(SETTINGS_EXPAND_SETTINGS)});
+
+uint8_t tx_callback_entries = 0;
+void txCallback(const char* key, const NVS::Type type, const size_t index,
+                const void* const value) {
+  tx_callback_entries++;
+}
+
+// Write elision: scalars compared with NVS or the cache, strings and blobs by fingerprint
+NVS::Settings<uint32_t, UInt32s, SETTINGS_COUNT(UINT32S),
+              NVS::Option::ElideWrites | NVS::Option::Transactions>
+  elided_uint32s("test_elide", {UINT32S(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<float, Floats, SETTINGS_COUNT(FLOATS), NVS::Option::ElideWrites | NVS::Option::Cache>
+  elided_floats("test_elide", {FLOATS(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<NVS::Str, Strings, SETTINGS_COUNT(STRINGS), NVS::Option::ElideWrites>
+  elided_strings("test_elide", {STRINGS(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<NVS::ByteStream, ByteStreams, SETTINGS_COUNT(BYTESTREAMS), NVS::Option::ElideWrites>
+  elided_bytestreams("test_elide", {BYTESTREAMS(SETTINGS_EXPAND_SETTINGS)});
+
+uint8_t elide_callback_entries = 0;
+void elideCallback(const char* key, const NVS::Type type, const size_t index,
+                   const void* const value) {
+  elide_callback_entries++;
+}
+
+// Value sizes and single-pass reads: plain and length-cached strings, byte streams
+NVS::Settings<NVS::Str, Strings, SETTINGS_COUNT(STRINGS)>
+  size_strings("test_size", {STRINGS(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<NVS::Str, Strings, SETTINGS_COUNT(STRINGS), NVS::Option::Cache>
+  size_cached_strings("test_size", {STRINGS(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<NVS::ByteStream, ByteStreams, SETTINGS_COUNT(BYTESTREAMS)>
+  size_bytestreams("test_size", {BYTESTREAMS(SETTINGS_EXPAND_SETTINGS)});
+
+// Packed flags: one NVS key for the whole object
+NVS::Settings<bool, Bools, SETTINGS_COUNT(BOOLS), NVS::Option::Packed | NVS::Option::Transactions>
+  packed_bools("test_packed", {BOOLS(SETTINGS_EXPAND_SETTINGS)});
+
+uint8_t packed_callback_entries = 0;
+
+// Record: the whole object as one versioned blob
+NVS::Settings<float, Floats, SETTINGS_COUNT(FLOATS),
+              NVS::Option::Record | NVS::Option::Transactions>
+  record_floats("test_record", {FLOATS(SETTINGS_EXPAND_SETTINGS)});
+
+// Snapshots: one namespace scan, then reads of the stored keys only
+NVS::Settings<uint32_t, UInt32s, SETTINGS_COUNT(UINT32S)>
+  snapshot_uint32s("test_snapshot", {UINT32S(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<float, Floats, SETTINGS_COUNT(FLOATS), NVS::Option::Cache>
+  snapshot_floats("test_snapshot", {FLOATS(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<NVS::Str, Strings, SETTINGS_COUNT(STRINGS)>
+  snapshot_strings("test_snapshot", {STRINGS(SETTINGS_EXPAND_SETTINGS)});
+
+// Async writes: a plain twin sharing the namespace reads what the writer committed
+NVS::Settings<uint32_t, UInt32s, SETTINGS_COUNT(UINT32S), NVS::Option::Async>
+  async_uint32s("test_async", {UINT32S(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<uint32_t, UInt32s, SETTINGS_COUNT(UINT32S)>
+  async_twin("test_async", {UINT32S(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<float, Floats, SETTINGS_COUNT(FLOATS), NVS::Option::Async | NVS::Option::ElideWrites>
+  async_floats("test_async", {FLOATS(SETTINGS_EXPAND_SETTINGS)});
+
+uint8_t async_change_entries = 0;
+uint8_t async_done_entries   = 0;
+NVS::WriteStatus async_last_status;
+
+// Write coalescing: a window per object or per setting, on top of Option::Async
+NVS::Settings<uint32_t, UInt32s, SETTINGS_COUNT(UINT32S), NVS::Option::Async>
+  coalesce_uint32s("test_coalesce", {UINT32S(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<uint32_t, UInt32s, SETTINGS_COUNT(UINT32S)>
+  coalesce_twin("test_coalesce", {UINT32S(SETTINGS_EXPAND_SETTINGS)});
+
+uint8_t coalesce_change_entries = 0;
+uint8_t coalesce_done_entries   = 0;
+
+// Thread safety: shared between threads by the host stress test
+NVS::Settings<float, Floats, SETTINGS_COUNT(FLOATS),
+              NVS::Option::Cache | NVS::Option::ThreadSafe | NVS::Option::Transactions>
+  ts_floats("test_ts", {FLOATS(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<uint32_t, UInt32s, SETTINGS_COUNT(UINT32S), NVS::Option::ThreadSafe>
+  ts_uint32s("test_ts", {UINT32S(SETTINGS_EXPAND_SETTINGS)});
+
+// Callbacks compiled out
+NVS::Settings<uint32_t, UInt32s, SETTINGS_COUNT(UINT32S), NVS::Option::NoCallbacks>
+  nocb_uint32s("test_nocb", {UINT32S(SETTINGS_EXPAND_SETTINGS)});
+
+// Deferred callbacks: delivered by NVS::poll() or the notification task
+NVS::Settings<uint32_t, UInt32s, SETTINGS_COUNT(UINT32S), NVS::Option::DeferCallbacks>
+  defer_uint32s("test_defer", {UINT32S(SETTINGS_EXPAND_SETTINGS)});
+
+uint32_t defer_change_entries = 0;
+uint32_t defer_global_entries = 0;
+uint32_t defer_last_value     = 0;
+
+// Instrumentation
+NVS::Settings<uint32_t, UInt32s, SETTINGS_COUNT(UINT32S),
+              NVS::Option::Metrics | NVS::Option::ElideWrites>
+  metrics_uint32s("test_metrics", {UINT32S(SETTINGS_EXPAND_SETTINGS)});
+
+// Flash wear
+NVS::Settings<uint32_t, UInt32s, SETTINGS_COUNT(UINT32S), NVS::Option::Wear>
+  wear_uint32s("test_wear", {UINT32S(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<NVS::Str, Strings, SETTINGS_COUNT(STRINGS), NVS::Option::Wear>
+  wear_strings("test_wear", {STRINGS(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<bool, Bools, SETTINGS_COUNT(BOOLS),
+              NVS::Option::Packed | NVS::Option::Wear | NVS::Option::Transactions>
+  wear_bools("test_wear_pk", {BOOLS(SETTINGS_EXPAND_SETTINGS)});
+
+uint32_t wear_alerts = 0;
+
+// Chunked byte streams, and a plain object on the same keys to write values stored whole
+NVS::Settings<NVS::ByteStream, ByteStreams, SETTINGS_COUNT(BYTESTREAMS),
+              NVS::Option::Chunked | NVS::Option::Wear>
+  chunked_bytestreams("test_chunked", {BYTESTREAMS(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<NVS::ByteStream, ByteStreams, SETTINGS_COUNT(BYTESTREAMS)>
+  unchunked_bytestreams("test_chunked", {BYTESTREAMS(SETTINGS_EXPAND_SETTINGS)});
+
+uint8_t chunked_blob[3000];
+
+// Compressed values, and plain objects on the same keys to write values stored before the option
+NVS::Settings<NVS::Str, Strings, SETTINGS_COUNT(STRINGS),
+              NVS::Option::Compressed | NVS::Option::Wear>
+  compressed_strings("test_compress", {STRINGS(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<NVS::Str, Strings, SETTINGS_COUNT(STRINGS)>
+  uncompressed_strings("test_compress", {STRINGS(SETTINGS_EXPAND_SETTINGS)});
+NVS::Settings<NVS::ByteStream, ByteStreams, SETTINGS_COUNT(BYTESTREAMS), NVS::Option::Compressed>
+  compressed_bytestreams("test_compress", {BYTESTREAMS(SETTINGS_EXPAND_SETTINGS)});
+
+// JSON document of `count` similar records, the kind of value compression is meant for
+size_t makeJson(char* buf, size_t size, size_t count) {
+  size_t length = snprintf(buf, size, "{\"sensors\":[");
+  for (size_t i = 0; i < count && length < size; i++) {
+    length += snprintf(buf + length, size - length,
+                       "%s{\"id\":%u,\"name\":\"sensor-%u\",\"unit\":\"C\",\"min\":-40,"
+                       "\"max\":125}",
+                       i ? "," : "", static_cast<unsigned>(i), static_cast<unsigned>(i));
+  }
+  if (length < size) length += snprintf(buf + length, size - length, "]}");
+  return length;
+}
+
+// The same namespace on a dedicated partition and on the default one
+NVS::Settings<uint32_t, UInt32s, SETTINGS_COUNT(UINT32S)>
+  hot_uint32s("test_part", {UINT32S(SETTINGS_EXPAND_SETTINGS)}, "hot");
+NVS::Settings<uint32_t, UInt32s, SETTINGS_COUNT(UINT32S)>
+  cold_uint32s("test_part", {UINT32S(SETTINGS_EXPAND_SETTINGS)});
+
+// Counters, and the same namespace read back by a second object
+#define COUNTERS(X)                                 \
+  X(Boots, "Boot count", 0, false)                  \
+  X(Hours, "Operating hours", 0, true)              \
+  X(EnergyWh, "Energy accumulator", 1000, true)
+
+enum class CounterIds : uint8_t { COUNTERS(SETTINGS_EXPAND_ENUM_CLASS) };
+NVS::Counters<CounterIds, SETTINGS_COUNT(COUNTERS)>
+  counters("test_counters", {COUNTERS(SETTINGS_EXPAND_SETTINGS)});
+NVS::Counters<CounterIds, SETTINGS_COUNT(COUNTERS)>
+  counters_reload("test_counters", {COUNTERS(SETTINGS_EXPAND_SETTINGS)});
+
+// Callbacks
+// 3 entries for each setting (when formatting the list)
+// 2 entries for each setting (when setting a value)
+constexpr uint8_t expected_global_callback_entries = settings_size * (TOTAL_VALUES + NVS_VALUES);
+
+// One entry for each setting (only in setValue; callback disabled on format)
+constexpr uint8_t expected_individual_callback_entries = NVS_VALUES;
+
+uint8_t global_callback_entries = 0;
+void globalCallback(const char* key, const NVS::Type type, const size_t index,
+                    const void* const value) {
+  global_callback_entries++;
+}
+
+uint8_t bool_callback_entries = 0;
+void boolCallback(const char* key, const Bools setting, const bool value) {
+  bool_callback_entries++;
+}
+
+uint8_t uint32_callback_entries = 0;
+void uint32Callback(const char* key, const UInt32s setting, const uint32_t value) {
+  uint32_callback_entries++;
+}
+
+uint8_t int32_callback_entries = 0;
+void int32Callback(const char* key, const Int32s setting, const int32_t value) {
+  int32_callback_entries++;
+}
+
+uint8_t float_callback_entries = 0;
+void floatCallback(const char* key, const Floats setting, const float value) {
+  float_callback_entries++;
+}
+
+uint8_t double_callback_entries = 0;
+void doubleCallback(const char* key, const Doubles setting, const double value) {
+  double_callback_entries++;
+}
+
+uint8_t string_callback_entries = 0;
+void stringCallback(const char* key, const Strings setting, const NVS::StrView value) {
+  string_callback_entries++;
+}
+
+uint8_t bytestream_callback_entries = 0;
+void bytestreamCallback(const char* key, const ByteStreams setting,
+                        const NVS::ByteStreamView value) {
+  bytestream_callback_entries++;
+}
+
+// Test functions
+void test_initializeNVS();
+void test_clearNVS();
+void test_getType();
+void test_getSize();
+
+void test_bools_getKey();
+void test_bools_getHint();
+void test_bools_getDefaultValue();
+void test_bools_setValue();
+void test_bools_getValue();
+void test_bools_hasKey();
+void test_bools_pointer();
+void test_bools_getValueOrDefault();
+void test_bools_getValuePtrOrDefault();
+void test_bools_format();
+void test_bools_forceFormat();
+
+void test_uint32s_getKey();
+void test_uint32s_getHint();
+void test_uint32s_getDefaultValue();
+void test_uint32s_setValue();
+void test_uint32s_getValue();
+void test_uint32s_hasKey();
+void test_uint32s_pointer();
+void test_uint32s_getValueOrDefault();
+void test_uint32s_getValuePtrOrDefault();
+void test_uint32s_format();
+void test_uint32s_forceFormat();
+
+void test_int32s_getKey();
+void test_int32s_getHint();
+void test_int32s_getDefaultValue();
+void test_int32s_setValue();
+void test_int32s_getValue();
+void test_int32s_hasKey();
+void test_int32s_pointer();
+void test_int32s_getValueOrDefault();
+void test_int32s_getValuePtrOrDefault();
+void test_int32s_format();
+void test_int32s_forceFormat();
+
+void test_floats_getKey();
+void test_floats_getHint();
+void test_floats_getDefaultValue();
+void test_floats_setValue();
+void test_floats_getValue();
+void test_floats_hasKey();
+void test_floats_pointer();
+void test_floats_getValueOrDefault();
+void test_floats_getValuePtrOrDefault();
+void test_floats_format();
+void test_floats_forceFormat();
+
+void test_doubles_getKey();
+void test_doubles_getHint();
+void test_doubles_getDefaultValue();
+void test_doubles_setValue();
+void test_doubles_getValue();
+void test_doubles_hasKey();
+void test_doubles_pointer();
+void test_doubles_getValueOrDefault();
+void test_doubles_getValuePtrOrDefault();
+void test_doubles_format();
+void test_doubles_forceFormat();
+
+void test_strings_getKey();
+void test_strings_getHint();
+void test_strings_getDefaultValue();
+void test_strings_setValue();
+void test_strings_getValue();
+void test_strings_hasKey();
+void test_strings_pointer();
+void test_strings_getValueOrDefault();
+void test_strings_getValuePtrOrDefault();
+void test_strings_format();
+void test_strings_forceFormat();
+
+void test_bytestreams_getKey();
+void test_bytestreams_getHint();
+void test_bytestreams_getDefaultValue();
+void test_bytestreams_setValue();
+void test_bytestreams_getValue();
+void test_bytestreams_hasKey();
+void test_bytestreams_pointer();
+void test_bytestreams_getValueOrDefault();
+void test_bytestreams_getValuePtrOrDefault();
+void test_bytestreams_format();
+void test_bytestreams_forceFormat();
+
+void test_cache_begin();
+void test_cache_absentKey();
+void test_cache_writeThrough();
+void test_cache_invalidate();
+void test_cache_eraseAll();
+
+void test_transaction_commit();
+void test_transaction_abort();
+void test_transaction_guard();
+void test_transaction_disabled();
+
+void test_elide_scalars();
+void test_elide_cachedScalars();
+void test_elide_strings();
+void test_elide_bytestreams();
+void test_elide_formatAll();
+void test_elide_disabled();
+
+void test_keyIndex_missingKeys();
+void test_keyIndex_runtimeList();
+
+void test_registry_find();
+void test_registry_ambiguous();
+void test_registry_endLeaves();
+
+void test_size_getValueSize();
+void test_size_cachedLength();
+void test_size_bufferFit();
+
+void test_packed_readWrite();
+void test_packed_singleKey();
+void test_packed_format();
+void test_packed_transaction();
+void test_packed_manyFlags();
+
+void test_record_empty();
+void test_record_writeThrough();
+void test_record_saveAll();
+void test_record_version();
+void test_record_corrupted();
+
+void test_snapshot_defaults();
+void test_snapshot_cached();
+void test_snapshot_untyped();
+
+void test_async_queued();
+void test_async_callbacks();
+void test_async_formatAndEnd();
+void test_async_callbackRace();
+void test_async_endRace();
+
+void test_coalesce_burst();
+void test_coalesce_windowExpires();
+
+// Thread safety
+void test_threadSafe_stress();
+
+// Callback storage
+void test_callbacks_sparse();
+void test_callbacks_disabled();
+
+// Deferred callbacks
+void test_defer_poll();
+void test_defer_writeBack();
+void test_defer_queueFull();
+void test_defer_reentrantEnd();
+void test_defer_notifier();
+#ifndef ARDUINO
+void test_defer_oneTaskAtATime();
+#endif
+
+// Instrumentation
+void test_metrics_counters();
+void test_metrics_format();
+
+// Flash wear
+void test_wear_accounting();
+void test_wear_budget();
+void test_wear_estimate();
+
+// Hex codec
+void test_hex_roundtrip();
+void test_hex_invalid();
+
+// Base64 codec
+void test_base64_vectors();
+void test_base64_invalid();
+void test_base64_encoder();
+
+// Streaming codecs
+void test_stream_hex();
+void test_stream_base64();
+void test_stream_invalid();
+
+// Chunked byte streams
+void test_chunked_roundtrip();
+void test_chunked_dirty_chunks();
+void test_chunked_integrity();
+
+// Compressed
+void test_compressed_codec();
+void test_compressed_strings();
+void test_compressed_bytestreams();
+
+// Partitions
+void test_partition_isolation();
+void test_partition_lifecycle();
+
+// Counters
+void test_counters_accumulate();
+void test_counters_flush_triggers();
+void test_counters_reset();
+
+void test_validate_global_callback_entries();
+void test_validate_individual_callback_entries();
+/* ---------------------------------------------------------------------------------------------- */
+
+int runAllTests() {
+  // Set callbacks
+  for (size_t i = 0; i < settings_size; i++) {
+    settings[i]->setGlobalOnChangeCallback(globalCallback, true);
+  }
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    bools.setOnChangeCallback(static_cast<Bools>(i), boolCallback, false);
+    uint32s.setOnChangeCallback(static_cast<UInt32s>(i), uint32Callback, false);
+    int32s.setOnChangeCallback(static_cast<Int32s>(i), int32Callback, false);
+    floats.setOnChangeCallback(static_cast<Floats>(i), floatCallback, false);
+    doubles.setOnChangeCallback(static_cast<Doubles>(i), doubleCallback, false);
+    strings.setOnChangeCallback(static_cast<Strings>(i), stringCallback, false);
+    bytestreams.setOnChangeCallback(static_cast<ByteStreams>(i), bytestreamCallback, false);
+  }
+
+  UNITY_BEGIN();
+
+  RUN_TEST(test_initializeNVS);
+  RUN_TEST(test_clearNVS);
+  RUN_TEST(test_getType);
+  RUN_TEST(test_getSize);
+
+  RUN_TEST(test_bools_getKey);
+  RUN_TEST(test_bools_getHint);
+  RUN_TEST(test_bools_getDefaultValue);
+  RUN_TEST(test_bools_setValue);
+  RUN_TEST(test_bools_getValue);
+  RUN_TEST(test_bools_hasKey);
+  RUN_TEST(test_bools_pointer);
+  RUN_TEST(test_bools_getValueOrDefault);
+  RUN_TEST(test_bools_getValuePtrOrDefault);
+  RUN_TEST(test_bools_format);
+  RUN_TEST(test_bools_forceFormat);
+
+  RUN_TEST(test_uint32s_getKey);
+  RUN_TEST(test_uint32s_getHint);
+  RUN_TEST(test_uint32s_getDefaultValue);
+  RUN_TEST(test_uint32s_setValue);
+  RUN_TEST(test_uint32s_getValue);
+  RUN_TEST(test_uint32s_hasKey);
+  RUN_TEST(test_uint32s_pointer);
+  RUN_TEST(test_uint32s_getValueOrDefault);
+  RUN_TEST(test_uint32s_getValuePtrOrDefault);
+  RUN_TEST(test_uint32s_format);
+  RUN_TEST(test_uint32s_forceFormat);
+
+  RUN_TEST(test_int32s_getKey);
+  RUN_TEST(test_int32s_getHint);
+  RUN_TEST(test_int32s_getDefaultValue);
+  RUN_TEST(test_int32s_setValue);
+  RUN_TEST(test_int32s_getValue);
+  RUN_TEST(test_int32s_hasKey);
+  RUN_TEST(test_int32s_pointer);
+  RUN_TEST(test_int32s_getValueOrDefault);
+  RUN_TEST(test_int32s_getValuePtrOrDefault);
+  RUN_TEST(test_int32s_format);
+  RUN_TEST(test_int32s_forceFormat);
+
+  RUN_TEST(test_floats_getKey);
+  RUN_TEST(test_floats_getHint);
+  RUN_TEST(test_floats_getDefaultValue);
+  RUN_TEST(test_floats_setValue);
+  RUN_TEST(test_floats_getValue);
+  RUN_TEST(test_floats_hasKey);
+  RUN_TEST(test_floats_pointer);
+  RUN_TEST(test_floats_getValueOrDefault);
+  RUN_TEST(test_floats_getValuePtrOrDefault);
+  RUN_TEST(test_floats_format);
+  RUN_TEST(test_floats_forceFormat);
+
+  RUN_TEST(test_doubles_getKey);
+  RUN_TEST(test_doubles_getHint);
+  RUN_TEST(test_doubles_getDefaultValue);
+  RUN_TEST(test_doubles_setValue);
+  RUN_TEST(test_doubles_getValue);
+  RUN_TEST(test_doubles_hasKey);
+  RUN_TEST(test_doubles_pointer);
+  RUN_TEST(test_doubles_getValueOrDefault);
+  RUN_TEST(test_doubles_getValuePtrOrDefault);
+  RUN_TEST(test_doubles_format);
+  RUN_TEST(test_doubles_forceFormat);
+
+  RUN_TEST(test_strings_getKey);
+  RUN_TEST(test_strings_getHint);
+  RUN_TEST(test_strings_getDefaultValue);
+  RUN_TEST(test_strings_setValue);
+  RUN_TEST(test_strings_getValue);
+  RUN_TEST(test_strings_hasKey);
+  RUN_TEST(test_strings_pointer);
+  RUN_TEST(test_strings_getValueOrDefault);
+  RUN_TEST(test_strings_getValuePtrOrDefault);
+  RUN_TEST(test_strings_format);
+  RUN_TEST(test_strings_forceFormat);
+
+  RUN_TEST(test_bytestreams_getKey);
+  RUN_TEST(test_bytestreams_getHint);
+  RUN_TEST(test_bytestreams_getDefaultValue);
+  RUN_TEST(test_bytestreams_setValue);
+  RUN_TEST(test_bytestreams_getValue);
+  RUN_TEST(test_bytestreams_hasKey);
+  RUN_TEST(test_bytestreams_pointer);
+  RUN_TEST(test_bytestreams_getValueOrDefault);
+  RUN_TEST(test_bytestreams_getValuePtrOrDefault);
+  RUN_TEST(test_bytestreams_format);
+  RUN_TEST(test_bytestreams_forceFormat);
+
+  RUN_TEST(test_cache_begin);
+  RUN_TEST(test_cache_absentKey);
+  RUN_TEST(test_cache_writeThrough);
+  RUN_TEST(test_cache_invalidate);
+  RUN_TEST(test_cache_eraseAll);
+
+  RUN_TEST(test_transaction_commit);
+  RUN_TEST(test_transaction_abort);
+  RUN_TEST(test_transaction_guard);
+  RUN_TEST(test_transaction_disabled);
+
+  RUN_TEST(test_elide_scalars);
+  RUN_TEST(test_elide_cachedScalars);
+  RUN_TEST(test_elide_strings);
+  RUN_TEST(test_elide_bytestreams);
+  RUN_TEST(test_elide_formatAll);
+  RUN_TEST(test_elide_disabled);
+
+  RUN_TEST(test_keyIndex_missingKeys);
+  RUN_TEST(test_keyIndex_runtimeList);
+
+  RUN_TEST(test_registry_find);
+  RUN_TEST(test_registry_ambiguous);
+  RUN_TEST(test_registry_endLeaves);
+
+  RUN_TEST(test_size_getValueSize);
+  RUN_TEST(test_size_cachedLength);
+  RUN_TEST(test_size_bufferFit);
+
+  RUN_TEST(test_packed_readWrite);
+  RUN_TEST(test_packed_singleKey);
+  RUN_TEST(test_packed_format);
+  RUN_TEST(test_packed_transaction);
+  RUN_TEST(test_packed_manyFlags);
+
+  RUN_TEST(test_record_empty);
+  RUN_TEST(test_record_writeThrough);
+  RUN_TEST(test_record_saveAll);
+  RUN_TEST(test_record_version);
+  RUN_TEST(test_record_corrupted);
+
+  RUN_TEST(test_snapshot_defaults);
+  RUN_TEST(test_snapshot_cached);
+  RUN_TEST(test_snapshot_untyped);
+
+  RUN_TEST(test_async_queued);
+  RUN_TEST(test_async_callbacks);
+  RUN_TEST(test_async_formatAndEnd);
+#ifndef ARDUINO
+  RUN_TEST(test_async_callbackRace);
+  RUN_TEST(test_async_endRace);
+#endif
+
+  RUN_TEST(test_coalesce_burst);
+  RUN_TEST(test_coalesce_windowExpires);
+
+#ifndef ARDUINO
+  RUN_TEST(test_threadSafe_stress);
+#endif
+
+  RUN_TEST(test_callbacks_sparse);
+  RUN_TEST(test_callbacks_disabled);
+
+  RUN_TEST(test_defer_poll);
+  RUN_TEST(test_defer_writeBack);
+  RUN_TEST(test_defer_queueFull);
+  RUN_TEST(test_defer_reentrantEnd);
+  RUN_TEST(test_defer_notifier);
+#ifndef ARDUINO
+  RUN_TEST(test_defer_oneTaskAtATime);
+#endif
+
+  RUN_TEST(test_metrics_counters);
+  RUN_TEST(test_metrics_format);
+
+  RUN_TEST(test_wear_accounting);
+  RUN_TEST(test_wear_budget);
+  RUN_TEST(test_wear_estimate);
+
+  RUN_TEST(test_hex_roundtrip);
+  RUN_TEST(test_hex_invalid);
+
+  RUN_TEST(test_base64_vectors);
+  RUN_TEST(test_base64_invalid);
+  RUN_TEST(test_base64_encoder);
+
+  RUN_TEST(test_stream_hex);
+  RUN_TEST(test_stream_base64);
+  RUN_TEST(test_stream_invalid);
+
+  RUN_TEST(test_chunked_roundtrip);
+  RUN_TEST(test_chunked_dirty_chunks);
+  RUN_TEST(test_chunked_integrity);
+
+  RUN_TEST(test_compressed_codec);
+  RUN_TEST(test_compressed_strings);
+  RUN_TEST(test_compressed_bytestreams);
+
+  RUN_TEST(test_partition_isolation);
+  RUN_TEST(test_partition_lifecycle);
+
+  RUN_TEST(test_counters_accumulate);
+  RUN_TEST(test_counters_flush_triggers);
+  RUN_TEST(test_counters_reset);
+
+  RUN_TEST(test_validate_global_callback_entries);
+  RUN_TEST(test_validate_individual_callback_entries);
+
+  return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+  delay(2000);
+  runAllTests();
+}
+
+void loop() {}
+#else
+int main() { return runAllTests(); }
+#endif
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_initializeNVS() {
+  TEST_ASSERT(NVS::init());
+  for (size_t i = 0; i < settings_size; i++) {
+    TEST_ASSERT(settings[i]->begin());
+  }
+}
+
+void test_clearNVS() {
+  // Erase all keys in the shared "test" namespace via the first open handle.
+  // All other objects share the same namespace, so their keys are erased too.
+  TEST_ASSERT(settings[0]->eraseAll());
+}
+
+void test_getType() {
+  TEST_ASSERT(bools.getType() == NVS::Type::Bool);
+  TEST_ASSERT(uint32s.getType() == NVS::Type::UInt32);
+  TEST_ASSERT(int32s.getType() == NVS::Type::Int32);
+  TEST_ASSERT(floats.getType() == NVS::Type::Float);
+  TEST_ASSERT(doubles.getType() == NVS::Type::Double);
+  TEST_ASSERT(strings.getType() == NVS::Type::String);
+  TEST_ASSERT(bytestreams.getType() == NVS::Type::ByteStream);
+}
+
+void test_getSize() {
+  constexpr size_t TOTAL_VALUES = NVS_VALUES + 1;
+  TEST_ASSERT(bools.getSize() == TOTAL_VALUES);
+  TEST_ASSERT(uint32s.getSize() == TOTAL_VALUES);
+  TEST_ASSERT(int32s.getSize() == TOTAL_VALUES);
+  TEST_ASSERT(floats.getSize() == TOTAL_VALUES);
+  TEST_ASSERT(doubles.getSize() == TOTAL_VALUES);
+  TEST_ASSERT(strings.getSize() == TOTAL_VALUES);
+  TEST_ASSERT(bytestreams.getSize() == TOTAL_VALUES);
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_bools_getKey() {
+  TEST_ASSERT_EQUAL_STRING("Bool_1", bools.getKey(Bools::Bool_1));
+  TEST_ASSERT_EQUAL_STRING("Bool_2", bools.getKey(Bools::Bool_2));
+}
+
+void test_bools_getHint() {
+  TEST_ASSERT_EQUAL_STRING("My Bool 1", bools.getHint(Bools::Bool_1));
+  TEST_ASSERT_EQUAL_STRING("My Bool 2", bools.getHint(Bools::Bool_2));
+}
+
+void test_bools_getDefaultValue() {
+  TEST_ASSERT_EQUAL(false, bools.getDefaultValue(Bools::Bool_1));
+  TEST_ASSERT_EQUAL(true, bools.getDefaultValue(Bools::Bool_2));
+}
+
+void test_bools_setValue() {
+  TEST_ASSERT(bools.setValue(Bools::Bool_1, new_bool[0]));
+  TEST_ASSERT(bools.setValue(Bools::Bool_2, new_bool[1]));
+}
+
+void test_bools_getValue() {
+  bool val;
+  TEST_ASSERT(bools.getValue(Bools::Bool_1, val));
+  TEST_ASSERT_EQUAL(new_bool[0], val);
+  TEST_ASSERT(bools.getValue(Bools::Bool_2, val));
+  TEST_ASSERT_EQUAL(new_bool[1], val);
+}
+
+void test_bools_hasKey() {
+  size_t index_found;
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    TEST_ASSERT(bools.hasKey(bools.getKey(static_cast<Bools>(i)), index_found));
+    TEST_ASSERT_EQUAL(i, index_found);
+  }
+}
+
+void test_bools_pointer() {
+  TEST_ASSERT_EQUAL(NVS::Type::Bool, settings[ID_Bools]->getType());
+
+  char buffer[64];
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    // Key
+    sprintf(buffer, "Bool_%u", static_cast<unsigned>(i + 1));
+    TEST_ASSERT_EQUAL_STRING(buffer, settings[ID_Bools]->getKey(i));
+
+    // Hint
+    sprintf(buffer, "My Bool %u", static_cast<unsigned>(i + 1));
+    TEST_ASSERT_EQUAL_STRING(buffer, settings[ID_Bools]->getHint(i));
+
+    // Value
+    bool value;
+    TEST_ASSERT_TRUE(settings[ID_Bools]->getValuePtr(i, &value, sizeof(value)));
+    bool bval;
+    bools.getValue(static_cast<Bools>(i), bval);
+    TEST_ASSERT_EQUAL(bval, value);
+
+    // Default value
+    TEST_ASSERT_EQUAL(bools.getDefaultValue(static_cast<Bools>(i)),
+                      settings[ID_Bools]->getDefaultValueAs<bool>(i));
+  }
+
+  // Index out of bounds
+  size_t idx_out = settings[ID_Bools]->getSize();
+
+  TEST_ASSERT_NULL(settings[ID_Bools]->getKey(idx_out));
+  TEST_ASSERT_NULL(settings[ID_Bools]->getHint(idx_out));
+  TEST_ASSERT_EQUAL(0, settings[ID_Bools]->getDefaultValueAs<bool>(idx_out));
+
+  bool value;
+  TEST_ASSERT_FALSE(settings[ID_Bools]->getValuePtr(idx_out, &value, sizeof(bool)));
+
+  // Buffer too small
+  TEST_ASSERT_FALSE(settings[ID_Bools]->getValuePtr(0, &value, 0));
+
+  // NVS key not saved yet - getValuePtr returns false and leaves value unmodified
+  uint8_t idx_nullptr = idx_out - 1;
+  TEST_ASSERT_FALSE(settings[ID_Bools]->getValuePtr(idx_nullptr, &value, sizeof(value)));
+}
+
+void test_bools_getValueOrDefault() {
+  bool out;
+
+  // Key exists in NVS (Bool_1 after setValue): should return the NVS value
+  bool result = bools.getValueOrDefault(Bools::Bool_1, out);
+  TEST_ASSERT_EQUAL(new_bool[0], result);
+  TEST_ASSERT_EQUAL(new_bool[0], out);
+
+  // Key not in NVS (Bool_3 was never written): should return the default value
+  result = bools.getValueOrDefault(Bools::Bool_3, out);
+  TEST_ASSERT_EQUAL(bools.getDefaultValue(Bools::Bool_3), result);
+  TEST_ASSERT_EQUAL(bools.getDefaultValue(Bools::Bool_3), out);
+}
+
+void test_bools_getValuePtrOrDefault() {
+  bool out;
+  bool ok;
+
+  // Key exists in NVS (index 0 = Bool_1): returns true, out holds the NVS value
+  ok = settings[ID_Bools]->getValuePtrOrDefault(0, &out, sizeof(out));
+  TEST_ASSERT_TRUE(ok);
+  TEST_ASSERT_EQUAL(new_bool[0], out);
+
+  // Key not in NVS (index 2 = Bool_3): returns true, out holds the default value
+  ok = settings[ID_Bools]->getValuePtrOrDefault(2, &out, sizeof(out));
+  TEST_ASSERT_TRUE(ok);
+  TEST_ASSERT_EQUAL(bools.getDefaultValue(Bools::Bool_3), out);
+
+  // Index out of bounds: returns false
+  TEST_ASSERT_FALSE(
+    settings[ID_Bools]->getValuePtrOrDefault(settings[ID_Bools]->getSize(), &out, sizeof(out)));
+
+  // Buffer too small: returns false
+  TEST_ASSERT_FALSE(settings[ID_Bools]->getValuePtrOrDefault(0, &out, 0));
+}
+
+void test_bools_format() {
+  TEST_ASSERT_EQUAL(0, bools.formatAll());
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    bool val;
+    bools.getValue(static_cast<Bools>(i), val);
+    TEST_ASSERT_EQUAL(new_bool[i], val);
+  }
+}
+
+void test_bools_forceFormat() {
+  TEST_ASSERT_EQUAL(0, bools.formatAll(true));
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    bool val;
+    bools.getValue(static_cast<Bools>(i), val);
+    TEST_ASSERT_EQUAL(bools.getDefaultValue(static_cast<Bools>(i)), val);
+  }
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_uint32s_getKey() {
+  TEST_ASSERT_EQUAL_STRING("UInt32_1", uint32s.getKey(UInt32s::UInt32_1));
+  TEST_ASSERT_EQUAL_STRING("UInt32_2", uint32s.getKey(UInt32s::UInt32_2));
+}
+
+void test_uint32s_getHint() {
+  TEST_ASSERT_EQUAL_STRING("My UInt32 1", uint32s.getHint(UInt32s::UInt32_1));
+  TEST_ASSERT_EQUAL_STRING("My UInt32 2", uint32s.getHint(UInt32s::UInt32_2));
+}
+
+void test_uint32s_getDefaultValue() {
+  TEST_ASSERT_EQUAL_UINT32(1, uint32s.getDefaultValue(UInt32s::UInt32_1));
+  TEST_ASSERT_EQUAL_UINT32(2, uint32s.getDefaultValue(UInt32s::UInt32_2));
+}
+
+void test_uint32s_setValue() {
+  TEST_ASSERT(uint32s.setValue(UInt32s::UInt32_1, new_uint32[0]));
+  TEST_ASSERT(uint32s.setValue(UInt32s::UInt32_2, new_uint32[1]));
+}
+
+void test_uint32s_getValue() {
+  uint32_t val;
+  TEST_ASSERT(uint32s.getValue(UInt32s::UInt32_1, val));
+  TEST_ASSERT_EQUAL_UINT32(new_uint32[0], val);
+  TEST_ASSERT(uint32s.getValue(UInt32s::UInt32_2, val));
+  TEST_ASSERT_EQUAL_UINT32(new_uint32[1], val);
+}
+
+void test_uint32s_hasKey() {
+  size_t index_found;
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    TEST_ASSERT(uint32s.hasKey(uint32s.getKey(static_cast<UInt32s>(i)), index_found));
+    TEST_ASSERT_EQUAL(i, index_found);
+  }
+}
+
+void test_uint32s_pointer() {
+  TEST_ASSERT_EQUAL(NVS::Type::UInt32, settings[ID_UInt32s]->getType());
+
+  char buffer[64];
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    // Key
+    sprintf(buffer, "UInt32_%u", static_cast<unsigned>(i + 1));
+    TEST_ASSERT_EQUAL_STRING(buffer, settings[ID_UInt32s]->getKey(i));
+
+    // Hint
+    sprintf(buffer, "My UInt32 %u", static_cast<unsigned>(i + 1));
+    TEST_ASSERT_EQUAL_STRING(buffer, settings[ID_UInt32s]->getHint(i));
+
+    // Value
+    uint32_t value;
+    TEST_ASSERT_TRUE(settings[ID_UInt32s]->getValuePtr(i, &value, sizeof(value)));
+    uint32_t uval;
+    uint32s.getValue(static_cast<UInt32s>(i), uval);
+    TEST_ASSERT_EQUAL_UINT32(uval, value);
+
+    // Default value
+    TEST_ASSERT_EQUAL_UINT32(uint32s.getDefaultValue(static_cast<UInt32s>(i)),
+                             settings[ID_UInt32s]->getDefaultValueAs<uint32_t>(i));
+  }
+
+  // Index out of bounds
+  size_t idx_out = settings[ID_UInt32s]->getSize();
+
+  TEST_ASSERT_NULL(settings[ID_UInt32s]->getKey(idx_out));
+  TEST_ASSERT_NULL(settings[ID_UInt32s]->getHint(idx_out));
+  TEST_ASSERT_EQUAL(0, settings[ID_UInt32s]->getDefaultValueAs<uint32_t>(idx_out));
+
+  uint32_t value;
+  TEST_ASSERT_FALSE(settings[ID_UInt32s]->getValuePtr(idx_out, &value, sizeof(value)));
+
+  // Buffer too small
+  TEST_ASSERT_FALSE(settings[ID_UInt32s]->getValuePtr(0, &value, 0));
+
+  // NVS key not saved yet - getValuePtr returns false and leaves value unmodified
+  uint8_t idx_nullptr = idx_out - 1;
+  TEST_ASSERT_FALSE(settings[ID_UInt32s]->getValuePtr(idx_nullptr, &value, sizeof(value)));
+}
+
+void test_uint32s_getValueOrDefault() {
+  uint32_t out;
+
+  // Key exists in NVS (UInt32_1 = 11 after setValue): should return the NVS value
+  uint32_t result = uint32s.getValueOrDefault(UInt32s::UInt32_1, out);
+  TEST_ASSERT_EQUAL_UINT32(new_uint32[0], result);
+  TEST_ASSERT_EQUAL_UINT32(new_uint32[0], out);
+
+  // Key not in NVS (UInt32_3 was never written): should return the default value
+  result = uint32s.getValueOrDefault(UInt32s::UInt32_3, out);
+  TEST_ASSERT_EQUAL_UINT32(uint32s.getDefaultValue(UInt32s::UInt32_3), result);
+  TEST_ASSERT_EQUAL_UINT32(uint32s.getDefaultValue(UInt32s::UInt32_3), out);
+}
+
+void test_uint32s_getValuePtrOrDefault() {
+  uint32_t out;
+  bool ok;
+
+  // Key exists in NVS (index 0 = UInt32_1 = 11): returns true, out holds the NVS value
+  ok = settings[ID_UInt32s]->getValuePtrOrDefault(0, &out, sizeof(out));
+  TEST_ASSERT_TRUE(ok);
+  TEST_ASSERT_EQUAL_UINT32(new_uint32[0], out);
+
+  // Key not in NVS (index 2 = UInt32_3): returns true, out holds the default value
+  ok = settings[ID_UInt32s]->getValuePtrOrDefault(2, &out, sizeof(out));
+  TEST_ASSERT_TRUE(ok);
+  TEST_ASSERT_EQUAL_UINT32(uint32s.getDefaultValue(UInt32s::UInt32_3), out);
+
+  // Index out of bounds: returns false
+  TEST_ASSERT_FALSE(
+    settings[ID_UInt32s]->getValuePtrOrDefault(settings[ID_UInt32s]->getSize(), &out, sizeof(out)));
+
+  // Buffer too small: returns false
+  TEST_ASSERT_FALSE(settings[ID_UInt32s]->getValuePtrOrDefault(0, &out, 0));
+}
+
+void test_uint32s_format() {
+  TEST_ASSERT_EQUAL(0, uint32s.formatAll());
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    uint32_t val;
+    uint32s.getValue(static_cast<UInt32s>(i), val);
+    TEST_ASSERT_EQUAL_UINT32(new_uint32[i], val);
+  }
+}
+
+void test_uint32s_forceFormat() {
+  TEST_ASSERT_EQUAL(0, uint32s.formatAll(true));
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    uint32_t val;
+    uint32s.getValue(static_cast<UInt32s>(i), val);
+    TEST_ASSERT_EQUAL_UINT32(uint32s.getDefaultValue(static_cast<UInt32s>(i)), val);
+  }
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_int32s_getKey() {
+  TEST_ASSERT_EQUAL_STRING("Int32_1", int32s.getKey(Int32s::Int32_1));
+  TEST_ASSERT_EQUAL_STRING("Int32_2", int32s.getKey(Int32s::Int32_2));
+}
+
+void test_int32s_getHint() {
+  TEST_ASSERT_EQUAL_STRING("My Int32 1", int32s.getHint(Int32s::Int32_1));
+  TEST_ASSERT_EQUAL_STRING("My Int32 2", int32s.getHint(Int32s::Int32_2));
+}
+
+void test_int32s_getDefaultValue() {
+  TEST_ASSERT_EQUAL_INT32(-1, int32s.getDefaultValue(Int32s::Int32_1));
+  TEST_ASSERT_EQUAL_INT32(-2, int32s.getDefaultValue(Int32s::Int32_2));
+}
+
+void test_int32s_setValue() {
+  TEST_ASSERT(int32s.setValue(Int32s::Int32_1, new_int32[0]));
+  TEST_ASSERT(int32s.setValue(Int32s::Int32_2, new_int32[1]));
+}
+
+void test_int32s_getValue() {
+  int32_t val;
+  TEST_ASSERT(int32s.getValue(Int32s::Int32_1, val));
+  TEST_ASSERT_EQUAL_INT32(new_int32[0], val);
+  TEST_ASSERT(int32s.getValue(Int32s::Int32_2, val));
+  TEST_ASSERT_EQUAL_INT32(new_int32[1], val);
+}
+
+void test_int32s_hasKey() {
+  size_t index_found;
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    TEST_ASSERT(int32s.hasKey(int32s.getKey(static_cast<Int32s>(i)), index_found));
+    TEST_ASSERT_EQUAL(i, index_found);
+  }
+}
+
+void test_int32s_pointer() {
+  TEST_ASSERT_EQUAL(NVS::Type::Int32, settings[ID_Int32s]->getType());
+
+  char buffer[64];
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    // Key
+    sprintf(buffer, "Int32_%u", static_cast<unsigned>(i + 1));
+    TEST_ASSERT_EQUAL_STRING(buffer, settings[ID_Int32s]->getKey(i));
+
+    // Hint
+    sprintf(buffer, "My Int32 %u", static_cast<unsigned>(i + 1));
+    TEST_ASSERT_EQUAL_STRING(buffer, settings[ID_Int32s]->getHint(i));
+
+    // Value
+    int32_t value;
+    TEST_ASSERT_TRUE(settings[ID_Int32s]->getValuePtr(i, &value, sizeof(value)));
+    int32_t ival;
+    int32s.getValue(static_cast<Int32s>(i), ival);
+    TEST_ASSERT_EQUAL_INT32(ival, value);
+
+    // Default value
+    TEST_ASSERT_EQUAL_INT32(int32s.getDefaultValue(static_cast<Int32s>(i)),
+                            settings[ID_Int32s]->getDefaultValueAs<int32_t>(i));
+  }
+
+  // Index out of bounds
+  size_t idx_out = settings[ID_Int32s]->getSize();
+
+  TEST_ASSERT_NULL(settings[ID_Int32s]->getKey(idx_out));
+  TEST_ASSERT_NULL(settings[ID_Int32s]->getHint(idx_out));
+  TEST_ASSERT_EQUAL(0, settings[ID_Int32s]->getDefaultValueAs<int32_t>(idx_out));
+
+  int32_t value;
+  TEST_ASSERT_FALSE(settings[ID_Int32s]->getValuePtr(idx_out, &value, sizeof(value)));
+
+  // Buffer too small
+  TEST_ASSERT_FALSE(settings[ID_Int32s]->getValuePtr(0, &value, 0));
+
+  // NVS key not saved yet - getValuePtr returns false and leaves value unmodified
+  uint8_t idx_nullptr = idx_out - 1;
+  TEST_ASSERT_FALSE(settings[ID_Int32s]->getValuePtr(idx_nullptr, &value, sizeof(value)));
+}
+
+void test_int32s_getValueOrDefault() {
+  int32_t out;
+
+  // Key exists in NVS (Int32_1 after setValue): should return the NVS value
+  int32_t result = int32s.getValueOrDefault(Int32s::Int32_1, out);
+  TEST_ASSERT_EQUAL_INT32(new_int32[0], result);
+  TEST_ASSERT_EQUAL_INT32(new_int32[0], out);
+
+  // Key not in NVS (Int32_3 was never written): should return the default value
+  result = int32s.getValueOrDefault(Int32s::Int32_3, out);
+  TEST_ASSERT_EQUAL_INT32(int32s.getDefaultValue(Int32s::Int32_3), result);
+  TEST_ASSERT_EQUAL_INT32(int32s.getDefaultValue(Int32s::Int32_3), out);
+}
+
+void test_int32s_getValuePtrOrDefault() {
+  int32_t out;
+  bool ok;
+
+  // Key exists in NVS (index 0 = Int32_1): returns true, out holds the NVS value
+  ok = settings[ID_Int32s]->getValuePtrOrDefault(0, &out, sizeof(out));
+  TEST_ASSERT_TRUE(ok);
+  TEST_ASSERT_EQUAL_INT32(new_int32[0], out);
+
+  // Key not in NVS (index 2 = Int32_3): returns true, out holds the default value
+  ok = settings[ID_Int32s]->getValuePtrOrDefault(2, &out, sizeof(out));
+  TEST_ASSERT_TRUE(ok);
+  TEST_ASSERT_EQUAL_INT32(int32s.getDefaultValue(Int32s::Int32_3), out);
+
+  // Index out of bounds: returns false
+  TEST_ASSERT_FALSE(
+    settings[ID_Int32s]->getValuePtrOrDefault(settings[ID_Int32s]->getSize(), &out, sizeof(out)));
+
+  // Buffer too small: returns false
+  TEST_ASSERT_FALSE(settings[ID_Int32s]->getValuePtrOrDefault(0, &out, 0));
+}
+
+void test_int32s_format() {
+  TEST_ASSERT_EQUAL(0, int32s.formatAll());
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    int32_t val;
+    int32s.getValue(static_cast<Int32s>(i), val);
+    TEST_ASSERT_EQUAL_INT32(new_int32[i], val);
+  }
+}
+
+void test_int32s_forceFormat() {
+  TEST_ASSERT_EQUAL(0, int32s.formatAll(true));
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    int32_t val;
+    int32s.getValue(static_cast<Int32s>(i), val);
+    TEST_ASSERT_EQUAL_INT32(int32s.getDefaultValue(static_cast<Int32s>(i)), val);
+  }
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_floats_getKey() {
+  TEST_ASSERT_EQUAL_STRING("Float_1", floats.getKey(Floats::Float_1));
+  TEST_ASSERT_EQUAL_STRING("Float_2", floats.getKey(Floats::Float_2));
+}
+
+void test_floats_getHint() {
+  TEST_ASSERT_EQUAL_STRING("My Float 1", floats.getHint(Floats::Float_1));
+  TEST_ASSERT_EQUAL_STRING("My Float 2", floats.getHint(Floats::Float_2));
+}
+
+void test_floats_getDefaultValue() {
+  TEST_ASSERT_EQUAL_FLOAT(1.1, floats.getDefaultValue(Floats::Float_1));
+  TEST_ASSERT_EQUAL_FLOAT(2.2, floats.getDefaultValue(Floats::Float_2));
+}
+
+void test_floats_setValue() {
+  TEST_ASSERT(floats.setValue(Floats::Float_1, new_float[0]));
+  TEST_ASSERT(floats.setValue(Floats::Float_2, new_float[1]));
+}
+
+void test_floats_getValue() {
+  float val;
+  TEST_ASSERT(floats.getValue(Floats::Float_1, val));
+  TEST_ASSERT_EQUAL_FLOAT(new_float[0], val);
+  TEST_ASSERT(floats.getValue(Floats::Float_2, val));
+  TEST_ASSERT_EQUAL_FLOAT(new_float[1], val);
+}
+
+void test_floats_hasKey() {
+  size_t index_found;
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    TEST_ASSERT(floats.hasKey(floats.getKey(static_cast<Floats>(i)), index_found));
+    TEST_ASSERT_EQUAL(i, index_found);
+  }
+}
+
+void test_floats_pointer() {
+  TEST_ASSERT_EQUAL(NVS::Type::Float, settings[ID_Floats]->getType());
+
+  char buffer[64];
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    // Key
+    sprintf(buffer, "Float_%u", static_cast<unsigned>(i + 1));
+    TEST_ASSERT_EQUAL_STRING(buffer, settings[ID_Floats]->getKey(i));
+
+    // Hint
+    sprintf(buffer, "My Float %u", static_cast<unsigned>(i + 1));
+    TEST_ASSERT_EQUAL_STRING(buffer, settings[ID_Floats]->getHint(i));
+
+    // Value
+    float value;
+    TEST_ASSERT_TRUE(settings[ID_Floats]->getValuePtr(i, &value, sizeof(value)));
+    float fval;
+    floats.getValue(static_cast<Floats>(i), fval);
+    TEST_ASSERT_EQUAL_FLOAT(fval, value);
+
+    // Default value
+    TEST_ASSERT_EQUAL_FLOAT(floats.getDefaultValue(static_cast<Floats>(i)),
+                            settings[ID_Floats]->getDefaultValueAs<float>(i));
+  }
+
+  // Index out of bounds
+  size_t idx_out = settings[ID_Floats]->getSize();
+
+  TEST_ASSERT_NULL(settings[ID_Floats]->getKey(idx_out));
+  TEST_ASSERT_NULL(settings[ID_Floats]->getHint(idx_out));
+  TEST_ASSERT_EQUAL_FLOAT(0, settings[ID_Floats]->getDefaultValueAs<float>(idx_out));
+
+  float value;
+  TEST_ASSERT_FALSE(settings[ID_Floats]->getValuePtr(idx_out, &value, sizeof(value)));
+
+  // Buffer too small
+  TEST_ASSERT_FALSE(settings[ID_Floats]->getValuePtr(0, &value, 0));
+
+  // NVS key not saved yet - getValuePtr returns false and leaves value unmodified
+  uint8_t idx_nullptr = idx_out - 1;
+  TEST_ASSERT_FALSE(settings[ID_Floats]->getValuePtr(idx_nullptr, &value, sizeof(value)));
+}
+
+void test_floats_getValueOrDefault() {
+  float out;
+
+  // Key exists in NVS (Float_1 after setValue): should return the NVS value
+  float result = floats.getValueOrDefault(Floats::Float_1, out);
+  TEST_ASSERT_EQUAL_FLOAT(new_float[0], result);
+  TEST_ASSERT_EQUAL_FLOAT(new_float[0], out);
+
+  // Key not in NVS (Float_3 was never written): should return the default value
+  result = floats.getValueOrDefault(Floats::Float_3, out);
+  TEST_ASSERT_EQUAL_FLOAT(floats.getDefaultValue(Floats::Float_3), result);
+  TEST_ASSERT_EQUAL_FLOAT(floats.getDefaultValue(Floats::Float_3), out);
+}
+
+void test_floats_getValuePtrOrDefault() {
+  float out;
+  bool ok;
+
+  // Key exists in NVS (index 0 = Float_1): returns true, out holds the NVS value
+  ok = settings[ID_Floats]->getValuePtrOrDefault(0, &out, sizeof(out));
+  TEST_ASSERT_TRUE(ok);
+  TEST_ASSERT_EQUAL_FLOAT(new_float[0], out);
+
+  // Key not in NVS (index 2 = Float_3): returns true, out holds the default value
+  ok = settings[ID_Floats]->getValuePtrOrDefault(2, &out, sizeof(out));
+  TEST_ASSERT_TRUE(ok);
+  TEST_ASSERT_EQUAL_FLOAT(floats.getDefaultValue(Floats::Float_3), out);
+
+  // Index out of bounds: returns false
+  TEST_ASSERT_FALSE(
+    settings[ID_Floats]->getValuePtrOrDefault(settings[ID_Floats]->getSize(), &out, sizeof(out)));
+
+  // Buffer too small: returns false
+  TEST_ASSERT_FALSE(settings[ID_Floats]->getValuePtrOrDefault(0, &out, 0));
+}
+
+void test_floats_format() {
+  TEST_ASSERT_EQUAL(0, floats.formatAll());
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    float val;
+    floats.getValue(static_cast<Floats>(i), val);
+    TEST_ASSERT_EQUAL_FLOAT(new_float[i], val);
+  }
+}
+
+void test_floats_forceFormat() {
+  TEST_ASSERT_EQUAL(0, floats.formatAll(true));
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    float val;
+    floats.getValue(static_cast<Floats>(i), val);
+    TEST_ASSERT_EQUAL_FLOAT(floats.getDefaultValue(static_cast<Floats>(i)), val);
+  }
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_doubles_getKey() {
+  TEST_ASSERT_EQUAL_STRING("Double_1", doubles.getKey(Doubles::Double_1));
+  TEST_ASSERT_EQUAL_STRING("Double_2", doubles.getKey(Doubles::Double_2));
+}
+
+void test_doubles_getHint() {
+  TEST_ASSERT_EQUAL_STRING("My Double 1", doubles.getHint(Doubles::Double_1));
+  TEST_ASSERT_EQUAL_STRING("My Double 2", doubles.getHint(Doubles::Double_2));
+}
+
+void test_doubles_getDefaultValue() {
+  TEST_ASSERT_EQUAL_DOUBLE(1.123456789, doubles.getDefaultValue(Doubles::Double_1));
+  TEST_ASSERT_EQUAL_DOUBLE(2.123456789, doubles.getDefaultValue(Doubles::Double_2));
+}
+
+void test_doubles_setValue() {
+  TEST_ASSERT(doubles.setValue(Doubles::Double_1, new_double[0]));
+  TEST_ASSERT(doubles.setValue(Doubles::Double_2, new_double[1]));
+}
+
+void test_doubles_getValue() {
+  double val;
+  TEST_ASSERT(doubles.getValue(Doubles::Double_1, val));
+  TEST_ASSERT_EQUAL_DOUBLE(new_double[0], val);
+  TEST_ASSERT(doubles.getValue(Doubles::Double_2, val));
+  TEST_ASSERT_EQUAL_DOUBLE(new_double[1], val);
+}
+
+void test_doubles_hasKey() {
+  size_t index_found;
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    TEST_ASSERT(doubles.hasKey(doubles.getKey(static_cast<Doubles>(i)), index_found));
+    TEST_ASSERT_EQUAL(i, index_found);
+  }
+}
+
+void test_doubles_pointer() {
+  TEST_ASSERT_EQUAL(NVS::Type::Double, settings[ID_Doubles]->getType());
+
+  char buffer[64];
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    // Key
+    sprintf(buffer, "Double_%u", static_cast<unsigned>(i + 1));
+    TEST_ASSERT_EQUAL_STRING(buffer, settings[ID_Doubles]->getKey(i));
+
+    // Hint
+    sprintf(buffer, "My Double %u", static_cast<unsigned>(i + 1));
+    TEST_ASSERT_EQUAL_STRING(buffer, settings[ID_Doubles]->getHint(i));
+
+    // Value
+    double value;
+    TEST_ASSERT_TRUE(settings[ID_Doubles]->getValuePtr(i, &value, sizeof(value)));
+    double dval;
+    doubles.getValue(static_cast<Doubles>(i), dval);
+    TEST_ASSERT_EQUAL_DOUBLE(dval, value);
+
+    // Default value
+    TEST_ASSERT_EQUAL_DOUBLE(doubles.getDefaultValue(static_cast<Doubles>(i)),
+                             settings[ID_Doubles]->getDefaultValueAs<double>(i));
+  }
+
+  // Index out of bounds
+  size_t idx_out = settings[ID_Doubles]->getSize();
+
+  TEST_ASSERT_NULL(settings[ID_Doubles]->getKey(idx_out));
+  TEST_ASSERT_NULL(settings[ID_Doubles]->getHint(idx_out));
+  TEST_ASSERT_EQUAL(0, settings[ID_Doubles]->getDefaultValueAs<double>(idx_out));
+
+  double value;
+  TEST_ASSERT_FALSE(settings[ID_Doubles]->getValuePtr(idx_out, &value, sizeof(value)));
+
+  // Buffer too small
+  TEST_ASSERT_FALSE(settings[ID_Doubles]->getValuePtr(0, &value, 0));
+
+  // NVS key not saved yet - getValuePtr returns false and leaves value unmodified
+  uint8_t idx_nullptr = idx_out - 1;
+  TEST_ASSERT_FALSE(settings[ID_Doubles]->getValuePtr(idx_nullptr, &value, sizeof(value)));
+}
+
+void test_doubles_getValueOrDefault() {
+  double out;
+
+  // Key exists in NVS (Double_1 after setValue): should return the NVS value
+  double result = doubles.getValueOrDefault(Doubles::Double_1, out);
+  TEST_ASSERT_EQUAL_DOUBLE(new_double[0], result);
+  TEST_ASSERT_EQUAL_DOUBLE(new_double[0], out);
+
+  // Key not in NVS (Double_3 was never written): should return the default value
+  result = doubles.getValueOrDefault(Doubles::Double_3, out);
+  TEST_ASSERT_EQUAL_DOUBLE(doubles.getDefaultValue(Doubles::Double_3), result);
+  TEST_ASSERT_EQUAL_DOUBLE(doubles.getDefaultValue(Doubles::Double_3), out);
+}
+
+void test_doubles_getValuePtrOrDefault() {
+  double out;
+  bool ok;
+
+  // Key exists in NVS (index 0 = Double_1): returns true, out holds the NVS value
+  ok = settings[ID_Doubles]->getValuePtrOrDefault(0, &out, sizeof(out));
+  TEST_ASSERT_TRUE(ok);
+  TEST_ASSERT_EQUAL_DOUBLE(new_double[0], out);
+
+  // Key not in NVS (index 2 = Double_3): returns true, out holds the default value
+  ok = settings[ID_Doubles]->getValuePtrOrDefault(2, &out, sizeof(out));
+  TEST_ASSERT_TRUE(ok);
+  TEST_ASSERT_EQUAL_DOUBLE(doubles.getDefaultValue(Doubles::Double_3), out);
+
+  // Index out of bounds: returns false
+  TEST_ASSERT_FALSE(
+    settings[ID_Doubles]->getValuePtrOrDefault(settings[ID_Doubles]->getSize(), &out, sizeof(out)));
+
+  // Buffer too small: returns false
+  TEST_ASSERT_FALSE(settings[ID_Doubles]->getValuePtrOrDefault(0, &out, 0));
+}
+
+void test_doubles_format() {
+  TEST_ASSERT_EQUAL(0, doubles.formatAll());
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    double val;
+    doubles.getValue(static_cast<Doubles>(i), val);
+    TEST_ASSERT_EQUAL_DOUBLE(new_double[i], val);
+  }
+}
+
+void test_doubles_forceFormat() {
+  TEST_ASSERT_EQUAL(0, doubles.formatAll(true));
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    double val;
+    doubles.getValue(static_cast<Doubles>(i), val);
+    TEST_ASSERT_EQUAL_DOUBLE(doubles.getDefaultValue(static_cast<Doubles>(i)), val);
+  }
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_strings_getKey() {
+  TEST_ASSERT_EQUAL_STRING("String_1", strings.getKey(Strings::String_1));
+  TEST_ASSERT_EQUAL_STRING("String_2", strings.getKey(Strings::String_2));
+}
+
+void test_strings_getHint() {
+  TEST_ASSERT_EQUAL_STRING("My String 1", strings.getHint(Strings::String_1));
+  TEST_ASSERT_EQUAL_STRING("My String 2", strings.getHint(Strings::String_2));
+}
+
+void test_strings_getDefaultValue() {
+  TEST_ASSERT_EQUAL_STRING("str 1", strings.getDefaultValue(Strings::String_1).data);
+  TEST_ASSERT_EQUAL_STRING("str 2", strings.getDefaultValue(Strings::String_2).data);
+}
+
+void test_strings_setValue() {
+  TEST_ASSERT(strings.setValue(Strings::String_1, NVS::StrView{new_string[0]}));
+  TEST_ASSERT(strings.setValue(Strings::String_2, NVS::StrView{new_string[1]}));
+}
+
+void test_strings_getValue() {
+  char buf[32];
+  NVS::Str out{buf, sizeof(buf)};
+  TEST_ASSERT(strings.getValue(Strings::String_1, out));
+  TEST_ASSERT_EQUAL_STRING(new_string[0], out.data);
+  out = {buf, sizeof(buf)};
+  TEST_ASSERT(strings.getValue(Strings::String_2, out));
+  TEST_ASSERT_EQUAL_STRING(new_string[1], out.data);
+}
+
+void test_strings_hasKey() {
+  size_t index_found;
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    TEST_ASSERT(strings.hasKey(strings.getKey(static_cast<Strings>(i)), index_found));
+    TEST_ASSERT_EQUAL(i, index_found);
+  }
+}
+
+void test_strings_pointer() {
+  TEST_ASSERT_EQUAL(NVS::Type::String, settings[ID_Strings]->getType());
+
+  char buffer[64];
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    // Key
+    sprintf(buffer, "String_%u", static_cast<unsigned>(i + 1));
+    TEST_ASSERT_EQUAL_STRING(buffer, settings[ID_Strings]->getKey(i));
+
+    // Text
+    sprintf(buffer, "My String %u", static_cast<unsigned>(i + 1));
+    TEST_ASSERT_EQUAL_STRING(buffer, settings[ID_Strings]->getHint(i));
+
+    // Value via pointer interface
+    NVS::Str ptr_out{buffer, sizeof(buffer)};
+    TEST_ASSERT_TRUE(settings[ID_Strings]->getValuePtr(i, &ptr_out, sizeof(ptr_out)));
+    char sval[64];
+    NVS::Str sval_ns{sval, sizeof(sval)};
+    strings.getValue(static_cast<Strings>(i), sval_ns);
+    TEST_ASSERT_EQUAL_STRING(sval, buffer);
+
+    // Default value
+    TEST_ASSERT_EQUAL_STRING(strings.getDefaultValue(static_cast<Strings>(i)).data,
+                             settings[ID_Strings]->getDefaultValueAs<NVS::StrView>(i).data);
+  }
+
+  // Index out of bounds
+  size_t idx_out = settings[ID_Strings]->getSize();
+
+  TEST_ASSERT_NULL(settings[ID_Strings]->getKey(idx_out));
+  TEST_ASSERT_NULL(settings[ID_Strings]->getHint(idx_out));
+  TEST_ASSERT_NULL(settings[ID_Strings]->getDefaultValueAs<NVS::StrView>(idx_out).data);
+
+  NVS::Str oob{buffer, sizeof(buffer)};
+  TEST_ASSERT_FALSE(settings[ID_Strings]->getValuePtr(idx_out, &oob, sizeof(oob)));
+
+  // Buffer too small
+  NVS::Str tiny{buffer, 0};
+  TEST_ASSERT_FALSE(settings[ID_Strings]->getValuePtr(0, &tiny, sizeof(tiny)));
+
+  // NVS key not saved yet - getValuePtr returns false and leaves the buffer unmodified
+  uint8_t idx_nullptr = idx_out - 1;
+  NVS::Str def_out{buffer, sizeof(buffer)};
+  TEST_ASSERT_FALSE(settings[ID_Strings]->getValuePtr(idx_nullptr, &def_out, sizeof(def_out)));
+}
+
+void test_strings_getValueOrDefault() {
+  char buf[32];
+  NVS::Str out{buf, sizeof(buf)};
+
+  // Key exists in NVS (String_1 after setValue): should return the NVS value
+  NVS::Str result = strings.getValueOrDefault(Strings::String_1, out);
+  TEST_ASSERT_EQUAL_STRING(new_string[0], result.data);
+  TEST_ASSERT_EQUAL_STRING(new_string[0], out.data);
+
+  // Key not in NVS (String_3 was never written): should return the default value
+  out    = {buf, sizeof(buf)};
+  result = strings.getValueOrDefault(Strings::String_3, out);
+  TEST_ASSERT_EQUAL_STRING(strings.getDefaultValue(Strings::String_3).data, result.data);
+  TEST_ASSERT_EQUAL_STRING(strings.getDefaultValue(Strings::String_3).data, out.data);
+}
+
+void test_strings_getValuePtrOrDefault() {
+  char buf[32];
+  NVS::Str out{buf, sizeof(buf)};
+  bool ok;
+
+  // Key exists in NVS (index 0 = String_1): returns true, out holds the NVS value
+  ok = settings[ID_Strings]->getValuePtrOrDefault(0, &out, sizeof(out));
+  TEST_ASSERT_TRUE(ok);
+  TEST_ASSERT_EQUAL_STRING(new_string[0], out.data);
+
+  // Key not in NVS (index 2 = String_3): returns true, out holds the default value
+  out = {buf, sizeof(buf)};
+  ok  = settings[ID_Strings]->getValuePtrOrDefault(2, &out, sizeof(out));
+  TEST_ASSERT_TRUE(ok);
+  TEST_ASSERT_EQUAL_STRING(strings.getDefaultValue(Strings::String_3).data, out.data);
+
+  // Index out of bounds: returns false
+  TEST_ASSERT_FALSE(
+    settings[ID_Strings]->getValuePtrOrDefault(settings[ID_Strings]->getSize(), &out, sizeof(out)));
+
+  // Buffer too small (size field = 0): returns false
+  NVS::Str tiny{buf, 0};
+  TEST_ASSERT_FALSE(settings[ID_Strings]->getValuePtrOrDefault(0, &tiny, 0));
+}
+
+void test_strings_format() {
+  TEST_ASSERT_EQUAL(0, strings.formatAll());
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    char buf[32];
+    NVS::Str out{buf, sizeof(buf)};
+    TEST_ASSERT(strings.getValue(static_cast<Strings>(i), out));
+    TEST_ASSERT_EQUAL_STRING(new_string[i], out.data);
+  }
+}
+
+void test_strings_forceFormat() {
+  TEST_ASSERT_EQUAL(0, strings.formatAll(true));
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    char buf[32];
+    NVS::Str out{buf, sizeof(buf)};
+    TEST_ASSERT(strings.getValue(static_cast<Strings>(i), out));
+    TEST_ASSERT_EQUAL_STRING(strings.getDefaultValue(static_cast<Strings>(i)).data, out.data);
+  }
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_bytestreams_getKey() {
+  TEST_ASSERT_EQUAL_STRING("Stream_1", bytestreams.getKey(ByteStreams::Stream_1));
+  TEST_ASSERT_EQUAL_STRING("Stream_2", bytestreams.getKey(ByteStreams::Stream_2));
+}
+
+void test_bytestreams_getHint() {
+  TEST_ASSERT_EQUAL_STRING("My ByteStream 1", bytestreams.getHint(ByteStreams::Stream_1));
+  TEST_ASSERT_EQUAL_STRING("My ByteStream 2", bytestreams.getHint(ByteStreams::Stream_2));
+}
+
+void test_bytestreams_getDefaultValue() {
+  NVS::ByteStreamView default_value;
+
+  default_value = bytestreams.getDefaultValue(ByteStreams::Stream_1);
+  TEST_ASSERT_EQUAL_UINT32(bytestream1_default.size, default_value.size);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(bytestream1_default.data, default_value.data, default_value.size);
+  TEST_ASSERT_EQUAL(bytestream1_default.format, default_value.format);
+
+  default_value = bytestreams.getDefaultValue(ByteStreams::Stream_2);
+  TEST_ASSERT_EQUAL_UINT32(bytestream2_default.size, default_value.size);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(bytestream2_default.data, default_value.data, default_value.size);
+  TEST_ASSERT_EQUAL(bytestream2_default.format, default_value.format);
+}
+
+void test_bytestreams_setValue() {
+  TEST_ASSERT(bytestreams.setValue(ByteStreams::Stream_1, new_bytestream[0]));
+  TEST_ASSERT(bytestreams.setValue(ByteStreams::Stream_2, new_bytestream[1]));
+}
+
+void test_bytestreams_getValue() {
+  uint8_t buf[32];
+  NVS::ByteStream value{buf, sizeof(buf)};
+
+  TEST_ASSERT(bytestreams.getValue(ByteStreams::Stream_1, value));
+  TEST_ASSERT_EQUAL_UINT32(new_bytestream[0].size, value.size);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(new_bytestream[0].data, value.data, value.size);
+
+  value = {buf, sizeof(buf)};
+  TEST_ASSERT(bytestreams.getValue(ByteStreams::Stream_2, value));
+  TEST_ASSERT_EQUAL_UINT32(new_bytestream[1].size, value.size);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(new_bytestream[1].data, value.data, value.size);
+}
+
+void test_bytestreams_hasKey() {
+  size_t index_found;
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    TEST_ASSERT(bytestreams.hasKey(bytestreams.getKey(static_cast<ByteStreams>(i)), index_found));
+    TEST_ASSERT_EQUAL(i, index_found);
+  }
+}
+
+void test_bytestreams_pointer() {
+  TEST_ASSERT_EQUAL(NVS::Type::ByteStream, settings[ID_ByteStreams]->getType());
+
+  char key_buf[64];
+  uint8_t blob_buf[64];
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    // Key
+    sprintf(key_buf, "Stream_%u", static_cast<unsigned>(i + 1));
+    TEST_ASSERT_EQUAL_STRING(key_buf, settings[ID_ByteStreams]->getKey(i));
+
+    // Hint
+    sprintf(key_buf, "My ByteStream %u", static_cast<unsigned>(i + 1));
+    TEST_ASSERT_EQUAL_STRING(key_buf, settings[ID_ByteStreams]->getHint(i));
+
+    // Value via pointer interface
+    NVS::ByteStream ptr_value{blob_buf, sizeof(blob_buf)};
+    TEST_ASSERT_TRUE(settings[ID_ByteStreams]->getValuePtr(i, &ptr_value, sizeof(ptr_value)));
+
+    uint8_t ref_buf[64];
+    NVS::ByteStream ref_value{ref_buf, sizeof(ref_buf)};
+    bytestreams.getValue(static_cast<ByteStreams>(i), ref_value);
+
+    TEST_ASSERT_EQUAL_UINT32(ref_value.size, ptr_value.size);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(ref_value.data, ptr_value.data, ptr_value.size);
+
+    // Default value
+    TEST_ASSERT_EQUAL_UINT32(
+      bytestreams.getDefaultValue(static_cast<ByteStreams>(i)).size,
+      settings[ID_ByteStreams]->getDefaultValueAs<NVS::ByteStreamView>(i).size);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(
+      bytestreams.getDefaultValue(static_cast<ByteStreams>(i)).data,
+      settings[ID_ByteStreams]->getDefaultValueAs<NVS::ByteStreamView>(i).data,
+      settings[ID_ByteStreams]->getDefaultValueAs<NVS::ByteStreamView>(i).size);
+  }
+
+  // Index out of bounds
+  size_t idx_out = settings[ID_ByteStreams]->getSize();
+
+  TEST_ASSERT_NULL(settings[ID_ByteStreams]->getKey(idx_out));
+  TEST_ASSERT_NULL(settings[ID_ByteStreams]->getHint(idx_out));
+
+  NVS::ByteStreamView def_value;
+  def_value = settings[ID_ByteStreams]->getDefaultValueAs<NVS::ByteStreamView>(idx_out);
+  TEST_ASSERT_NULL(def_value.data);
+  TEST_ASSERT_EQUAL_UINT32(0, def_value.size);
+
+  NVS::ByteStream value{blob_buf, sizeof(blob_buf)};
+  TEST_ASSERT_FALSE(settings[ID_ByteStreams]->getValuePtr(idx_out, &value, sizeof(value)));
+
+  // Buffer too small for the blob (size=0 means 0-capacity buffer in our struct)
+  NVS::ByteStream tiny{blob_buf, 0};
+  TEST_ASSERT_FALSE(settings[ID_ByteStreams]->getValuePtr(0, &tiny, sizeof(tiny)));
+
+  // NVS key not saved yet - getValuePtr returns false and leaves the buffer unmodified
+  uint8_t idx_nullptr = idx_out - 1;
+  NVS::ByteStream def_out{blob_buf, sizeof(blob_buf)};
+  TEST_ASSERT_FALSE(settings[ID_ByteStreams]->getValuePtr(idx_nullptr, &def_out, sizeof(def_out)));
+}
+
+void test_bytestreams_getValueOrDefault() {
+  uint8_t buf[32];
+  NVS::ByteStream out{buf, sizeof(buf)};
+
+  // Key exists in NVS (Stream_1 after setValue): should return the NVS value
+  NVS::ByteStream result = bytestreams.getValueOrDefault(ByteStreams::Stream_1, out);
+  TEST_ASSERT_EQUAL_UINT32(new_bytestream[0].size, result.size);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(new_bytestream[0].data, result.data, result.size);
+  TEST_ASSERT_EQUAL_UINT32(new_bytestream[0].size, out.size);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(new_bytestream[0].data, out.data, out.size);
+
+  // Key not in NVS (Stream_3 was never written): should return the default value
+  out                      = {buf, sizeof(buf)};
+  result                   = bytestreams.getValueOrDefault(ByteStreams::Stream_3, out);
+  NVS::ByteStreamView def3 = bytestreams.getDefaultValue(ByteStreams::Stream_3);
+  TEST_ASSERT_EQUAL_UINT32(def3.size, result.size);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(def3.data, result.data, result.size);
+  TEST_ASSERT_EQUAL_UINT32(def3.size, out.size);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(def3.data, out.data, out.size);
+}
+
+void test_bytestreams_getValuePtrOrDefault() {
+  uint8_t buf[32];
+  NVS::ByteStream out{buf, sizeof(buf)};
+  bool ok;
+
+  // Key exists in NVS (index 0 = Stream_1): returns true, out holds the NVS value
+  ok = settings[ID_ByteStreams]->getValuePtrOrDefault(0, &out, sizeof(out));
+  TEST_ASSERT_TRUE(ok);
+  TEST_ASSERT_EQUAL_UINT32(new_bytestream[0].size, out.size);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(new_bytestream[0].data, out.data, out.size);
+
+  // Key not in NVS (index 2 = Stream_3): returns true, out holds the default value
+  out = {buf, sizeof(buf)};
+  ok  = settings[ID_ByteStreams]->getValuePtrOrDefault(2, &out, sizeof(out));
+  TEST_ASSERT_TRUE(ok);
+  NVS::ByteStreamView def3 = bytestreams.getDefaultValue(ByteStreams::Stream_3);
+  TEST_ASSERT_EQUAL_UINT32(def3.size, out.size);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(def3.data, out.data, out.size);
+
+  // Index out of bounds: returns false
+  TEST_ASSERT_FALSE(settings[ID_ByteStreams]->getValuePtrOrDefault(
+    settings[ID_ByteStreams]->getSize(), &out, sizeof(out)));
+
+  // Buffer too small (max_size = 0): returns false
+  NVS::ByteStream tiny{buf, 0};
+  TEST_ASSERT_FALSE(settings[ID_ByteStreams]->getValuePtrOrDefault(0, &tiny, 0));
+}
+
+void test_bytestreams_format() {
+  TEST_ASSERT_EQUAL(0, bytestreams.formatAll());
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    uint8_t buf[32];
+    NVS::ByteStream value{buf, sizeof(buf)};
+    TEST_ASSERT(bytestreams.getValue(static_cast<ByteStreams>(i), value));
+
+    TEST_ASSERT_EQUAL_UINT32(new_bytestream[i].size, value.size);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(new_bytestream[i].data, value.data, value.size);
+  }
+}
+
+void test_bytestreams_forceFormat() {
+  TEST_ASSERT_EQUAL(0, bytestreams.formatAll(true));
+
+  for (size_t i = 0; i < NVS_VALUES; i++) {
+    uint8_t buf[32];
+    NVS::ByteStream value{buf, sizeof(buf)};
+    TEST_ASSERT(bytestreams.getValue(static_cast<ByteStreams>(i), value));
+
+    TEST_ASSERT_EQUAL_UINT32(bytestreams.getDefaultValue(static_cast<ByteStreams>(i)).size,
+                             value.size);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(
+      bytestreams.getDefaultValue(static_cast<ByteStreams>(i)).data, value.data, value.size);
+  }
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_cache_begin() {
+  TEST_ASSERT(cached_uint32s.begin());
+  TEST_ASSERT(uncached_uint32s.begin());
+  TEST_ASSERT(uncached_uint32s.eraseAll());
+}
+
+void test_cache_absentKey() {
+  uint32_t val = 0;
+
+  // Key not in NVS: remembered as absent, reads fall back to the default
+  TEST_ASSERT_FALSE(cached_uint32s.getValue(UInt32s::UInt32_1, val));
+  TEST_ASSERT_EQUAL_UINT32(cached_uint32s.getDefaultValue(UInt32s::UInt32_1),
+                           cached_uint32s.getValueOrDefault(UInt32s::UInt32_1, val));
+}
+
+void test_cache_writeThrough() {
+  uint32_t val = 0;
+
+  TEST_ASSERT(cached_uint32s.setValue(UInt32s::UInt32_1, new_uint32[0]));
+  TEST_ASSERT(cached_uint32s.getValue(UInt32s::UInt32_1, val));
+  TEST_ASSERT_EQUAL_UINT32(new_uint32[0], val);
+
+  // The value also reached NVS
+  TEST_ASSERT(uncached_uint32s.getValue(UInt32s::UInt32_1, val));
+  TEST_ASSERT_EQUAL_UINT32(new_uint32[0], val);
+}
+
+void test_cache_invalidate() {
+  uint32_t val = 0;
+
+  // Written behind the cache's back: the cached object keeps serving the old value
+  TEST_ASSERT(uncached_uint32s.setValue(UInt32s::UInt32_1, new_uint32[1]));
+  TEST_ASSERT(cached_uint32s.getValue(UInt32s::UInt32_1, val));
+  TEST_ASSERT_EQUAL_UINT32(new_uint32[0], val);
+
+  cached_uint32s.invalidateCache();
+  TEST_ASSERT(cached_uint32s.getValue(UInt32s::UInt32_1, val));
+  TEST_ASSERT_EQUAL_UINT32(new_uint32[1], val);
+}
+
+void test_cache_eraseAll() {
+  uint32_t val = 0;
+
+  TEST_ASSERT(cached_uint32s.eraseAll());
+  TEST_ASSERT_FALSE(cached_uint32s.getValue(UInt32s::UInt32_1, val));
+  TEST_ASSERT_EQUAL_UINT32(cached_uint32s.getDefaultValue(UInt32s::UInt32_1),
+                           cached_uint32s.getValueOrDefault(UInt32s::UInt32_1, val));
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_transaction_commit() {
+  TEST_ASSERT(tx_uint32s.begin());
+  TEST_ASSERT(tx_uint32s.eraseAll());
+  tx_uint32s.setGlobalOnChangeCallback(txCallback, true);
+  tx_callback_entries = 0;
+
+  TEST_ASSERT(tx_uint32s.beginTransaction());
+  TEST_ASSERT_FALSE(tx_uint32s.beginTransaction());
+  TEST_ASSERT(tx_uint32s.inTransaction());
+
+  TEST_ASSERT(tx_uint32s.setValue(UInt32s::UInt32_1, new_uint32[0]));
+  TEST_ASSERT(tx_uint32s.setValue(UInt32s::UInt32_1, new_uint32[1]));
+  TEST_ASSERT(tx_uint32s.setValue(UInt32s::UInt32_2, new_uint32[0]));
+
+  // Staged only: nothing in NVS and no callbacks yet
+  uint32_t val;
+  TEST_ASSERT_FALSE(tx_uint32s.getValue(UInt32s::UInt32_1, val));
+  TEST_ASSERT_EQUAL(0, tx_callback_entries);
+
+#ifndef ARDUINO
+  uint32_t commits = nvs_host_get_counters().commits;
+  TEST_ASSERT(tx_uint32s.commit());
+  TEST_ASSERT_EQUAL(commits + 1, nvs_host_get_counters().commits);
+#else
+  TEST_ASSERT(tx_uint32s.commit());
+#endif
+  TEST_ASSERT_FALSE(tx_uint32s.inTransaction());
+  TEST_ASSERT_FALSE(tx_uint32s.commit());
+
+  // Last staged value wins, one callback per changed key
+  TEST_ASSERT(tx_uint32s.getValue(UInt32s::UInt32_1, val));
+  TEST_ASSERT_EQUAL_UINT32(new_uint32[1], val);
+  TEST_ASSERT(tx_uint32s.getValue(UInt32s::UInt32_2, val));
+  TEST_ASSERT_EQUAL_UINT32(new_uint32[0], val);
+  TEST_ASSERT_EQUAL(2, tx_callback_entries);
+}
+
+void test_transaction_abort() {
+  tx_callback_entries = 0;
+
+  TEST_ASSERT(tx_uint32s.beginTransaction());
+  TEST_ASSERT(tx_uint32s.setValue(UInt32s::UInt32_1, 1234));
+  TEST_ASSERT_EQUAL(0, tx_uint32s.formatAll(true));
+  tx_uint32s.abort();
+  TEST_ASSERT_FALSE(tx_uint32s.inTransaction());
+
+  uint32_t val;
+  TEST_ASSERT(tx_uint32s.getValue(UInt32s::UInt32_1, val));
+  TEST_ASSERT_EQUAL_UINT32(new_uint32[1], val);
+  TEST_ASSERT_FALSE(tx_uint32s.getValue(UInt32s::UInt32_3, val));
+  TEST_ASSERT_EQUAL(0, tx_callback_entries);
+}
+
+void test_transaction_guard() {
+  uint32_t val;
+
+  // Guard going out of scope without commit() aborts
+  {
+    NVS::Transaction tx(tx_uint32s);
+    TEST_ASSERT(tx.isActive());
+    TEST_ASSERT(tx_uint32s.setValue(UInt32s::UInt32_3, 1234));
+  }
+  TEST_ASSERT_FALSE(tx_uint32s.inTransaction());
+  TEST_ASSERT_FALSE(tx_uint32s.getValue(UInt32s::UInt32_3, val));
+
+  {
+    NVS::Transaction tx(tx_uint32s);
+    TEST_ASSERT(tx_uint32s.setValue(UInt32s::UInt32_3, 1234));
+    TEST_ASSERT(tx.commit());
+    TEST_ASSERT_FALSE(tx.isActive());
+  }
+  TEST_ASSERT(tx_uint32s.getValue(UInt32s::UInt32_3, val));
+  TEST_ASSERT_EQUAL_UINT32(1234, val);
+
+  tx_uint32s.clearGlobalOnChangeCallback();
+}
+
+void test_transaction_disabled() {
+  // Without Option::Transactions, no staging arrays and no transactions
+  static NVS::Settings<uint32_t, UInt32s, SETTINGS_COUNT(UINT32S)> plain(
+    "test_notx", {UINT32S(SETTINGS_EXPAND_SETTINGS)});
+  static_assert(sizeof(plain) + sizeof(std::array<uint32_t, SETTINGS_COUNT(UINT32S)>) <=
+                  sizeof(tx_uint32s),
+                "Staging arrays allocated without Option::Transactions");
+
+  TEST_ASSERT(plain.begin());
+  TEST_ASSERT_FALSE(plain.beginTransaction());
+  TEST_ASSERT_FALSE(plain.inTransaction());
+  TEST_ASSERT_FALSE(plain.commit());
+
+  NVS::WriteResult result = plain.setValue(UInt32s::UInt32_1, 4321);
+  TEST_ASSERT(result.status() == NVS::WriteStatus::Written);
+
+  // formatAll() still writes every default with a single commit
+#ifndef ARDUINO
+  uint32_t commits = nvs_host_get_counters().commits;
+#endif
+  TEST_ASSERT_EQUAL(0, plain.formatAll(true));
+#ifndef ARDUINO
+  TEST_ASSERT_EQUAL(commits + 1, nvs_host_get_counters().commits);
+#endif
+
+  uint32_t value = 0;
+  TEST_ASSERT(plain.getValue(UInt32s::UInt32_1, value));
+  TEST_ASSERT_EQUAL(plain.getDefaultValue(UInt32s::UInt32_1), value);
+
+  TEST_ASSERT(plain.eraseAll());
+  plain.end();
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_elide_scalars() {
+  TEST_ASSERT(elided_uint32s.begin());
+  TEST_ASSERT(elided_uint32s.eraseAll());
+  elided_uint32s.setGlobalOnChangeCallback(elideCallback, true);
+  elide_callback_entries = 0;
+
+  NVS::WriteResult result = elided_uint32s.setValue(UInt32s::UInt32_1, new_uint32[0]);
+  TEST_ASSERT(result);
+  TEST_ASSERT(result.status() == NVS::WriteStatus::Written);
+
+  result = elided_uint32s.setValue(UInt32s::UInt32_1, new_uint32[0]);
+  TEST_ASSERT(result);
+  TEST_ASSERT(result.status() == NVS::WriteStatus::Unchanged);
+  TEST_ASSERT_EQUAL(1, elide_callback_entries);
+
+  size_t index = static_cast<size_t>(UInt32s::UInt32_1);
+  TEST_ASSERT(elided_uint32s.setValuePtr(index, &new_uint32[0]).status() ==
+              NVS::WriteStatus::Unchanged);
+  TEST_ASSERT(elided_uint32s.setValuePtr(index, &new_uint32[1]).status() ==
+              NVS::WriteStatus::Written);
+  TEST_ASSERT_EQUAL(2, elide_callback_entries);
+
+  // Inside a transaction the write is staged, and skipped at commit time
+  TEST_ASSERT(elided_uint32s.beginTransaction());
+  TEST_ASSERT(elided_uint32s.setValue(UInt32s::UInt32_1, new_uint32[1]).status() ==
+              NVS::WriteStatus::Staged);
+  TEST_ASSERT(elided_uint32s.commit());
+  TEST_ASSERT_EQUAL(2, elide_callback_entries);
+
+  elided_uint32s.clearGlobalOnChangeCallback();
+}
+
+void test_elide_cachedScalars() {
+  TEST_ASSERT(elided_floats.begin());
+
+  TEST_ASSERT(elided_floats.setValue(Floats::Float_1, 0.0f).status() == NVS::WriteStatus::Written);
+  TEST_ASSERT(elided_floats.setValue(Floats::Float_1, 0.0f).status() ==
+              NVS::WriteStatus::Unchanged);
+
+  // Compared bit by bit
+  TEST_ASSERT(elided_floats.setValue(Floats::Float_1, -0.0f).status() == NVS::WriteStatus::Written);
+
+#ifndef ARDUINO
+  // Served by the cache: no NVS access at all
+  nvs_host_counters_t before = nvs_host_get_counters();
+  TEST_ASSERT(elided_floats.setValue(Floats::Float_1, -0.0f).status() ==
+              NVS::WriteStatus::Unchanged);
+  TEST_ASSERT_EQUAL(before.gets, nvs_host_get_counters().gets);
+  TEST_ASSERT_EQUAL(before.sets, nvs_host_get_counters().sets);
+  TEST_ASSERT_EQUAL(before.commits, nvs_host_get_counters().commits);
+#endif
+}
+
+void test_elide_strings() {
+  TEST_ASSERT(elided_strings.begin());
+
+  // Fingerprint unknown after begin(): the first write goes through
+  TEST_ASSERT(elided_strings.setValue(Strings::String_1, "abc").status() ==
+              NVS::WriteStatus::Written);
+  TEST_ASSERT(elided_strings.setValue(Strings::String_1, "abc").status() ==
+              NVS::WriteStatus::Unchanged);
+  TEST_ASSERT(elided_strings.setValue(Strings::String_1, "abd").status() ==
+              NVS::WriteStatus::Written);
+  TEST_ASSERT(elided_strings.setValue(Strings::String_1, "abdc").status() ==
+              NVS::WriteStatus::Written);
+
+  // After invalidation, a read learns the fingerprint again
+  elided_strings.invalidateCache();
+  TEST_ASSERT(elided_strings.setValue(Strings::String_1, "abdc").status() ==
+              NVS::WriteStatus::Written);
+
+  elided_strings.invalidateCache();
+  char buf[32];
+  NVS::Str stored_str(buf, sizeof(buf));
+  TEST_ASSERT(elided_strings.getValue(Strings::String_1, stored_str));
+  TEST_ASSERT(elided_strings.setValue(Strings::String_1, "abdc").status() ==
+              NVS::WriteStatus::Unchanged);
+}
+
+void test_elide_bytestreams() {
+  TEST_ASSERT(elided_bytestreams.begin());
+
+  const NVS::ByteStreamView& a = new_bytestream[0];
+  const NVS::ByteStreamView& b = new_bytestream[1];
+
+  TEST_ASSERT(elided_bytestreams.setValue(ByteStreams::Stream_1, a).status() ==
+              NVS::WriteStatus::Written);
+  TEST_ASSERT(elided_bytestreams.setValue(ByteStreams::Stream_1, a).status() ==
+              NVS::WriteStatus::Unchanged);
+  TEST_ASSERT(elided_bytestreams.setValue(ByteStreams::Stream_1, b).status() ==
+              NVS::WriteStatus::Written);
+
+  // Same bytes, shorter length
+  NVS::ByteStreamView b_short(b.data, b.size - 1);
+  TEST_ASSERT(elided_bytestreams.setValue(ByteStreams::Stream_1, b_short).status() ==
+              NVS::WriteStatus::Written);
+}
+
+void test_elide_formatAll() {
+  TEST_ASSERT_EQUAL(0, elided_uint32s.formatAll(true));
+
+#ifndef ARDUINO
+  // Every entry already holds its default: nothing written, nothing committed
+  nvs_host_counters_t before = nvs_host_get_counters();
+  TEST_ASSERT_EQUAL(0, elided_uint32s.formatAll(true));
+  TEST_ASSERT_EQUAL(before.sets, nvs_host_get_counters().sets);
+  TEST_ASSERT_EQUAL(before.commits, nvs_host_get_counters().commits);
+
+  // Only the entry that differs is rewritten
+  TEST_ASSERT(elided_uint32s.setValue(UInt32s::UInt32_2, new_uint32[0]));
+  before = nvs_host_get_counters();
+  TEST_ASSERT_EQUAL(0, elided_uint32s.formatAll(true));
+  TEST_ASSERT_EQUAL(before.sets + 1, nvs_host_get_counters().sets);
+  TEST_ASSERT_EQUAL(before.commits + 1, nvs_host_get_counters().commits);
+#endif
+
+  TEST_ASSERT(elided_uint32s.format(UInt32s::UInt32_2, true).status() ==
+              NVS::WriteStatus::Unchanged);
+  TEST_ASSERT_FALSE(elided_uint32s.format(UInt32s::UInt32_2));
+}
+
+void test_elide_disabled() {
+  TEST_ASSERT(uncached_uint32s.begin());
+  TEST_ASSERT(uncached_uint32s.setValue(UInt32s::UInt32_1, 1).status() ==
+              NVS::WriteStatus::Written);
+  TEST_ASSERT(uncached_uint32s.setValue(UInt32s::UInt32_1, 1).status() ==
+              NVS::WriteStatus::Written);
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_keyIndex_missingKeys() {
+  size_t index_found = 99;
+
+  TEST_ASSERT_FALSE(uint32s.hasKey("UInt32_4", index_found));
+  TEST_ASSERT_FALSE(uint32s.hasKey("UInt32_", index_found));
+  TEST_ASSERT_FALSE(uint32s.hasKey("", index_found));
+  TEST_ASSERT_FALSE(uint32s.hasKey(nullptr, index_found));
+  TEST_ASSERT_FALSE(uint32s.hasKey("Int32_1", index_found));
+  TEST_ASSERT_EQUAL(99, index_found);
+
+  // Index 0 is found like any other
+  TEST_ASSERT(uint32s.hasKey("UInt32_1", index_found));
+  TEST_ASSERT_EQUAL(0, index_found);
+}
+
+void test_keyIndex_runtimeList() {
+  enum class Many : uint8_t {};
+  constexpr size_t COUNT = 200;
+  using ManySettings     = NVS::Settings<uint32_t, Many, COUNT, NVS::Option::KeyIndex>;
+
+  // Objects without the option pay nothing for the index
+  using PlainSettings = NVS::Settings<uint32_t, Many, COUNT>;
+  static_assert(sizeof(ManySettings) - sizeof(PlainSettings) >=
+                  sizeof(NVS::Internal::KeyIndex<COUNT>) - alignof(PlainSettings),
+                "Index allocated without Option::KeyIndex");
+
+  static char keys[COUNT][8];
+  std::array<ManySettings::Struct, COUNT> list;
+
+  for (size_t i = 0; i < COUNT; i++) {
+    sprintf(keys[i], "k%u", static_cast<unsigned>(i));
+    list[i] = {keys[i], "", 0, true};
+  }
+
+  // Static: too large for the stack of the Arduino loop task
+  static ManySettings many("test_many", list);
+  size_t index_found;
+  char key[8];
+
+  for (size_t i = 0; i < COUNT; i++) {
+    TEST_ASSERT(many.hasKey(keys[i], index_found));
+    TEST_ASSERT_EQUAL(i, index_found);
+  }
+
+  for (size_t i = COUNT; i < COUNT * 2; i++) {
+    sprintf(key, "k%u", static_cast<unsigned>(i));
+    TEST_ASSERT_FALSE(many.hasKey(key, index_found));
+  }
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_registry_find() {
+  NVS::SettingRef ref;
+
+  TEST_ASSERT(NVS::findSetting("test/UInt32_2", ref));
+  TEST_ASSERT(ref.settings == &uint32s);
+  TEST_ASSERT_EQUAL(1, ref.index);
+
+  TEST_ASSERT(NVS::findSetting("test_tx/UInt32_3", ref));
+  TEST_ASSERT(ref.settings == &tx_uint32s);
+  TEST_ASSERT_EQUAL(2, ref.index);
+
+  // Bare keys resolve when only one open object has them
+  TEST_ASSERT(NVS::findSetting("Bool_3", ref));
+  TEST_ASSERT(ref.settings == &bools);
+  TEST_ASSERT_EQUAL(2, ref.index);
+
+  // Objects without Option::Registry are not registered
+  TEST_ASSERT(int32s.isOpen());
+  TEST_ASSERT_FALSE(NVS::findSetting("test/Int32_1", ref));
+
+  TEST_ASSERT_FALSE(NVS::findSetting("test/UInt32_4", ref));
+  TEST_ASSERT_FALSE(NVS::findSetting("nope/UInt32_1", ref));
+  TEST_ASSERT_FALSE(NVS::findSetting("tes/UInt32_1", ref));
+  TEST_ASSERT_FALSE(NVS::findSetting("/UInt32_1", ref));
+  TEST_ASSERT_FALSE(NVS::findSetting("test/", ref));
+  TEST_ASSERT_FALSE(NVS::findSetting("", ref));
+  TEST_ASSERT_FALSE(NVS::findSetting(nullptr, ref));
+}
+
+void test_registry_ambiguous() {
+  NVS::SettingRef ref;
+
+  // Same key in several namespaces
+  TEST_ASSERT_FALSE(NVS::findSetting("UInt32_1", ref));
+
+  // Same key twice in the same namespace
+  TEST_ASSERT(cached_uint32s.isOpen());
+  TEST_ASSERT(uncached_uint32s.isOpen());
+  TEST_ASSERT_FALSE(NVS::findSetting("test_cache/UInt32_1", ref));
+}
+
+void test_registry_endLeaves() {
+  NVS::SettingRef ref;
+
+  uncached_uint32s.end();
+  TEST_ASSERT(NVS::findSetting("test_cache/UInt32_1", ref));
+  TEST_ASSERT(ref.settings == &cached_uint32s);
+
+  cached_uint32s.end();
+  TEST_ASSERT_FALSE(NVS::findSetting("test_cache/UInt32_1", ref));
+
+  TEST_ASSERT(uncached_uint32s.begin());
+  TEST_ASSERT(NVS::findSetting("test_cache/UInt32_1", ref));
+  TEST_ASSERT(ref.settings == &uncached_uint32s);
+
+  // An object joining and leaving (growing the table, then removing its keys one by one) leaves
+  // the keys of the others in place
+  enum class Many : uint8_t {};
+  constexpr size_t COUNT = 40;
+  using ManySettings     = NVS::Settings<uint32_t, Many, COUNT, NVS::Option::Registry>;
+
+  static char keys[COUNT][8];
+  std::array<ManySettings::Struct, COUNT> list;
+  for (size_t i = 0; i < COUNT; i++) {
+    sprintf(keys[i], "m%u", static_cast<unsigned>(i));
+    list[i] = {keys[i], "", 0, true};
+  }
+  static ManySettings many("test_many", list);
+
+  for (int round = 0; round < 2; round++) {
+    TEST_ASSERT(many.begin());
+    for (size_t i = 0; i < COUNT; i++) {
+      TEST_ASSERT(NVS::findSetting(keys[i], ref));
+      TEST_ASSERT(ref.settings == &many);
+      TEST_ASSERT_EQUAL(i, ref.index);
+    }
+
+    many.end();
+    TEST_ASSERT_FALSE(NVS::findSetting("test_many/m7", ref));
+    TEST_ASSERT(NVS::findSetting("test/UInt32_2", ref));
+    TEST_ASSERT(ref.settings == &uint32s);
+    TEST_ASSERT(NVS::findSetting("Bool_3", ref));
+    TEST_ASSERT(ref.settings == &bools);
+  }
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_size_getValueSize() {
+  TEST_ASSERT(size_strings.begin());
+  TEST_ASSERT(size_bytestreams.begin());
+  TEST_ASSERT(size_strings.eraseAll());
+
+  size_t size = 0;
+  TEST_ASSERT_FALSE(size_strings.getValueSize(Strings::String_1, size));
+
+  TEST_ASSERT(size_strings.setValue(Strings::String_1, "hello"));
+  TEST_ASSERT(size_strings.getValueSize(Strings::String_1, size));
+  TEST_ASSERT_EQUAL(6, size);
+
+  TEST_ASSERT(size_bytestreams.setValue(ByteStreams::Stream_1, new_bytestream[0]));
+  TEST_ASSERT(size_bytestreams.getValueSize(ByteStreams::Stream_1, size));
+  TEST_ASSERT_EQUAL(new_bytestream[0].size, size);
+
+  TEST_ASSERT(settings[ID_UInt32s]->getValueSize(0, size));
+  TEST_ASSERT_EQUAL(sizeof(uint32_t), size);
+  TEST_ASSERT_FALSE(settings[ID_UInt32s]->getValueSize(3, size));
+}
+
+void test_size_cachedLength() {
+  TEST_ASSERT(size_cached_strings.begin());
+
+  char buf[16];
+  NVS::Str out(buf, sizeof(buf));
+  size_t size = 0;
+
+  TEST_ASSERT(size_cached_strings.setValue(Strings::String_2, "cached"));
+
+#ifndef ARDUINO
+  // Known since the write: no NVS access
+  uint32_t gets = nvs_host_get_counters().gets;
+  TEST_ASSERT(size_cached_strings.getValueSize(Strings::String_2, size));
+  TEST_ASSERT_EQUAL(7, size);
+  TEST_ASSERT_EQUAL(gets, nvs_host_get_counters().gets);
+
+  // Learned again by a read after invalidation
+  size_cached_strings.invalidateCache();
+  TEST_ASSERT(size_cached_strings.getValue(Strings::String_1, out));
+  gets = nvs_host_get_counters().gets;
+  TEST_ASSERT(size_cached_strings.getValueSize(Strings::String_1, size));
+  TEST_ASSERT_EQUAL(6, size);
+  TEST_ASSERT_EQUAL(gets, nvs_host_get_counters().gets);
+#else
+  TEST_ASSERT(size_cached_strings.getValueSize(Strings::String_2, size));
+  TEST_ASSERT_EQUAL(7, size);
+#endif
+}
+
+void test_size_bufferFit() {
+  char buf[8];
+  memset(buf, 'x', sizeof(buf));
+
+  // "hello" needs 6 bytes: a 5-byte buffer is rejected and left untouched
+  NVS::Str small(buf, 5);
+  TEST_ASSERT_FALSE(size_strings.getValue(Strings::String_1, small));
+  TEST_ASSERT_EQUAL('x', buf[0]);
+
+  NVS::Str exact(buf, 6);
+#ifndef ARDUINO
+  uint32_t gets = nvs_host_get_counters().gets;
+  TEST_ASSERT(size_strings.getValue(Strings::String_1, exact));
+  TEST_ASSERT_EQUAL(gets + 1, nvs_host_get_counters().gets);
+#else
+  TEST_ASSERT(size_strings.getValue(Strings::String_1, exact));
+#endif
+  TEST_ASSERT_EQUAL_STRING("hello", buf);
+
+  uint8_t bytes[8];
+  NVS::ByteStream small_bs(bytes, new_bytestream[0].size - 1);
+  TEST_ASSERT_FALSE(size_bytestreams.getValue(ByteStreams::Stream_1, small_bs));
+
+  NVS::ByteStream exact_bs(bytes, new_bytestream[0].size);
+  TEST_ASSERT(size_bytestreams.getValue(ByteStreams::Stream_1, exact_bs));
+  TEST_ASSERT_EQUAL(new_bytestream[0].size, exact_bs.size);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(new_bytestream[0].data, bytes, exact_bs.size);
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_packed_readWrite() {
+  TEST_ASSERT(packed_bools.begin());
+  TEST_ASSERT(packed_bools.eraseAll());
+
+  packed_bools.setOnChangeCallback(
+    Bools::Bool_2,
+    [](const char* key, const Bools setting, const bool value) { packed_callback_entries++; },
+    true);
+
+  bool val = true;
+  TEST_ASSERT_FALSE(packed_bools.getValue(Bools::Bool_1, val));
+  TEST_ASSERT_TRUE(packed_bools.getValueOrDefault(Bools::Bool_2, val));
+
+  TEST_ASSERT(packed_bools.setValue(Bools::Bool_2, false));
+  TEST_ASSERT(packed_bools.getValue(Bools::Bool_2, val));
+  TEST_ASSERT_FALSE(val);
+  TEST_ASSERT_FALSE(packed_bools.getValue(Bools::Bool_1, val));
+  TEST_ASSERT_EQUAL(1, packed_callback_entries);
+
+  TEST_ASSERT(packed_bools.setValue(Bools::Bool_3, true));
+  TEST_ASSERT(packed_bools.getValue(Bools::Bool_3, val));
+  TEST_ASSERT_TRUE(val);
+  TEST_ASSERT(packed_bools.getValue(Bools::Bool_2, val));
+  TEST_ASSERT_FALSE(val);
+  TEST_ASSERT_EQUAL(1, packed_callback_entries);
+
+  // Persisted: reload from NVS
+  packed_bools.end();
+  TEST_ASSERT(packed_bools.begin());
+  TEST_ASSERT(packed_bools.getValue(Bools::Bool_3, val));
+  TEST_ASSERT_TRUE(val);
+  TEST_ASSERT(packed_bools.getValue(Bools::Bool_2, val));
+  TEST_ASSERT_FALSE(val);
+  TEST_ASSERT_FALSE(packed_bools.getValue(Bools::Bool_1, val));
+}
+
+void test_packed_singleKey() {
+  size_t used = 0;
+  nvs_handle_t handle;
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_open("test_packed", NVS_READONLY, &handle));
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_get_used_entry_count(handle, &used));
+  nvs_close(handle);
+  TEST_ASSERT_EQUAL(1, used);
+
+#ifndef ARDUINO
+  // One read loads every flag
+  packed_bools.invalidateCache();
+  uint32_t gets = nvs_host_get_counters().gets;
+  bool val;
+  for (size_t i = 0; i < SETTINGS_COUNT(BOOLS); i++)
+    packed_bools.getValue(static_cast<Bools>(i), val);
+  TEST_ASSERT_EQUAL(gets + 1, nvs_host_get_counters().gets);
+#endif
+}
+
+void test_packed_format() {
+  TEST_ASSERT_FALSE(packed_bools.format(Bools::Bool_2));
+  TEST_ASSERT(packed_bools.format(Bools::Bool_2, true));
+  TEST_ASSERT_EQUAL(2, packed_callback_entries);
+
+  TEST_ASSERT_EQUAL(0, packed_bools.formatAll(true));
+  TEST_ASSERT_EQUAL(3, packed_callback_entries);
+
+  for (size_t i = 0; i < SETTINGS_COUNT(BOOLS); i++) {
+    bool val;
+    TEST_ASSERT(packed_bools.getValue(static_cast<Bools>(i), val));
+    TEST_ASSERT_EQUAL(packed_bools.getDefaultValue(i), val);
+  }
+
+  packed_bools.clearOnChangeCallback(Bools::Bool_2);
+}
+
+void test_packed_transaction() {
+#ifndef ARDUINO
+  uint32_t sets = nvs_host_get_counters().sets;
+#endif
+
+  {
+    NVS::Transaction tx(packed_bools);
+    TEST_ASSERT(packed_bools.setValue(Bools::Bool_1, true));
+    TEST_ASSERT(packed_bools.setValue(Bools::Bool_2, false));
+    TEST_ASSERT(packed_bools.setValue(Bools::Bool_3, true));
+    TEST_ASSERT(tx.commit());
+  }
+
+#ifndef ARDUINO
+  TEST_ASSERT_EQUAL(sets + 1, nvs_host_get_counters().sets);
+#endif
+
+  bool val;
+  TEST_ASSERT(packed_bools.getValue(Bools::Bool_1, val));
+  TEST_ASSERT_TRUE(val);
+  TEST_ASSERT(packed_bools.getValue(Bools::Bool_2, val));
+  TEST_ASSERT_FALSE(val);
+}
+
+void test_packed_manyFlags() {
+  enum class Flags : uint8_t {};
+  constexpr size_t COUNT = 60;
+
+  static char keys[COUNT][8];
+  std::array<NVS::Settings<bool, Flags, COUNT>::Struct, COUNT> list;
+  for (size_t i = 0; i < COUNT; i++) {
+    sprintf(keys[i], "f%u", static_cast<unsigned>(i));
+    list[i] = {keys[i], "", false, true};
+  }
+
+  // Static: too large for the stack of the Arduino loop task
+  static NVS::Settings<bool, Flags, COUNT> plain("test_flags", list);
+  static NVS::Settings<bool, Flags, COUNT, NVS::Option::Packed> packed("test_flags_p", list);
+
+  TEST_ASSERT(plain.begin());
+  TEST_ASSERT(packed.begin());
+  TEST_ASSERT(plain.eraseAll());
+  TEST_ASSERT(packed.eraseAll());
+
+  for (size_t i = 0; i < COUNT; i++) {
+    TEST_ASSERT(plain.setValue(static_cast<Flags>(i), i % 3 == 0));
+    TEST_ASSERT(packed.setValue(static_cast<Flags>(i), i % 3 == 0));
+  }
+
+  packed.end();
+  TEST_ASSERT(packed.begin());
+  for (size_t i = 0; i < COUNT; i++) {
+    bool val;
+    TEST_ASSERT(packed.getValue(static_cast<Flags>(i), val));
+    TEST_ASSERT_EQUAL(i % 3 == 0, val);
+  }
+
+  // One blob (index + header + data entries) instead of one entry per flag
+  nvs_handle_t handle;
+  size_t used_plain = 0, used_packed = 0;
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_open("test_flags", NVS_READONLY, &handle));
+  nvs_get_used_entry_count(handle, &used_plain);
+  nvs_close(handle);
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_open("test_flags_p", NVS_READONLY, &handle));
+  nvs_get_used_entry_count(handle, &used_packed);
+  nvs_close(handle);
+
+  TEST_ASSERT_EQUAL(COUNT, used_plain);
+  TEST_ASSERT_LESS_OR_EQUAL(3, used_packed);
+
+  plain.eraseAll();
+  packed.eraseAll();
+  plain.end();
+  packed.end();
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_record_empty() {
+  TEST_ASSERT(record_floats.begin());
+  TEST_ASSERT(record_floats.eraseAll());
+  TEST_ASSERT_FALSE(record_floats.loadAll());
+
+  float val;
+  TEST_ASSERT_FALSE(record_floats.getValue(Floats::Float_1, val));
+  TEST_ASSERT_EQUAL_FLOAT(1.1f, record_floats.getValueOrDefault(Floats::Float_1, val));
+}
+
+void test_record_writeThrough() {
+  TEST_ASSERT(record_floats.setValue(Floats::Float_2, new_float[0]));
+  TEST_ASSERT(record_floats.loadAll());
+
+  float val;
+  TEST_ASSERT(record_floats.getValue(Floats::Float_2, val));
+  TEST_ASSERT_EQUAL_FLOAT(new_float[0], val);
+  TEST_ASSERT_FALSE(record_floats.getValue(Floats::Float_1, val));
+
+  // A single key in the namespace, loaded with a single read
+  nvs_handle_t handle;
+  size_t used = 0;
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_open("test_record", NVS_READONLY, &handle));
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_find_key(handle, NVS::Internal::RECORD_KEY, nullptr));
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_get_used_entry_count(handle, &used));
+  nvs_close(handle);
+  TEST_ASSERT_LESS_OR_EQUAL(3, used);
+
+#ifndef ARDUINO
+  uint32_t gets = nvs_host_get_counters().gets;
+  TEST_ASSERT(record_floats.loadAll());
+  for (size_t i = 0; i < SETTINGS_COUNT(FLOATS); i++)
+    record_floats.getValue(static_cast<Floats>(i), val);
+  TEST_ASSERT_EQUAL(gets + 1, nvs_host_get_counters().gets);
+#endif
+}
+
+void test_record_saveAll() {
+  TEST_ASSERT(record_floats.saveAll());
+  TEST_ASSERT(record_floats.loadAll());
+
+  float val;
+  TEST_ASSERT(record_floats.getValue(Floats::Float_1, val));
+  TEST_ASSERT_EQUAL_FLOAT(1.1f, val);
+  TEST_ASSERT(record_floats.getValue(Floats::Float_2, val));
+  TEST_ASSERT_EQUAL_FLOAT(new_float[0], val);
+  TEST_ASSERT(record_floats.getValue(Floats::Float_3, val));
+  TEST_ASSERT_EQUAL_FLOAT(3.3f, val);
+
+  // Transactions store the record once
+  {
+    NVS::Transaction tx(record_floats);
+    TEST_ASSERT(record_floats.setValue(Floats::Float_1, 5.5f));
+    TEST_ASSERT(record_floats.setValue(Floats::Float_3, 6.5f));
+    TEST_ASSERT(tx.commit());
+  }
+  TEST_ASSERT(record_floats.loadAll());
+  TEST_ASSERT(record_floats.getValue(Floats::Float_3, val));
+  TEST_ASSERT_EQUAL_FLOAT(6.5f, val);
+}
+
+void test_record_version() {
+  record_floats.setRecordVersion(2);
+  TEST_ASSERT_FALSE(record_floats.loadAll());
+
+  float val;
+  TEST_ASSERT_FALSE(record_floats.getValue(Floats::Float_1, val));
+
+  TEST_ASSERT(record_floats.saveAll());
+  TEST_ASSERT(record_floats.loadAll());
+  TEST_ASSERT(record_floats.getValue(Floats::Float_1, val));
+  TEST_ASSERT_EQUAL_FLOAT(1.1f, val);
+
+  record_floats.setRecordVersion(0);
+  TEST_ASSERT_FALSE(record_floats.loadAll());
+  record_floats.setRecordVersion(2);
+}
+
+void test_record_corrupted() {
+  TEST_ASSERT(record_floats.loadAll());
+
+  // Flip one byte of the stored record
+  nvs_handle_t handle;
+  uint8_t blob[64];
+  size_t size = sizeof(blob);
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_open("test_record", NVS_READWRITE, &handle));
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_get_blob(handle, NVS::Internal::RECORD_KEY, blob, &size));
+  blob[size - 1] ^= 0x01;
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_set_blob(handle, NVS::Internal::RECORD_KEY, blob, size));
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_commit(handle));
+  nvs_close(handle);
+
+  TEST_ASSERT_FALSE(record_floats.loadAll());
+
+  float val;
+  TEST_ASSERT_FALSE(record_floats.getValue(Floats::Float_3, val));
+  TEST_ASSERT_EQUAL_FLOAT(3.3f, record_floats.getValueOrDefault(Floats::Float_3, val));
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_snapshot_defaults() {
+  std::array<uint32_t, SETTINGS_COUNT(UINT32S)> values{};
+  size_t found = 0;
+
+  TEST_ASSERT_FALSE(snapshot_uint32s.snapshot(values));
+
+  TEST_ASSERT(snapshot_uint32s.begin());
+  TEST_ASSERT(snapshot_uint32s.eraseAll());
+
+  // Empty namespace: every value is its default
+  TEST_ASSERT(snapshot_uint32s.snapshot(values, &found));
+  TEST_ASSERT_EQUAL(0, found);
+  TEST_ASSERT_EQUAL(1, values[0]);
+  TEST_ASSERT_EQUAL(2, values[1]);
+  TEST_ASSERT_EQUAL(3, values[2]);
+
+  TEST_ASSERT(snapshot_uint32s.setValue(UInt32s::UInt32_2, new_uint32[1]));
+
+#ifndef ARDUINO
+  // Only the stored key is read
+  uint32_t gets = nvs_host_get_counters().gets;
+  TEST_ASSERT(snapshot_uint32s.snapshot(values, &found));
+  TEST_ASSERT_EQUAL(gets + 1, nvs_host_get_counters().gets);
+#else
+  TEST_ASSERT(snapshot_uint32s.snapshot(values, &found));
+#endif
+  TEST_ASSERT_EQUAL(1, found);
+  TEST_ASSERT_EQUAL(1, values[0]);
+  TEST_ASSERT_EQUAL(new_uint32[1], values[1]);
+  TEST_ASSERT_EQUAL(3, values[2]);
+}
+
+void test_snapshot_cached() {
+  std::array<float, SETTINGS_COUNT(FLOATS)> values{};
+  size_t found = 0;
+
+  TEST_ASSERT(snapshot_floats.begin());
+  TEST_ASSERT(snapshot_floats.setValue(Floats::Float_1, new_float[0]));
+
+  TEST_ASSERT(snapshot_floats.snapshot(values, &found));
+  TEST_ASSERT_EQUAL(1, found);
+  TEST_ASSERT_EQUAL_FLOAT(new_float[0], values[0]);
+  TEST_ASSERT_EQUAL_FLOAT(2.2, values[1]);
+  TEST_ASSERT_EQUAL_FLOAT(3.3, values[2]);
+
+#ifndef ARDUINO
+  // Every entry is now cached, absent ones included: no NVS access at all
+  uint32_t gets = nvs_host_get_counters().gets;
+  TEST_ASSERT(snapshot_floats.snapshot(values, &found));
+  TEST_ASSERT_EQUAL(gets, nvs_host_get_counters().gets);
+  TEST_ASSERT_EQUAL(1, found);
+#endif
+}
+
+void test_snapshot_untyped() {
+  TEST_ASSERT(snapshot_strings.begin());
+  TEST_ASSERT(snapshot_strings.setValue(Strings::String_3, "snap"));
+
+  char buf[SETTINGS_COUNT(STRINGS)][16];
+  NVS::Str values[SETTINGS_COUNT(STRINGS)] = {
+    {buf[0], sizeof(buf[0])}, {buf[1], sizeof(buf[1])}, {buf[2], sizeof(buf[2])}};
+  size_t found = 0;
+
+  NVS::ISettings& s = snapshot_strings;
+  TEST_ASSERT_FALSE(s.snapshotPtr(values, sizeof(values) - 1));
+  TEST_ASSERT(s.snapshotPtr(values, sizeof(values), &found));
+  TEST_ASSERT_EQUAL(1, found);
+  TEST_ASSERT_EQUAL_STRING("str 1", buf[0]);
+  TEST_ASSERT_EQUAL_STRING("str 2", buf[1]);
+  TEST_ASSERT_EQUAL_STRING("snap", buf[2]);
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_async_queued() {
+  TEST_ASSERT(async_uint32s.begin());
+  TEST_ASSERT(async_twin.begin());
+  TEST_ASSERT(async_uint32s.eraseAll());
+
+  NVS::WriteResult result = async_uint32s.setValue(UInt32s::UInt32_1, 100);
+  TEST_ASSERT(result);
+  TEST_ASSERT_EQUAL(NVS::WriteStatus::Queued, result.status());
+
+  // Staged values are served before the writer commits them
+  uint32_t value = 0;
+  TEST_ASSERT(async_uint32s.getValue(UInt32s::UInt32_1, value));
+  TEST_ASSERT_EQUAL(100, value);
+
+  NVS::flush();
+  TEST_ASSERT(async_twin.getValue(UInt32s::UInt32_1, value));
+  TEST_ASSERT_EQUAL(100, value);
+
+  // A burst of writes of one key ends with its last value
+  for (uint32_t i = 0; i < 50; i++) {
+    TEST_ASSERT(async_uint32s.setValue(UInt32s::UInt32_2, i));
+  }
+  TEST_ASSERT(async_uint32s.getValue(UInt32s::UInt32_2, value));
+  TEST_ASSERT_EQUAL(49, value);
+
+  NVS::flush();
+  TEST_ASSERT(async_twin.getValue(UInt32s::UInt32_2, value));
+  TEST_ASSERT_EQUAL(49, value);
+}
+
+void test_async_callbacks() {
+  async_uint32s.setOnChangeCallback(
+    UInt32s::UInt32_3,
+    [](const char* key, const UInt32s setting, const uint32_t value) { async_change_entries++; },
+    false);
+  async_uint32s.setWriteDoneCallback(
+    [](const char* key, const UInt32s setting, const NVS::WriteResult result) {
+      async_done_entries++;
+      async_last_status = result.status();
+    });
+
+  TEST_ASSERT(async_uint32s.setValue(UInt32s::UInt32_3, 7));
+  NVS::flush();
+  TEST_ASSERT_EQUAL(1, async_change_entries);
+  TEST_ASSERT_EQUAL(1, async_done_entries);
+  TEST_ASSERT_EQUAL(NVS::WriteStatus::Written, async_last_status);
+
+  async_uint32s.clearOnChangeCallback(UInt32s::UInt32_3);
+  async_uint32s.setWriteDoneCallback(nullptr);
+
+  // Elision runs on the writer, against NVS
+  TEST_ASSERT(async_floats.begin());
+  async_floats.setWriteDoneCallback(
+    [](const char* key, const Floats setting, const NVS::WriteResult result) {
+      async_last_status = result.status();
+    });
+
+  TEST_ASSERT(async_floats.setValue(Floats::Float_1, 1.5));
+  NVS::flush();
+  TEST_ASSERT_EQUAL(NVS::WriteStatus::Written, async_last_status);
+
+  TEST_ASSERT(async_floats.setValue(Floats::Float_1, 1.5));
+  NVS::flush();
+  TEST_ASSERT_EQUAL(NVS::WriteStatus::Unchanged, async_last_status);
+
+  async_floats.setWriteDoneCallback(nullptr);
+}
+
+void test_async_formatAndEnd() {
+  // The writer already batches: no transactions
+  TEST_ASSERT_FALSE(async_uint32s.beginTransaction());
+
+  TEST_ASSERT_EQUAL(0, async_uint32s.formatAll(true));
+  NVS::flush();
+
+  uint32_t value = 0;
+  TEST_ASSERT(async_twin.getValue(UInt32s::UInt32_1, value));
+  TEST_ASSERT_EQUAL(1, value);
+  TEST_ASSERT(async_twin.getValue(UInt32s::UInt32_3, value));
+  TEST_ASSERT_EQUAL(3, value);
+
+  // end() flushes the queued writes before closing the handle
+  TEST_ASSERT(async_uint32s.setValue(UInt32s::UInt32_2, 222));
+  async_uint32s.end();
+  TEST_ASSERT(async_twin.getValue(UInt32s::UInt32_2, value));
+  TEST_ASSERT_EQUAL(222, value);
+}
+
+#ifndef ARDUINO
+void test_async_callbackRace() {
+  TEST_ASSERT(async_uint32s.begin());
+
+  constexpr int ROUNDS = 500;
+  static std::atomic<uint32_t> changes{0};
+  std::atomic<bool> done{false};
+  changes = 0;
+
+  // Callbacks come and go while the writer task runs them (SETTINGS_SANITIZE_THREAD checks it)
+  std::thread registrar([&] {
+    while (!done) {
+      async_uint32s.setOnChangeCallback(
+        UInt32s::UInt32_1,
+        [](const char* key, const UInt32s setting, const uint32_t value) { changes++; },
+        false);
+      async_uint32s.setGlobalOnChangeCallback(
+        [](const char* key, NVS::Type type, size_t index, const void* value) { changes++; },
+        false);
+      async_uint32s.clearOnChangeCallback(UInt32s::UInt32_1);
+      async_uint32s.clearGlobalOnChangeCallback();
+    }
+  });
+
+  for (uint32_t i = 1; i <= ROUNDS; i++) {
+    TEST_ASSERT(async_uint32s.setValue(UInt32s::UInt32_1, i));
+    if (i % 10 == 0) NVS::flush();
+  }
+  NVS::flush();
+
+  done = true;
+  registrar.join();
+
+  uint32_t value = 0;
+  TEST_ASSERT(async_twin.getValue(UInt32s::UInt32_1, value));
+  TEST_ASSERT_EQUAL(ROUNDS, value);
+  TEST_ASSERT_LESS_OR_EQUAL(2 * ROUNDS, changes.load());
+  async_uint32s.end();
+}
+
+void test_async_endRace() {
+  TEST_ASSERT(async_uint32s.begin());
+
+  // Writes keep coming while the object is closed and reopened: the writer task never uses the
+  // handle end() closes (SETTINGS_SANITIZE_THREAD checks it)
+  std::atomic<bool> done{false};
+  std::atomic<uint32_t> queued{0};
+  std::thread setter([&] {
+    for (uint32_t i = 1; !done; i++) {
+      if (async_uint32s.setValue(UInt32s::UInt32_2, i)) queued++;
+    }
+  });
+
+  for (int round = 0; round < 50; round++) {
+    async_uint32s.end();
+    TEST_ASSERT_FALSE(async_uint32s.isOpen());
+    TEST_ASSERT(async_uint32s.begin());
+  }
+
+  done = true;
+  setter.join();
+  TEST_ASSERT_GREATER_THAN(0, queued.load());
+
+  // Closed: writes fail at once instead of reaching the writer
+  async_uint32s.end();
+  TEST_ASSERT_FALSE(async_uint32s.setValue(UInt32s::UInt32_2, 1));
+}
+#endif
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_coalesce_burst() {
+  TEST_ASSERT(coalesce_uint32s.begin());
+  TEST_ASSERT(coalesce_twin.begin());
+  TEST_ASSERT(coalesce_uint32s.eraseAll());
+
+  coalesce_uint32s.setCoalesceWindow(60000);
+  coalesce_uint32s.setOnChangeCallback(
+    UInt32s::UInt32_1,
+    [](const char* key, const UInt32s setting, const uint32_t value) { coalesce_change_entries++; },
+    false);
+  coalesce_uint32s.setWriteDoneCallback(
+    [](const char* key, const UInt32s setting, const NVS::WriteResult result) {
+      coalesce_done_entries++;
+    });
+
+  for (uint32_t i = 1; i <= 20; i++) {
+    TEST_ASSERT(coalesce_uint32s.setValue(UInt32s::UInt32_1, i));
+  }
+
+  // Every logical change is notified at once, nothing is written within the window
+  uint32_t value = 0;
+  TEST_ASSERT_EQUAL(20, coalesce_change_entries);
+  TEST_ASSERT_FALSE(coalesce_twin.getValue(UInt32s::UInt32_1, value));
+  TEST_ASSERT(coalesce_uint32s.getValue(UInt32s::UInt32_1, value));
+  TEST_ASSERT_EQUAL(20, value);
+
+  // flush() does not wait for the window: one write of the last value
+  NVS::flush();
+  TEST_ASSERT(coalesce_twin.getValue(UInt32s::UInt32_1, value));
+  TEST_ASSERT_EQUAL(20, value);
+  TEST_ASSERT_EQUAL(20, coalesce_change_entries);
+  TEST_ASSERT_EQUAL(1, coalesce_done_entries);
+
+  NVS::WriteStats stats = coalesce_uint32s.getWriteStats();
+  TEST_ASSERT_EQUAL(20, stats.queued);
+  TEST_ASSERT_EQUAL(19, stats.coalesced);
+  TEST_ASSERT_EQUAL(1, stats.written);
+  TEST_ASSERT_EQUAL(0, stats.failed);
+
+  coalesce_uint32s.resetWriteStats();
+  TEST_ASSERT_EQUAL(0, coalesce_uint32s.getWriteStats().queued);
+  coalesce_uint32s.clearOnChangeCallback(UInt32s::UInt32_1);
+  coalesce_uint32s.setWriteDoneCallback(nullptr);
+}
+
+void test_coalesce_windowExpires() {
+  // Per setting: a short window on one key, none on another
+  coalesce_uint32s.setCoalesceWindow(60000);
+  coalesce_uint32s.setCoalesceWindow(UInt32s::UInt32_2, 20);
+  coalesce_uint32s.setCoalesceWindow(UInt32s::UInt32_3, 0);
+
+  TEST_ASSERT(coalesce_uint32s.setValue(UInt32s::UInt32_1, 100));
+  TEST_ASSERT(coalesce_uint32s.setValue(UInt32s::UInt32_2, 200));
+  TEST_ASSERT(coalesce_uint32s.setValue(UInt32s::UInt32_3, 300));
+
+  // The writer stores UInt32_3 at once and UInt32_2 after its window, on its own
+  uint32_t value = 0;
+  for (int i = 0; i < 200 && !coalesce_twin.getValue(UInt32s::UInt32_2, value); i++) {
+#ifdef ARDUINO
+    delay(5);
+#else
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+#endif
+  }
+
+  TEST_ASSERT(coalesce_twin.getValue(UInt32s::UInt32_2, value));
+  TEST_ASSERT_EQUAL(200, value);
+  TEST_ASSERT(coalesce_twin.getValue(UInt32s::UInt32_3, value));
+  TEST_ASSERT_EQUAL(300, value);
+  TEST_ASSERT(coalesce_twin.getValue(UInt32s::UInt32_1, value));
+  TEST_ASSERT_EQUAL(20, value);
+
+  NVS::flush();
+  TEST_ASSERT(coalesce_twin.getValue(UInt32s::UInt32_1, value));
+  TEST_ASSERT_EQUAL(100, value);
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+#ifndef ARDUINO
+void test_threadSafe_stress() {
+  TEST_ASSERT(ts_floats.begin());
+  TEST_ASSERT(ts_uint32s.begin());
+  TEST_ASSERT(ts_floats.eraseAll());
+
+  {
+    NVS::Transaction tx(ts_floats);
+    ts_floats.setValue(Floats::Float_1, 0.0f);
+    ts_floats.setValue(Floats::Float_2, 0.0f);
+    ts_floats.setValue(Floats::Float_3, 0.0f);
+    TEST_ASSERT(tx.commit());
+  }
+
+  constexpr int ROUNDS = 2000;
+  std::atomic<bool> done{false};
+  std::atomic<uint32_t> torn{0};
+  std::atomic<uint32_t> reads{0};
+  std::atomic<uint32_t> failed{0};
+
+  // Sets the three floats to the same value, one transaction at a time
+  std::thread writer([&] {
+    for (int i = 1; i <= ROUNDS; i++) {
+      NVS::Transaction tx(ts_floats);
+      float value = static_cast<float>(i);
+      ts_floats.setValue(Floats::Float_1, value);
+      ts_floats.setValue(Floats::Float_2, value);
+      ts_floats.setValue(Floats::Float_3, value);
+      if (!tx.commit()) failed++;
+    }
+    done = true;
+  });
+
+  // Another object in the same namespace, written and read on its own
+  std::thread other([&] {
+    for (uint32_t i = 0; !done; i++) {
+      uint32_t value;
+      if (!ts_uint32s.setValue(UInt32s::UInt32_1, i)) failed++;
+      if (!ts_uint32s.getValue(UInt32s::UInt32_1, value)) failed++;
+      std::array<uint32_t, SETTINGS_COUNT(UINT32S)> values;
+      if (!ts_uint32s.snapshot(values)) failed++;
+    }
+  });
+
+  // Drops the cache now and then, so readers also take the slow path
+  std::thread invalidator([&] {
+    while (!done) {
+      ts_floats.invalidateCache();
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+  });
+
+  // Every set read must come from a single transaction
+  auto reader = [&] {
+    std::array<float, 3> values;
+    while (!done) {
+      ts_floats.getValues({Floats::Float_1, Floats::Float_2, Floats::Float_3}, values);
+      if (values[0] != values[1] || values[1] != values[2]) torn++;
+      reads++;
+    }
+  };
+
+  std::thread reader_1(reader);
+  std::thread reader_2(reader);
+
+  writer.join();
+  other.join();
+  invalidator.join();
+  reader_1.join();
+  reader_2.join();
+
+  TEST_ASSERT_EQUAL(0, torn.load());
+  TEST_ASSERT_EQUAL(0, failed.load());
+  TEST_ASSERT_GREATER_THAN(0, reads.load());
+
+  std::array<float, 3> values;
+  TEST_ASSERT(ts_floats.getValues({Floats::Float_1, Floats::Float_2, Floats::Float_3}, values));
+  TEST_ASSERT_EQUAL_FLOAT(static_cast<float>(ROUNDS), values[0]);
+
+  ts_floats.eraseAll();
+  ts_floats.end();
+  ts_uint32s.end();
+}
+#endif
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_callbacks_sparse() {
+  enum class Flags : uint8_t {};
+  constexpr size_t COUNT = 20;
+  using FlagSettings     = NVS::Settings<bool, Flags, COUNT>;
+
+  static char keys[COUNT][8];
+  std::array<FlagSettings::Struct, COUNT> list;
+  for (size_t i = 0; i < COUNT; i++) {
+    sprintf(keys[i], "f%u", static_cast<unsigned>(i));
+    list[i] = {keys[i], "", false, true};
+  }
+
+  static FlagSettings flags("test_cb_sparse", list);
+  TEST_ASSERT(flags.begin());
+  TEST_ASSERT(flags.eraseAll());
+
+  // A byte per setting: the callbacks themselves only take heap once registered
+  static_assert(SETTINGS_CALLBACK_SLOTS != 0 || FlagSettings::CALLBACK_SLOTS == COUNT, "");
+  static_assert(sizeof(FlagSettings) -
+                    sizeof(NVS::Settings<bool, Flags, COUNT, NVS::Option::NoCallbacks>) <
+                  COUNT + 64,
+                "");
+
+  uint32_t fired = 0;
+  auto on_change = [&fired](const char* key, const Flags setting, const bool value) { fired++; };
+
+  for (size_t i = 0; i < COUNT; i++) {
+    TEST_ASSERT(flags.setOnChangeCallback(static_cast<Flags>(i), on_change, i % 2 == 0));
+  }
+  for (size_t i = 0; i < COUNT; i++) {
+    TEST_ASSERT(flags.setValue(static_cast<Flags>(i), true));
+  }
+  TEST_ASSERT_EQUAL(COUNT, fired);
+
+  fired = 0;
+  flags.clearOnChangeCallback(static_cast<Flags>(1));
+  TEST_ASSERT(flags.setValue(static_cast<Flags>(1), false));
+  TEST_ASSERT_EQUAL(0, fired);
+
+  // callable_on_format is kept per setting
+  TEST_ASSERT(flags.format(static_cast<Flags>(2)));
+  TEST_ASSERT(flags.format(static_cast<Flags>(3)));
+  TEST_ASSERT_EQUAL(1, fired);
+
+  // Removing a callback moves the last pool entry into its place
+  using Cb = NVS::Internal::Delegate<void()>;
+  NVS::Internal::CallbackTable<Cb, COUNT> table;
+
+  static uint32_t calls[COUNT] = {};
+  Cb count_0                   = [] { calls[0]++; };
+  Cb count_5                   = [] { calls[5]++; };
+  Cb count_10                  = [] { calls[10]++; };
+  TEST_ASSERT(table.set(0, count_0, false));
+  TEST_ASSERT(table.set(5, count_5, true));
+  TEST_ASSERT(table.set(10, count_10, false));
+  TEST_ASSERT_EQUAL(3, table.size());
+
+  table.remove(0);
+  TEST_ASSERT_EQUAL(2, table.size());
+  TEST_ASSERT_FALSE(table.get(0, false));
+  TEST_ASSERT(table.get(5, true));
+  TEST_ASSERT_FALSE(table.get(10, true));
+  table.get(5, false)();
+  table.get(10, false)();
+  TEST_ASSERT_EQUAL(0, calls[0]);
+  TEST_ASSERT_EQUAL(1, calls[5]);
+  TEST_ASSERT_EQUAL(1, calls[10]);
+
+  // With a limit (SETTINGS_CALLBACK_SLOTS), replacing takes no new entry and clearing frees one
+  NVS::Internal::CallbackTable<Cb, COUNT, 2> limited;
+  TEST_ASSERT(limited.set(3, count_0, false));
+  TEST_ASSERT(limited.set(4, count_0, false));
+  TEST_ASSERT_FALSE(limited.set(6, count_0, false));
+  TEST_ASSERT(limited.set(3, count_5, false));
+  limited.remove(4);
+  TEST_ASSERT(limited.set(6, count_10, false));
+  TEST_ASSERT_FALSE(limited.get(4, false));
+  limited.get(3, false)();
+  limited.get(6, false)();
+  TEST_ASSERT_EQUAL(2, calls[5]);
+  TEST_ASSERT_EQUAL(2, calls[10]);
+
+  flags.eraseAll();
+  flags.end();
+}
+
+void test_callbacks_disabled() {
+  TEST_ASSERT(nocb_uint32s.begin());
+  TEST_ASSERT_FALSE(nocb_uint32s.setGlobalOnChangeCallback(globalCallback, true));
+
+  uint32_t value;
+  TEST_ASSERT(nocb_uint32s.setValue(UInt32s::UInt32_1, 42));
+  TEST_ASSERT(nocb_uint32s.getValue(UInt32s::UInt32_1, value));
+  TEST_ASSERT_EQUAL(42, value);
+
+  nocb_uint32s.eraseAll();
+  nocb_uint32s.end();
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_defer_poll() {
+  TEST_ASSERT(defer_uint32s.begin());
+  TEST_ASSERT(defer_uint32s.eraseAll());
+
+  defer_uint32s.setOnChangeCallback(
+    UInt32s::UInt32_1,
+    [](const char* key, const UInt32s setting, const uint32_t value) {
+      defer_change_entries++;
+      defer_last_value = value;
+    },
+    false);
+  defer_uint32s.setGlobalOnChangeCallback(
+    [](const char* key, const NVS::Type type, const size_t index, const void* value) {
+      defer_global_entries++;
+    },
+    false);
+
+  // Written at once, reported on poll(): one event per key, with its latest value
+  for (uint32_t i = 1; i <= 5; i++) {
+    TEST_ASSERT(defer_uint32s.setValue(UInt32s::UInt32_1, i));
+  }
+  TEST_ASSERT(defer_uint32s.setValue(UInt32s::UInt32_2, 7));
+
+  uint32_t value;
+  TEST_ASSERT(defer_uint32s.getValue(UInt32s::UInt32_1, value));
+  TEST_ASSERT_EQUAL(5, value);
+  TEST_ASSERT_EQUAL(0, defer_change_entries);
+
+  TEST_ASSERT_EQUAL(2, NVS::poll());
+  TEST_ASSERT_EQUAL(1, defer_change_entries);
+  TEST_ASSERT_EQUAL(5, defer_last_value);
+  TEST_ASSERT_EQUAL(2, defer_global_entries);
+  TEST_ASSERT_EQUAL(0, NVS::poll());
+
+  // callable_on_format still applies to the delivered event
+  TEST_ASSERT(defer_uint32s.format(UInt32s::UInt32_1, true));
+  TEST_ASSERT_EQUAL(1, NVS::poll());
+  TEST_ASSERT_EQUAL(1, defer_change_entries);
+  TEST_ASSERT_EQUAL(2, defer_global_entries);
+
+  defer_uint32s.clearGlobalOnChangeCallback();
+}
+
+void test_defer_writeBack() {
+  // A callback writing into its own object only records another change
+  defer_uint32s.setOnChangeCallback(
+    UInt32s::UInt32_3,
+    [](const char* key, const UInt32s setting, const uint32_t value) {
+      defer_change_entries++;
+      if (value < 3) defer_uint32s.setValue(UInt32s::UInt32_3, value + 1);
+    },
+    false);
+
+  defer_change_entries = 0;
+  TEST_ASSERT(defer_uint32s.setValue(UInt32s::UInt32_3, 1));
+  TEST_ASSERT_EQUAL(1, NVS::poll());
+  TEST_ASSERT_EQUAL(1, NVS::poll());
+  TEST_ASSERT_EQUAL(1, NVS::poll());
+  TEST_ASSERT_EQUAL(0, NVS::poll());
+  TEST_ASSERT_EQUAL(3, defer_change_entries);
+
+  uint32_t value;
+  TEST_ASSERT(defer_uint32s.getValue(UInt32s::UInt32_3, value));
+  TEST_ASSERT_EQUAL(3, value);
+  defer_uint32s.clearOnChangeCallback(UInt32s::UInt32_3);
+}
+
+// Queue filler: a delivery of no event
+size_t deliverNothing(void* target) { return 0; }
+NVS::Internal::NotifyState filler_state;
+
+void test_defer_queueFull() {
+  defer_uint32s.setOnChangeCallback(
+    UInt32s::UInt32_1,
+    [](const char* key, const UInt32s setting, const uint32_t value) {
+      defer_change_entries++;
+      defer_last_value = value;
+    },
+    false);
+
+  // A change that finds the queue full is still delivered by the next poll()
+  for (size_t i = 0; i < SETTINGS_NOTIFY_QUEUE_LENGTH; i++)
+    NVS::Internal::enqueueNotify({nullptr, deliverNothing, &filler_state});
+
+  defer_change_entries = 0;
+  TEST_ASSERT(defer_uint32s.setValue(UInt32s::UInt32_1, 11));
+  TEST_ASSERT_EQUAL(1, NVS::poll());
+  TEST_ASSERT_EQUAL(1, defer_change_entries);
+  TEST_ASSERT_EQUAL(11, defer_last_value);
+  TEST_ASSERT_EQUAL(0, NVS::poll());
+
+  // And by end(), with no further change
+  for (size_t i = 0; i < SETTINGS_NOTIFY_QUEUE_LENGTH; i++)
+    NVS::Internal::enqueueNotify({nullptr, deliverNothing, &filler_state});
+
+  TEST_ASSERT(defer_uint32s.setValue(UInt32s::UInt32_1, 12));
+  defer_uint32s.end();
+  TEST_ASSERT_EQUAL(2, defer_change_entries);
+  TEST_ASSERT_EQUAL(12, defer_last_value);
+  TEST_ASSERT(defer_uint32s.begin());
+}
+
+void test_defer_reentrantEnd() {
+  // A callback closing its own object: end() cannot wait for the delivery running it
+  defer_uint32s.setOnChangeCallback(
+    UInt32s::UInt32_2,
+    [](const char* key, const UInt32s setting, const uint32_t value) {
+      defer_change_entries++;
+      defer_uint32s.end();
+    },
+    false);
+
+  defer_change_entries = 0;
+  TEST_ASSERT(defer_uint32s.setValue(UInt32s::UInt32_2, 7));
+  TEST_ASSERT_EQUAL(1, NVS::poll());
+  TEST_ASSERT_EQUAL(1, defer_change_entries);
+  TEST_ASSERT_FALSE(defer_uint32s.isOpen());
+
+  TEST_ASSERT(defer_uint32s.begin());
+  defer_uint32s.clearOnChangeCallback(UInt32s::UInt32_2);
+}
+
+void test_defer_notifier() {
+  TEST_ASSERT(NVS::startNotifier());
+
+  defer_change_entries = 0;
+  TEST_ASSERT(defer_uint32s.setValue(UInt32s::UInt32_1, 42));
+
+  // end() waits until the notification task has delivered the change
+  defer_uint32s.end();
+  TEST_ASSERT_EQUAL(1, defer_change_entries);
+  TEST_ASSERT_EQUAL(42, defer_last_value);
+
+  TEST_ASSERT(defer_uint32s.begin());
+  defer_uint32s.clearOnChangeCallback(UInt32s::UInt32_1);
+  defer_uint32s.eraseAll();
+  defer_uint32s.end();
+}
+
+#ifndef ARDUINO
+void test_defer_oneTaskAtATime() {
+  // The notification task and another task polling never run the object's callbacks together
+  static std::atomic<uint32_t> inside{0};
+  static std::atomic<bool> overlapped{false};
+  static std::atomic<uint32_t> last{0};
+  static std::atomic<bool> ordered{true};
+
+  TEST_ASSERT(defer_uint32s.begin());
+  defer_uint32s.setOnChangeCallback(
+    UInt32s::UInt32_3,
+    [](const char* key, const UInt32s setting, const uint32_t value) {
+      if (inside.fetch_add(1) != 0) overlapped = true;
+      if (value < last) ordered = false;
+      last = value;
+      std::this_thread::sleep_for(std::chrono::microseconds(50)); // Let the other task poll
+      inside--;
+    },
+    false);
+
+  constexpr uint32_t ROUNDS = 200;
+  std::atomic<bool> done{false};
+  std::thread poller([&done] {
+    while (!done)
+      NVS::poll();
+  });
+
+  for (uint32_t i = 1; i <= ROUNDS; i++) {
+    TEST_ASSERT(defer_uint32s.setValue(UInt32s::UInt32_3, i));
+    std::this_thread::sleep_for(std::chrono::microseconds(20));
+  }
+
+  defer_uint32s.end();
+  done = true;
+  poller.join();
+
+  TEST_ASSERT_FALSE(overlapped);
+  TEST_ASSERT(ordered);
+  TEST_ASSERT_EQUAL(ROUNDS, last.load());
+
+  TEST_ASSERT(defer_uint32s.begin());
+  defer_uint32s.clearOnChangeCallback(UInt32s::UInt32_3);
+  defer_uint32s.eraseAll();
+  defer_uint32s.end();
+}
+#endif
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_metrics_counters() {
+  TEST_ASSERT(metrics_uint32s.begin());
+  TEST_ASSERT(metrics_uint32s.eraseAll());
+  metrics_uint32s.resetMetrics();
+
+  uint32_t value;
+  TEST_ASSERT_FALSE(metrics_uint32s.getValue(UInt32s::UInt32_1, value));
+  TEST_ASSERT(metrics_uint32s.setValue(UInt32s::UInt32_1, 5));
+  TEST_ASSERT(metrics_uint32s.setValue(UInt32s::UInt32_1, 5)); // Unchanged
+  TEST_ASSERT(metrics_uint32s.getValue(UInt32s::UInt32_1, value));
+
+  std::array<uint32_t, 2> values;
+  metrics_uint32s.getValues({UInt32s::UInt32_1, UInt32s::UInt32_2}, values);
+
+  NVS::Metrics metrics;
+  TEST_ASSERT(metrics_uint32s.getMetrics(metrics));
+  TEST_ASSERT_EQUAL(4, metrics.reads);
+  TEST_ASSERT_EQUAL(2, metrics.misses);
+  TEST_ASSERT_EQUAL(2, metrics.writes);
+  TEST_ASSERT_EQUAL(1, metrics.unchanged);
+  TEST_ASSERT_EQUAL(1, metrics.commits);
+  TEST_ASSERT_EQUAL(0, metrics.failures);
+
+  // Histograms time single reads, writes and commits
+  TEST_ASSERT_EQUAL(2, metrics.get.count);
+  TEST_ASSERT_EQUAL(2, metrics.set.count);
+  TEST_ASSERT_EQUAL(1, metrics.commit.count);
+  TEST_ASSERT_LESS_OR_EQUAL(metrics.set.max_us, metrics.commit.max_us);
+
+  NVS::KeyMetrics key;
+  TEST_ASSERT(metrics_uint32s.getKeyMetrics(UInt32s::UInt32_1, key));
+  TEST_ASSERT_EQUAL(3, key.reads);
+  TEST_ASSERT_EQUAL(1, key.misses);
+  TEST_ASSERT_EQUAL(2, key.writes);
+  TEST_ASSERT(metrics_uint32s.getKeyMetrics(UInt32s::UInt32_3, key));
+  TEST_ASSERT_EQUAL(0, key.reads);
+
+  // Failures: the handle is closed
+  metrics_uint32s.end();
+  TEST_ASSERT_FALSE(metrics_uint32s.setValue(UInt32s::UInt32_2, 1));
+  TEST_ASSERT(metrics_uint32s.getMetrics(metrics));
+  TEST_ASSERT_EQUAL(1, metrics.failures);
+
+  TEST_ASSERT_FALSE(uint32s.getMetrics(metrics));
+}
+
+void test_metrics_format() {
+  char buf[256];
+  size_t len = NVS::formatMetrics(metrics_uint32s, buf, sizeof(buf));
+  TEST_ASSERT_EQUAL(strlen(buf), len);
+  TEST_ASSERT_NOT_NULL(strstr(buf, "test_metrics r=4 m=2 w=3 u=1 c=1 f=1\n"));
+  TEST_ASSERT_NOT_NULL(strstr(buf, "\n get n=2 "));
+  TEST_ASSERT_NOT_NULL(strstr(buf, "\n commit n=1 "));
+
+  // Busiest key first, unused keys left out
+  const char* key_1 = strstr(buf, "\n UInt32_1 r=3 m=1 w=2 f=0\n");
+  const char* key_2 = strstr(buf, "\n UInt32_2 r=1 m=1 w=1 f=1\n");
+  TEST_ASSERT_NOT_NULL(key_1);
+  TEST_ASSERT_NOT_NULL(key_2);
+  TEST_ASSERT(key_1 < key_2);
+  TEST_ASSERT_NULL(strstr(buf, "UInt32_3"));
+
+  // Whole lines only
+  TEST_ASSERT_EQUAL(0, NVS::formatMetrics(metrics_uint32s, buf, 16));
+  TEST_ASSERT_EQUAL(0, NVS::formatMetrics(uint32s, buf, sizeof(buf)));
+
+  metrics_uint32s.resetMetrics();
+  NVS::Metrics metrics;
+  TEST_ASSERT(metrics_uint32s.getMetrics(metrics));
+  TEST_ASSERT_EQUAL(0, metrics.reads);
+  TEST_ASSERT_EQUAL(0, metrics.get.count);
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_wear_accounting() {
+  TEST_ASSERT(wear_uint32s.begin());
+  TEST_ASSERT(wear_strings.begin());
+  TEST_ASSERT(wear_bools.begin());
+  NVS::resetWear();
+
+#ifndef ARDUINO
+  uint32_t host_entries = nvs_host_get_counters().entries_written;
+#endif
+
+  TEST_ASSERT(wear_uint32s.setValue(UInt32s::UInt32_1, 1));
+  TEST_ASSERT(wear_uint32s.setValue(UInt32s::UInt32_1, 2));
+  TEST_ASSERT(wear_strings.setValue(Strings::String_1, "short"));         // 6 bytes: 1 + 1
+  TEST_ASSERT(wear_strings.setValue(Strings::String_2, "0123456789abcdef" // 41 bytes: 1 + 2
+                                                       "0123456789abcdef"
+                                                       "01234567"));
+
+  NVS::KeyWear key;
+  wear_uint32s.getKeyWear(UInt32s::UInt32_1, key);
+  TEST_ASSERT_EQUAL(2, key.writes);
+  TEST_ASSERT_EQUAL(2, key.entries);
+  wear_strings.getKeyWear(Strings::String_1, key);
+  TEST_ASSERT_EQUAL(2, key.entries);
+  wear_strings.getKeyWear(Strings::String_2, key);
+  TEST_ASSERT_EQUAL(3, key.entries);
+  wear_strings.getKeyWear(Strings::String_3, key);
+  TEST_ASSERT_EQUAL(0, key.writes);
+
+  // Shared by both objects
+  NVS::NamespaceWear ns;
+  TEST_ASSERT(NVS::getNamespaceWear("test_wear", ns));
+  TEST_ASSERT_EQUAL(4, ns.writes);
+  TEST_ASSERT_EQUAL(7, ns.entries);
+  TEST_ASSERT_FALSE(NVS::getNamespaceWear("test_unknown", ns));
+
+#ifndef ARDUINO
+  // Same count as the flash model of the host NVS
+  TEST_ASSERT_EQUAL(host_entries + 7, nvs_host_get_counters().entries_written);
+#endif
+
+  // Packed: the keys are counted, the entries are those of the single image write
+  TEST_ASSERT(wear_bools.beginTransaction());
+  TEST_ASSERT(wear_bools.setValue(Bools::Bool_1, true));
+  TEST_ASSERT(wear_bools.setValue(Bools::Bool_2, false));
+  TEST_ASSERT(wear_bools.commit());
+
+  TEST_ASSERT(NVS::getNamespaceWear("test_wear_pk", ns));
+  TEST_ASSERT_EQUAL(2, ns.writes);
+  TEST_ASSERT_EQUAL(1, ns.entries);
+  wear_bools.getKeyWear(Bools::Bool_1, key);
+  TEST_ASSERT_EQUAL(1, key.writes);
+  TEST_ASSERT_EQUAL(0, key.entries);
+
+  wear_strings.resetWear();
+  wear_strings.getKeyWear(Strings::String_2, key);
+  TEST_ASSERT_EQUAL(0, key.entries);
+}
+
+void test_wear_budget() {
+  wear_alerts = 0;
+  NVS::setWearAlertCallback(
+    [](const char* ns_name, const char* key, uint32_t budget, uint32_t period_s) {
+      if (strcmp(ns_name, "test_wear") == 0 && strcmp(key, "UInt32_2") == 0 && budget == 2 &&
+          period_s == 60) {
+        wear_alerts++;
+      }
+    });
+
+  wear_uint32s.setWriteBudget(UInt32s::UInt32_2, 2, 60);
+  for (uint32_t i = 0; i < 5; i++)
+    TEST_ASSERT(wear_uint32s.setValue(UInt32s::UInt32_2, i));
+
+  // Once per period, at the first write over the budget
+  TEST_ASSERT_EQUAL(1, wear_alerts);
+
+  NVS::KeyWear key;
+  wear_uint32s.getKeyWear(UInt32s::UInt32_2, key);
+  TEST_ASSERT_EQUAL(2, key.budget);
+  TEST_ASSERT_EQUAL(60, key.period_s);
+  TEST_ASSERT_EQUAL(5, key.period_writes);
+  TEST_ASSERT_EQUAL(1, key.alerts);
+
+  // Setting a budget restarts its period
+  wear_uint32s.setWriteBudget(UInt32s::UInt32_2, 2, 60);
+  TEST_ASSERT(wear_uint32s.setValue(UInt32s::UInt32_2, 10));
+  TEST_ASSERT_EQUAL(1, wear_alerts);
+
+  wear_uint32s.setWriteBudget(UInt32s::UInt32_2, 0);
+  NVS::setWearAlertCallback(nullptr);
+}
+
+void test_wear_estimate() {
+  NVS::resetWear();
+
+  NVS::WearEstimate estimate;
+  TEST_ASSERT(NVS::estimateWear(estimate));
+  TEST_ASSERT_EQUAL(0, estimate.entries_written);
+  TEST_ASSERT(isinf(estimate.lifetime_years));
+
+  TEST_ASSERT(NVS::sampleWear());
+  for (uint32_t i = 0; i < 10; i++)
+    TEST_ASSERT(wear_uint32s.setValue(UInt32s::UInt32_3, i));
+
+  TEST_ASSERT(NVS::estimateWear(estimate, 100000));
+  TEST_ASSERT_EQUAL(10, estimate.entries_written);
+  TEST_ASSERT_GREATER_THAN(0, estimate.stats.available_entries);
+  TEST_ASSERT(estimate.entries_per_hour > 0);
+
+  // Every page is erased once per available_entries entries written
+  float cycles = 10.0f / static_cast<float>(estimate.stats.available_entries);
+  TEST_ASSERT(fabsf(estimate.erase_cycles - cycles) < 1e-6f);
+  TEST_ASSERT(fabsf(estimate.lifetime_years * estimate.cycles_per_year - 100000.0f) < 1.0f);
+
+  wear_uint32s.eraseAll();
+  wear_uint32s.end();
+  wear_strings.end();
+  wear_bools.eraseAll();
+  wear_bools.end();
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_hex_roundtrip() {
+  // Every byte value, and lengths around the 16-byte and 4-byte steps
+  uint8_t bytes[80];
+  for (size_t i = 0; i < sizeof(bytes); i++)
+    bytes[i] = static_cast<uint8_t>(i * 37 + 11);
+
+  uint8_t all[256];
+  for (size_t i = 0; i < sizeof(all); i++)
+    all[i] = static_cast<uint8_t>(i);
+
+  char hex[NVS::hexStrSize(256, true)];
+  char expected[NVS::hexStrSize(256, true)];
+  uint8_t decoded[256];
+
+  for (size_t size = 0; size <= sizeof(bytes) + 1; size++) {
+    if (size > sizeof(bytes)) size = sizeof(all);
+    const uint8_t* data = (size == sizeof(all)) ? all : bytes;
+
+    for (bool spaced : {false, true}) {
+      char* pos = expected;
+      for (size_t i = 0; i < size; i++)
+        pos += snprintf(pos, 4, (spaced && i + 1 < size) ? "%02X " : "%02X", data[i]);
+      *pos = '\0';
+
+      NVS::ByteStreamView view{data, size};
+      TEST_ASSERT(NVS::fromHexToStr(view, hex, NVS::hexStrSize(size, spaced), spaced));
+      TEST_ASSERT_EQUAL_STRING(expected, hex);
+
+      NVS::ByteStream out{decoded, sizeof(decoded)};
+      TEST_ASSERT(NVS::fromStrToHex(hex, out, spaced));
+      TEST_ASSERT_EQUAL(size, out.size);
+      if (size > 0) TEST_ASSERT_EQUAL_MEMORY(data, decoded, size);
+    }
+  }
+
+  // Lowercase digits are accepted
+  NVS::ByteStream out{decoded, sizeof(decoded)};
+  TEST_ASSERT(NVS::fromStrToHex("deadbeef0123456789abcdefABCDEF0011223344", out));
+  TEST_ASSERT_EQUAL(20, out.size);
+  TEST_ASSERT_EQUAL(0xDE, decoded[0]);
+  TEST_ASSERT_EQUAL(0xEF, decoded[11]);
+  TEST_ASSERT_EQUAL(0xAB, decoded[12]);
+}
+
+void test_hex_invalid() {
+  uint8_t decoded[64];
+  NVS::ByteStream out{decoded, sizeof(decoded)};
+
+  // A bad character anywhere: in a 16-byte block, in a 4-byte step or in the tail
+  char hex[] = "00112233445566778899AABBCCDDEEFF00112233445566778899AABBCCDDEEFF0011223344";
+  for (size_t pos = 0; pos < strlen(hex); pos++) {
+    for (char bad : {'G', 'g', ' ', '/', ':', '@', '`', '\x80', '\xFF'}) {
+      char saved = hex[pos];
+      hex[pos]   = bad;
+      out.size   = 0;
+      TEST_ASSERT_FALSE(NVS::fromStrToHex(hex, out));
+      TEST_ASSERT_EQUAL(0, out.size);
+      hex[pos] = saved;
+    }
+  }
+  TEST_ASSERT(NVS::fromStrToHex(hex, out));
+
+  // Odd length, missing or wrong separators, too small buffers
+  TEST_ASSERT_FALSE(NVS::fromStrToHex("ABC", out));
+  TEST_ASSERT_FALSE(NVS::fromStrToHex("AB CD", out));
+  TEST_ASSERT_FALSE(NVS::fromStrToHex("ABCD EF", out, true));
+  TEST_ASSERT_FALSE(NVS::fromStrToHex("AB-CD EF", out, true));
+  TEST_ASSERT_FALSE(NVS::fromStrToHex("AB CG", out, true));
+
+  NVS::ByteStream small{decoded, 2};
+  TEST_ASSERT_FALSE(NVS::fromStrToHex("AABBCC", small));
+
+  char buf[8];
+  NVS::ByteStreamView view{decoded, 4};
+  TEST_ASSERT_FALSE(NVS::fromHexToStr(view, buf, sizeof(buf)));
+  TEST_ASSERT_FALSE(NVS::fromHexToStr(view, buf, sizeof(buf), true));
+  TEST_ASSERT(NVS::fromHexToStr(NVS::ByteStreamView{decoded, 0}, buf, 1, true));
+  TEST_ASSERT_EQUAL_STRING("", buf);
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_base64_vectors() {
+  // RFC 4648, section 10
+  const char* vectors[][2] = {{"", ""},
+                              {"f", "Zg=="},
+                              {"fo", "Zm8="},
+                              {"foo", "Zm9v"},
+                              {"foob", "Zm9vYg=="},
+                              {"fooba", "Zm9vYmE="},
+                              {"foobar", "Zm9vYmFy"}};
+
+  char b64[16];
+  uint8_t decoded[16];
+
+  for (const auto& v : vectors) {
+    NVS::ByteStreamView view{reinterpret_cast<const uint8_t*>(v[0]), strlen(v[0])};
+    TEST_ASSERT_EQUAL(strlen(v[1]) + 1, NVS::base64StrSize(view.size));
+    TEST_ASSERT(NVS::fromBase64ToStr(view, b64, NVS::base64StrSize(view.size)));
+    TEST_ASSERT_EQUAL_STRING(v[1], b64);
+
+    NVS::ByteStream out{decoded, sizeof(decoded)};
+    TEST_ASSERT(NVS::fromStrToBase64(v[1], out));
+    TEST_ASSERT_EQUAL(view.size, out.size);
+    if (out.size > 0) TEST_ASSERT_EQUAL_MEMORY(v[0], decoded, out.size);
+  }
+
+  // Every byte value, both alphabet ends
+  uint8_t all[256];
+  for (size_t i = 0; i < sizeof(all); i++)
+    all[i] = static_cast<uint8_t>(255 - i);
+
+  char all_b64[NVS::base64StrSize(256)];
+  uint8_t all_decoded[256];
+  TEST_ASSERT(NVS::fromBase64ToStr(NVS::ByteStreamView{all, sizeof(all)}, all_b64,
+                                   sizeof(all_b64)));
+  TEST_ASSERT_EQUAL(sizeof(all_b64) - 1, strlen(all_b64));
+  TEST_ASSERT_EQUAL('/', all_b64[0]);
+
+  NVS::ByteStream out{all_decoded, sizeof(all_decoded)};
+  TEST_ASSERT(NVS::fromStrToBase64(all_b64, out));
+  TEST_ASSERT_EQUAL(sizeof(all), out.size);
+  TEST_ASSERT_EQUAL_MEMORY(all, all_decoded, sizeof(all));
+
+  // Padding is optional
+  TEST_ASSERT(NVS::fromStrToBase64("Zm9vYg", out));
+  TEST_ASSERT_EQUAL(4, out.size);
+  TEST_ASSERT_EQUAL_MEMORY("foob", all_decoded, 4);
+}
+
+void test_base64_invalid() {
+  uint8_t decoded[16];
+  NVS::ByteStream out{decoded, sizeof(decoded)};
+
+  // Characters outside the alphabet, wherever they are
+  char b64[] = "Zm9vYmFyZm9vYg==";
+  for (size_t pos = 0; pos < 14; pos++) {
+    for (char bad : {'=', '-', '_', ' ', '\n', '.', '\x80'}) {
+      char saved = b64[pos];
+      b64[pos]   = bad;
+      out.size   = 0;
+      TEST_ASSERT_FALSE(NVS::fromStrToBase64(b64, out));
+      TEST_ASSERT_EQUAL(0, out.size);
+      b64[pos] = saved;
+    }
+  }
+  TEST_ASSERT(NVS::fromStrToBase64(b64, out));
+
+  TEST_ASSERT_FALSE(NVS::fromStrToBase64("Zm9vY", out));   // One character left over
+  TEST_ASSERT_FALSE(NVS::fromStrToBase64("Z===", out));    // Padding of three characters
+  TEST_ASSERT_FALSE(NVS::fromStrToBase64("Zg===", out));   // Padding past the block
+  TEST_ASSERT_FALSE(NVS::fromStrToBase64("Zm9vYg=", out)); // Padding of the wrong length
+  TEST_ASSERT_FALSE(NVS::fromStrToBase64(nullptr, out));
+
+  NVS::ByteStream small{decoded, 5};
+  TEST_ASSERT_FALSE(NVS::fromStrToBase64("Zm9vYmFy", small));
+
+  char buf[8];
+  TEST_ASSERT_FALSE(NVS::fromBase64ToStr(NVS::ByteStreamView{decoded, 5}, buf, sizeof(buf)));
+  TEST_ASSERT(NVS::fromBase64ToStr(NVS::ByteStreamView{decoded, 3}, buf, sizeof(buf)));
+}
+
+void test_base64_encoder() {
+  uint8_t data[100];
+  for (size_t i = 0; i < sizeof(data); i++)
+    data[i] = static_cast<uint8_t>(i * 7 + 3);
+
+  char expected[NVS::base64StrSize(sizeof(data))];
+  TEST_ASSERT(NVS::fromBase64ToStr(NVS::ByteStreamView{data, sizeof(data)}, expected,
+                                   sizeof(expected)));
+
+  // Any chunking gives the one-shot result
+  NVS::Base64Encoder encoder;
+  for (size_t chunk = 1; chunk <= 8; chunk++) {
+    char b64[sizeof(expected)];
+    size_t len = 0;
+
+    for (size_t i = 0; i < sizeof(data); i += chunk) {
+      size_t size = std::min(chunk, sizeof(data) - i);
+      size_t written;
+      TEST_ASSERT(encoder.update(NVS::ByteStreamView{data + i, size}, b64 + len,
+                                 NVS::Base64Encoder::maxOutput(size), written));
+      len += written;
+    }
+
+    size_t written;
+    TEST_ASSERT(encoder.finish(b64 + len, 5, written));
+    TEST_ASSERT_EQUAL(strlen(expected), len + written);
+    TEST_ASSERT_EQUAL_STRING(expected, b64);
+  }
+
+  // A too small buffer consumes nothing
+  char out[8];
+  size_t written;
+  TEST_ASSERT(encoder.update(NVS::ByteStreamView{data, 2}, out, sizeof(out), written));
+  TEST_ASSERT_EQUAL(0, written);
+  TEST_ASSERT_FALSE(encoder.update(NVS::ByteStreamView{data + 2, 4}, out, 4, written));
+  TEST_ASSERT(encoder.update(NVS::ByteStreamView{data + 2, 4}, out, sizeof(out), written));
+  TEST_ASSERT_EQUAL(8, written);
+  TEST_ASSERT_EQUAL_MEMORY(expected, out, 8);
+  TEST_ASSERT(encoder.finish(out, sizeof(out), written));
+  TEST_ASSERT_EQUAL(0, written);
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+// Sink collecting the output in memory, recording the largest write
+class BufferSink : public NVS::Sink {
+  public:
+  char text[1024]  = {};
+  size_t length    = 0;
+  size_t max_write = 0;
+  bool fail        = false;
+
+  bool write(const char* data, size_t size) override {
+    if (fail || length + size >= sizeof(text)) return false;
+    memcpy(text + length, data, size);
+    length          += size;
+    text[length]     = '\0';
+    max_write        = std::max(max_write, size);
+    return true;
+  }
+};
+
+// Source handing out a string a few characters at a time
+class PieceSource : public NVS::Source {
+  public:
+  PieceSource(const char* text, size_t piece)
+      : _text(text)
+      , _piece(piece) {}
+
+  size_t read(char* buf, size_t size) override {
+    size_t n = std::min({size, _piece, strlen(_text)});
+    memcpy(buf, _text, n);
+    _text += n;
+    return n;
+  }
+
+  private:
+  const char* _text;
+  size_t _piece;
+};
+
+void test_stream_hex() {
+  uint8_t data[250];
+  for (size_t i = 0; i < sizeof(data); i++)
+    data[i] = static_cast<uint8_t>(i * 13 + 5);
+
+  for (bool spaced : {false, true}) {
+    char expected[NVS::hexStrSize(sizeof(data), true)];
+    TEST_ASSERT(NVS::fromHexToStr(NVS::ByteStreamView{data, sizeof(data)}, expected,
+                                  sizeof(expected), spaced));
+
+    // Same text as the one-shot encoder, written a chunk at a time
+    BufferSink sink;
+    TEST_ASSERT(NVS::writeHex(sink, NVS::ByteStreamView{data, sizeof(data)}, spaced));
+    TEST_ASSERT_EQUAL_STRING(expected, sink.text);
+    TEST_ASSERT_LESS_OR_EQUAL(SETTINGS_CODEC_CHUNK_SIZE, sink.max_write);
+
+    // Decoded back whatever the read sizes
+    for (size_t piece : {1, 2, 5, 7, 96, 1000}) {
+      uint8_t decoded[sizeof(data)] = {};
+      NVS::ByteStream out(decoded, sizeof(decoded));
+      PieceSource source(expected, piece);
+      TEST_ASSERT(NVS::readHex(source, out, spaced));
+      TEST_ASSERT_EQUAL(sizeof(data), out.size);
+      TEST_ASSERT_EQUAL_MEMORY(data, decoded, sizeof(data));
+    }
+  }
+
+  // Empty blob, and wrapped input: a line break stands for the separator of spaced hex
+  BufferSink sink;
+  TEST_ASSERT(NVS::writeHex(sink, NVS::ByteStreamView{data, 0}));
+  TEST_ASSERT_EQUAL(0, sink.length);
+
+  for (size_t piece : {1, 3, 1000}) {
+    uint8_t decoded[4] = {};
+    NVS::ByteStream out(decoded, sizeof(decoded));
+    PieceSource spaced("0A 1B\r\n2C \nFF\n", piece);
+    TEST_ASSERT(NVS::readHex(spaced, out, true));
+    TEST_ASSERT_EQUAL(4, out.size);
+    TEST_ASSERT_EQUAL(0x2C, decoded[2]);
+    TEST_ASSERT_EQUAL(0xFF, decoded[3]);
+
+    PieceSource plain("0A1B\n2C FF\r\n", piece);
+    TEST_ASSERT(NVS::readHex(plain, out));
+    TEST_ASSERT_EQUAL(4, out.size);
+    TEST_ASSERT_EQUAL(0xFF, decoded[3]);
+  }
+}
+
+void test_stream_base64() {
+  uint8_t data[250];
+  for (size_t i = 0; i < sizeof(data); i++)
+    data[i] = static_cast<uint8_t>(i * 29 + 1);
+
+  for (size_t size : {0, 1, 2, 3, 71, 72, 73, 250}) {
+    char expected[NVS::base64StrSize(sizeof(data))];
+    TEST_ASSERT(
+        NVS::fromBase64ToStr(NVS::ByteStreamView{data, size}, expected, sizeof(expected)));
+
+    BufferSink sink;
+    TEST_ASSERT(NVS::writeBase64(sink, NVS::ByteStreamView{data, size}));
+    TEST_ASSERT_EQUAL_STRING(expected, sink.text);
+    TEST_ASSERT_LESS_OR_EQUAL(SETTINGS_CODEC_CHUNK_SIZE, sink.max_write);
+
+    for (size_t piece : {1, 3, 4, 9, 1000}) {
+      uint8_t decoded[sizeof(data)] = {};
+      NVS::ByteStream out(decoded, sizeof(decoded));
+      PieceSource source(expected, piece);
+      TEST_ASSERT(NVS::readBase64(source, out));
+      TEST_ASSERT_EQUAL(size, out.size);
+      TEST_ASSERT_EQUAL_MEMORY(data, decoded, size);
+    }
+  }
+
+  // Padding is optional
+  uint8_t decoded[8] = {};
+  NVS::ByteStream out(decoded, sizeof(decoded));
+  PieceSource source("Zm9vYg\n", 2);
+  TEST_ASSERT(NVS::readBase64(source, out));
+  TEST_ASSERT_EQUAL(4, out.size);
+  TEST_ASSERT_EQUAL_MEMORY("foob", decoded, 4);
+
+  // Wrapped at 64 columns (PEM-style): every line is decoded, not just the first one
+  char wrapped[NVS::base64StrSize(sizeof(data)) + 8] = {};
+  char whole[NVS::base64StrSize(sizeof(data))];
+  TEST_ASSERT(NVS::fromBase64ToStr(NVS::ByteStreamView{data, sizeof(data)}, whole, sizeof(whole)));
+  for (size_t i = 0, length = 0; whole[i]; i++) {
+    wrapped[length++] = whole[i];
+    if (i % 64 == 63 || !whole[i + 1]) {
+      wrapped[length++] = '\r';
+      wrapped[length++] = '\n';
+    }
+  }
+
+  for (size_t piece : {1, 5, 65, 1000}) {
+    uint8_t wrapped_out[sizeof(data)] = {};
+    NVS::ByteStream bs(wrapped_out, sizeof(wrapped_out));
+    PieceSource wrapped_source(wrapped, piece);
+    TEST_ASSERT(NVS::readBase64(wrapped_source, bs));
+    TEST_ASSERT_EQUAL(sizeof(data), bs.size);
+    TEST_ASSERT_EQUAL_MEMORY(data, wrapped_out, sizeof(data));
+  }
+
+#ifndef ARDUINO
+  // Standard streams on the host
+  std::ostringstream os;
+  NVS::OStreamSink os_sink(os);
+  const uint8_t foobar[] = {'f', 'o', 'o', 'b', 'a', 'r'};
+  TEST_ASSERT(NVS::writeBase64(os_sink, NVS::ByteStreamView{foobar, sizeof(foobar)}));
+  TEST_ASSERT_EQUAL_STRING("Zm9vYmFy", os.str().c_str());
+
+  std::istringstream is("Zm9vYmFy");
+  NVS::IStreamSource is_source(is);
+  TEST_ASSERT(NVS::readBase64(is_source, out));
+  TEST_ASSERT_EQUAL(6, out.size);
+  TEST_ASSERT_EQUAL_MEMORY("foobar", decoded, 6);
+#endif
+}
+
+void test_stream_invalid() {
+  uint8_t decoded[4] = {};
+  NVS::ByteStream out(decoded, sizeof(decoded));
+
+  const char* hex_cases[]    = {"0A1", "0A1G", "0A1B2C3D4E"};
+  const char* spaced_cases[] = {"0A 1B ", "0A-1B", "0A 1B 2C 3D 4E", "0A 1B \n"};
+  const char* b64_cases[]    = {"Zm9vY", "Zg==Zg==", "Zm9v!mFy", "Zm9vYmFyYmF6", "Zg==\nZg=="};
+
+  for (size_t piece : {1, 4, 1000}) {
+    for (const char* text : hex_cases) {
+      PieceSource source(text, piece);
+      TEST_ASSERT_FALSE(NVS::readHex(source, out));
+    }
+    for (const char* text : spaced_cases) {
+      PieceSource source(text, piece);
+      TEST_ASSERT_FALSE(NVS::readHex(source, out, true));
+    }
+    for (const char* text : b64_cases) {
+      PieceSource source(text, piece);
+      TEST_ASSERT_FALSE(NVS::readBase64(source, out));
+    }
+  }
+
+  // A failing sink stops the encoder
+  BufferSink sink;
+  sink.fail = true;
+  TEST_ASSERT_FALSE(NVS::writeHex(sink, NVS::ByteStreamView{decoded, sizeof(decoded)}));
+  TEST_ASSERT_FALSE(NVS::writeBase64(sink, NVS::ByteStreamView{nullptr, 4}));
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_chunked_roundtrip() {
+  TEST_ASSERT(chunked_bytestreams.begin());
+  TEST_ASSERT(chunked_bytestreams.eraseAll());
+
+  for (size_t i = 0; i < sizeof(chunked_blob); i++)
+    chunked_blob[i] = static_cast<uint8_t>(i * 31 + 7);
+
+  NVS::ByteStreamView view{chunked_blob, sizeof(chunked_blob)};
+  TEST_ASSERT(chunked_bytestreams.setValue(ByteStreams::Stream_1, view));
+
+  size_t size = 0;
+  TEST_ASSERT(chunked_bytestreams.getValueSize(ByteStreams::Stream_1, size));
+  TEST_ASSERT_EQUAL(sizeof(chunked_blob), size);
+
+  static uint8_t whole[sizeof(chunked_blob)];
+  NVS::ByteStream out(whole, sizeof(whole));
+  TEST_ASSERT(chunked_bytestreams.getValue(ByteStreams::Stream_1, out));
+  TEST_ASSERT_EQUAL(sizeof(chunked_blob), out.size);
+  TEST_ASSERT_EQUAL_MEMORY(chunked_blob, whole, sizeof(whole));
+
+  // Too small a buffer reads nothing
+  NVS::ByteStream small(whole, sizeof(whole) - 1);
+  TEST_ASSERT_FALSE(chunked_bytestreams.getValue(ByteStreams::Stream_1, small));
+
+  // Slices inside a chunk, across chunks, a whole chunk, the tail
+  const size_t chunk = NVS::Internal::ChunkedBlobPolicy::CHUNK_SIZE;
+  const size_t ranges[][2] = {
+    {0, 64}, {chunk - 10, 20}, {chunk, chunk}, {100, 2 * chunk}, {2990, 10}, {0, 3000}};
+
+  for (const auto& range : ranges) {
+    uint8_t slice[3000] = {};
+    TEST_ASSERT(chunked_bytestreams.readRange(ByteStreams::Stream_1, range[0], slice, range[1]));
+    TEST_ASSERT_EQUAL_MEMORY(chunked_blob + range[0], slice, range[1]);
+  }
+
+  uint8_t slice[16];
+  TEST_ASSERT(chunked_bytestreams.readRange(ByteStreams::Stream_1, 3000, slice, 0));
+  TEST_ASSERT_FALSE(chunked_bytestreams.readRange(ByteStreams::Stream_1, 2990, slice, 11));
+  TEST_ASSERT_FALSE(chunked_bytestreams.readRange(ByteStreams::Stream_2, 0, slice, 1));
+
+  // Empty values are stored too
+  TEST_ASSERT(chunked_bytestreams.setValue(ByteStreams::Stream_2, NVS::ByteStreamView{whole, 0}));
+  TEST_ASSERT(chunked_bytestreams.getValueSize(ByteStreams::Stream_2, size));
+  TEST_ASSERT_EQUAL(0, size);
+}
+
+void test_chunked_dirty_chunks() {
+  TEST_ASSERT(chunked_bytestreams.begin());
+  NVS::ByteStreamView view{chunked_blob, sizeof(chunked_blob)};
+  TEST_ASSERT(chunked_bytestreams.setValue(ByteStreams::Stream_1, view));
+  chunked_bytestreams.resetWear();
+
+  NVS::KeyWear wear;
+  const size_t chunk_size       = NVS::Internal::ChunkedBlobPolicy::CHUNK_SIZE;
+  const size_t chunks           = (sizeof(chunked_blob) + chunk_size - 1) / chunk_size;
+  const uint32_t chunk_entries = NVS::Internal::blobEntries(chunk_size);
+  const uint32_t index_entries = NVS::Internal::blobEntries(12 + 4 * chunks);
+
+#ifndef ARDUINO
+  uint32_t sets   = nvs_host_get_counters().sets;
+  uint32_t erases = nvs_host_get_counters().erases;
+#endif
+
+  // The same value rewrites nothing
+  TEST_ASSERT(chunked_bytestreams.setValue(ByteStreams::Stream_1, view));
+#ifndef ARDUINO
+  TEST_ASSERT_EQUAL(sets, nvs_host_get_counters().sets);
+#endif
+
+  // One byte changed: its chunk, and the index marked pending then complete
+  chunked_blob[1000]++;
+  TEST_ASSERT(chunked_bytestreams.setValue(ByteStreams::Stream_1, view));
+#ifndef ARDUINO
+  TEST_ASSERT_EQUAL(sets + 3, nvs_host_get_counters().sets);
+  sets = nvs_host_get_counters().sets;
+#endif
+  chunked_bytestreams.getKeyWear(ByteStreams::Stream_1, wear);
+  TEST_ASSERT_EQUAL(1, wear.writes);
+  TEST_ASSERT_EQUAL(chunk_entries + 2 * index_entries, wear.entries);
+
+  // A slice straddling two chunks: both, and the index twice
+  uint8_t patch[20];
+  for (size_t i = 0; i < sizeof(patch); i++)
+    patch[i] = static_cast<uint8_t>(0xA0 + i);
+  const size_t offset = chunk_size - 10;
+
+  NVS::WriteResult result =
+    chunked_bytestreams.writeRange(ByteStreams::Stream_1, offset, {patch, sizeof(patch)});
+  TEST_ASSERT_EQUAL(NVS::WriteStatus::Written, result.status());
+  memcpy(chunked_blob + offset, patch, sizeof(patch));
+#ifndef ARDUINO
+  TEST_ASSERT_EQUAL(sets + 4, nvs_host_get_counters().sets);
+  sets = nvs_host_get_counters().sets;
+#endif
+
+  result = chunked_bytestreams.writeRange(ByteStreams::Stream_1, offset, {patch, sizeof(patch)});
+  TEST_ASSERT_EQUAL(NVS::WriteStatus::Unchanged, result.status());
+  TEST_ASSERT_FALSE(
+    chunked_bytestreams.writeRange(ByteStreams::Stream_1, 2990, {patch, sizeof(patch)}));
+
+  static uint8_t whole[sizeof(chunked_blob)];
+  NVS::ByteStream out(whole, sizeof(whole));
+  TEST_ASSERT(chunked_bytestreams.getValue(ByteStreams::Stream_1, out));
+  TEST_ASSERT_EQUAL_MEMORY(chunked_blob, whole, sizeof(whole));
+
+  // Shrinking erases the chunks past the new end
+  TEST_ASSERT(chunked_bytestreams.setValue(ByteStreams::Stream_1, {chunked_blob, 100}));
+  TEST_ASSERT(chunked_bytestreams.getValue(ByteStreams::Stream_1, out));
+  TEST_ASSERT_EQUAL(100, out.size);
+  TEST_ASSERT_EQUAL_MEMORY(chunked_blob, whole, 100);
+#ifndef ARDUINO
+  TEST_ASSERT_EQUAL(erases + chunks - 1, nvs_host_get_counters().erases);
+#endif
+}
+
+void test_chunked_integrity() {
+  TEST_ASSERT(chunked_bytestreams.begin());
+  TEST_ASSERT(unchunked_bytestreams.begin());
+
+  // A value stored whole before the option was enabled is still read, and converted on write
+  NVS::ByteStreamView view{chunked_blob, 700};
+  TEST_ASSERT(unchunked_bytestreams.setValue(ByteStreams::Stream_3, view));
+
+  static uint8_t whole[sizeof(chunked_blob)];
+  NVS::ByteStream out(whole, sizeof(whole));
+  TEST_ASSERT(chunked_bytestreams.getValue(ByteStreams::Stream_3, out));
+  TEST_ASSERT_EQUAL(700, out.size);
+  TEST_ASSERT_EQUAL_MEMORY(chunked_blob, whole, 700);
+
+  uint8_t slice[8];
+  TEST_ASSERT_FALSE(chunked_bytestreams.readRange(ByteStreams::Stream_3, 0, slice, sizeof(slice)));
+  TEST_ASSERT(chunked_bytestreams.setValue(ByteStreams::Stream_3, view));
+  TEST_ASSERT(chunked_bytestreams.readRange(ByteStreams::Stream_3, 600, slice, sizeof(slice)));
+  TEST_ASSERT_EQUAL_MEMORY(chunked_blob + 600, slice, sizeof(slice));
+
+  // A chunk that does not match its CRC (e.g. a write cut short) fails the reads that need it
+  char name[NVS_KEY_NAME_MAX_SIZE];
+  const char* key = chunked_bytestreams.getKey(ByteStreams::Stream_3);
+  snprintf(name, sizeof(name), "~%08" PRIx32 "%03x", NVS::Internal::crc32(key, strlen(key)), 1);
+
+  nvs_handle_t handle;
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_open("test_chunked", NVS_READWRITE, &handle));
+  uint8_t garbage[700 - NVS::Internal::ChunkedBlobPolicy::CHUNK_SIZE] = {};
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_set_blob(handle, name, garbage, sizeof(garbage)));
+  nvs_close(handle);
+
+  TEST_ASSERT_FALSE(chunked_bytestreams.getValue(ByteStreams::Stream_3, out));
+  TEST_ASSERT_FALSE(chunked_bytestreams.readRange(ByteStreams::Stream_3, 600, slice, 8));
+  TEST_ASSERT(chunked_bytestreams.readRange(ByteStreams::Stream_3, 0, slice, sizeof(slice)));
+
+  // A write cut short leaves the index pending: the value reads as absent, and the next write
+  // rewrites every chunk, the damaged one included
+  uint8_t index[64];
+  size_t length = sizeof(index);
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_open("test_chunked", NVS_READWRITE, &handle));
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_get_blob(handle, key, index, &length));
+  index[3] = '0';
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_set_blob(handle, key, index, length));
+  nvs_close(handle);
+
+  size_t size;
+  TEST_ASSERT_FALSE(chunked_bytestreams.getValueSize(ByteStreams::Stream_3, size));
+  TEST_ASSERT(chunked_bytestreams.setValue(ByteStreams::Stream_3, view));
+  TEST_ASSERT(chunked_bytestreams.getValue(ByteStreams::Stream_3, out));
+  TEST_ASSERT_EQUAL_MEMORY(chunked_blob, whole, 700);
+
+  TEST_ASSERT(chunked_bytestreams.eraseAll());
+  chunked_bytestreams.end();
+  unchunked_bytestreams.end();
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_compressed_codec() {
+  static char json[2048];
+  static uint8_t packed[2048];
+  static uint8_t unpacked[2048];
+  size_t size = makeJson(json, sizeof(json), 24);
+  auto* src   = reinterpret_cast<const uint8_t*>(json);
+
+  size_t packed_size = NVS::Internal::lzCompress(src, size, packed, sizeof(packed));
+  TEST_ASSERT_GREATER_THAN(0, packed_size);
+  TEST_ASSERT_LESS_OR_EQUAL(size / 3, packed_size);
+  TEST_ASSERT(NVS::Internal::lzDecompress(packed, packed_size, unpacked, size));
+  TEST_ASSERT_EQUAL_MEMORY(json, unpacked, size);
+
+  // Runs overlap the bytes they copy; long literals and matches take extension bytes
+  uint8_t mixed[700];
+  for (size_t i = 0; i < sizeof(mixed); i++)
+    mixed[i] = i < 300 ? static_cast<uint8_t>(i * 167 + (i >> 3)) : 0x55;
+  packed_size = NVS::Internal::lzCompress(mixed, sizeof(mixed), packed, sizeof(packed));
+  TEST_ASSERT_GREATER_THAN(0, packed_size);
+  TEST_ASSERT(NVS::Internal::lzDecompress(packed, packed_size, unpacked, sizeof(mixed)));
+  TEST_ASSERT_EQUAL_MEMORY(mixed, unpacked, sizeof(mixed));
+
+  // Tiny and empty inputs are literals only
+  TEST_ASSERT_EQUAL(4, NVS::Internal::lzCompress(src, 3, packed, sizeof(packed)));
+  TEST_ASSERT(NVS::Internal::lzDecompress(packed, 4, unpacked, 3));
+  TEST_ASSERT_EQUAL_MEMORY(json, unpacked, 3);
+  TEST_ASSERT_EQUAL(1, NVS::Internal::lzCompress(src, 0, packed, sizeof(packed)));
+  TEST_ASSERT(NVS::Internal::lzDecompress(packed, 1, unpacked, 0));
+
+  // Output that does not fit the capacity gives up
+  TEST_ASSERT_EQUAL(0, NVS::Internal::lzCompress(mixed, sizeof(mixed), packed, 200));
+
+  // Corrupted input fails instead of overrunning either buffer
+  packed_size = NVS::Internal::lzCompress(src, size, packed, sizeof(packed));
+  TEST_ASSERT_FALSE(NVS::Internal::lzDecompress(packed, packed_size - 1, unpacked, size));
+  TEST_ASSERT_FALSE(NVS::Internal::lzDecompress(packed, packed_size, unpacked, size - 1));
+
+  uint8_t bad_offset[] = {0x10, 'a', 0xFF, 0x00};
+  TEST_ASSERT_FALSE(NVS::Internal::lzDecompress(bad_offset, sizeof(bad_offset), unpacked, 5));
+  uint8_t bad_length[] = {0xF0, 0xFF, 0xFF};
+  TEST_ASSERT_FALSE(NVS::Internal::lzDecompress(bad_length, sizeof(bad_length), unpacked, 100));
+}
+
+void test_compressed_strings() {
+  TEST_ASSERT(compressed_strings.begin());
+  TEST_ASSERT(uncompressed_strings.begin());
+  TEST_ASSERT(compressed_strings.eraseAll());
+  compressed_strings.resetWear();
+
+  static char json[1600];
+  static char buf[1600];
+  size_t length = makeJson(json, sizeof(json), 20);
+  NVS::Str out{buf, sizeof(buf)};
+
+#ifndef ARDUINO
+  uint32_t entries = nvs_host_get_counters().entries_written;
+#endif
+
+  // A large document takes a fraction of the entries it would raw
+  TEST_ASSERT(compressed_strings.setValue(Strings::String_1, json));
+  TEST_ASSERT(compressed_strings.getValue(Strings::String_1, out));
+  TEST_ASSERT_EQUAL_STRING(json, buf);
+
+  size_t size = 0;
+  TEST_ASSERT(compressed_strings.getValueSize(Strings::String_1, size));
+  TEST_ASSERT_EQUAL(length + 1, size);
+
+  NVS::KeyWear wear;
+  compressed_strings.getKeyWear(Strings::String_1, wear);
+  TEST_ASSERT_EQUAL(1, wear.writes);
+  TEST_ASSERT_LESS_OR_EQUAL(NVS::Internal::blobEntries(length + 1) / 2, wear.entries);
+#ifndef ARDUINO
+  TEST_ASSERT_EQUAL(entries + wear.entries, nvs_host_get_counters().entries_written);
+#endif
+
+  // Too small a buffer reads nothing
+  NVS::Str small{buf, length};
+  TEST_ASSERT_FALSE(compressed_strings.getValue(Strings::String_1, small));
+
+  // Short strings do not save an entry: stored as is, behind the header
+  TEST_ASSERT(compressed_strings.setValue(Strings::String_2, "short"));
+  compressed_strings.getKeyWear(Strings::String_2, wear);
+  TEST_ASSERT_EQUAL(NVS::Internal::blobEntries(NVS::Internal::LZ_HEADER_SIZE + 6), wear.entries);
+  out = {buf, sizeof(buf)};
+  TEST_ASSERT(compressed_strings.getValue(Strings::String_2, out));
+  TEST_ASSERT_EQUAL_STRING("short", buf);
+
+  // A string stored before the option was enabled is still read, and converted on write
+  TEST_ASSERT(uncompressed_strings.setValue(Strings::String_3, "legacy"));
+  out = {buf, sizeof(buf)};
+  TEST_ASSERT(compressed_strings.getValue(Strings::String_3, out));
+  TEST_ASSERT_EQUAL_STRING("legacy", buf);
+  TEST_ASSERT(compressed_strings.getValueSize(Strings::String_3, size));
+  TEST_ASSERT_EQUAL(7, size);
+
+  TEST_ASSERT(compressed_strings.setValue(Strings::String_3, json));
+  TEST_ASSERT(compressed_strings.getValue(Strings::String_3, out));
+  TEST_ASSERT_EQUAL_STRING(json, buf);
+
+  nvs_handle_t handle;
+  size_t legacy_size = 0;
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_open("test_compress", NVS_READONLY, &handle));
+  TEST_ASSERT(nvs_get_str(handle, compressed_strings.getKey(Strings::String_3), nullptr,
+                          &legacy_size) != ESP_OK);
+  nvs_close(handle);
+
+#ifndef ARDUINO
+  // Only the first write of a key after begin() looks for a legacy string
+  uint32_t gets = nvs_host_get_counters().gets;
+  TEST_ASSERT(compressed_strings.setValue(Strings::String_3, "again"));
+  TEST_ASSERT_EQUAL(gets, nvs_host_get_counters().gets);
+#endif
+
+  // Neither fits in SETTINGS_COMPRESS_BUFFER nor compresses into it: not written
+  uint32_t state = 12345;
+  for (size_t i = 0; i < sizeof(json) - 1; i++) {
+    state   = state * 1103515245 + 12345;
+    json[i] = static_cast<char>(' ' + (state >> 24) % 95);
+  }
+  json[sizeof(json) - 1] = '\0';
+  TEST_ASSERT_FALSE(compressed_strings.setValue(Strings::String_3, json));
+  out = {buf, sizeof(buf)};
+  TEST_ASSERT(compressed_strings.getValue(Strings::String_3, out));
+  TEST_ASSERT_EQUAL_STRING("again", buf);
+
+  TEST_ASSERT(compressed_strings.eraseAll());
+  compressed_strings.end();
+  uncompressed_strings.end();
+}
+
+void test_compressed_bytestreams() {
+  TEST_ASSERT(compressed_bytestreams.begin());
+  TEST_ASSERT(compressed_bytestreams.eraseAll());
+
+  // Larger than SETTINGS_COMPRESS_BUFFER raw, but not once compressed
+  static uint8_t blob[3000];
+  static uint8_t whole[3000];
+  for (size_t i = 0; i < sizeof(blob); i++)
+    blob[i] = static_cast<uint8_t>((i % 100) < 60 ? i % 7 : i / 100);
+
+  NVS::ByteStream out(whole, sizeof(whole));
+  TEST_ASSERT(compressed_bytestreams.setValue(ByteStreams::Stream_1, {blob, sizeof(blob)}));
+  TEST_ASSERT(compressed_bytestreams.getValue(ByteStreams::Stream_1, out));
+  TEST_ASSERT_EQUAL(sizeof(blob), out.size);
+  TEST_ASSERT_EQUAL_MEMORY(blob, whole, sizeof(blob));
+
+  // Incompressible data is stored as is, if it fits in the stack buffer
+  uint32_t state = 12345;
+  for (size_t i = 0; i < sizeof(blob); i++) {
+    state   = state * 1103515245 + 12345;
+    blob[i] = static_cast<uint8_t>(state >> 24);
+  }
+
+  nvs_handle_t handle;
+  size_t length   = 0;
+  size_t raw_size  = SETTINGS_COMPRESS_BUFFER - NVS::Internal::LZ_HEADER_SIZE;
+  const char* key = compressed_bytestreams.getKey(ByteStreams::Stream_2);
+  TEST_ASSERT(compressed_bytestreams.setValue(ByteStreams::Stream_2, {blob, raw_size}));
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_open("test_compress", NVS_READONLY, &handle));
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_get_blob(handle, key, nullptr, &length));
+  nvs_close(handle);
+  TEST_ASSERT_EQUAL(SETTINGS_COMPRESS_BUFFER, length);
+
+  out = NVS::ByteStream(whole, sizeof(whole));
+  TEST_ASSERT(compressed_bytestreams.getValue(ByteStreams::Stream_2, out));
+  TEST_ASSERT_EQUAL(raw_size, out.size);
+  TEST_ASSERT_EQUAL_MEMORY(blob, whole, raw_size);
+
+  // One byte more is not written, and the stored value is kept
+  TEST_ASSERT_FALSE(compressed_bytestreams.setValue(ByteStreams::Stream_2, {blob, raw_size + 1}));
+  TEST_ASSERT_FALSE(compressed_bytestreams.setValue(ByteStreams::Stream_2, {blob, sizeof(blob)}));
+  out = NVS::ByteStream(whole, sizeof(whole));
+  TEST_ASSERT(compressed_bytestreams.getValue(ByteStreams::Stream_2, out));
+  TEST_ASSERT_EQUAL(raw_size, out.size);
+
+  // A blob stored before the option and larger than the buffer is read as is, straight into the
+  // output buffer
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_open("test_compress", NVS_READWRITE, &handle));
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_set_blob(handle, key, blob, sizeof(blob)));
+  nvs_close(handle);
+
+  out = NVS::ByteStream(whole, sizeof(whole));
+  TEST_ASSERT(compressed_bytestreams.getValue(ByteStreams::Stream_2, out));
+  TEST_ASSERT_EQUAL(sizeof(blob), out.size);
+  TEST_ASSERT_EQUAL_MEMORY(blob, whole, sizeof(blob));
+
+  size_t size = 0;
+  TEST_ASSERT(compressed_bytestreams.getValueSize(ByteStreams::Stream_2, size));
+  TEST_ASSERT_EQUAL(sizeof(blob), size);
+
+  NVS::ByteStream small(whole, sizeof(blob) - 1);
+  TEST_ASSERT_FALSE(compressed_bytestreams.getValue(ByteStreams::Stream_2, small));
+
+  // A corrupted compressed value fails its CRC check
+  uint8_t stored[SETTINGS_COMPRESS_BUFFER];
+  length = sizeof(stored);
+  key    = compressed_bytestreams.getKey(ByteStreams::Stream_1);
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_open("test_compress", NVS_READWRITE, &handle));
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_get_blob(handle, key, stored, &length));
+  TEST_ASSERT_EQUAL('L', stored[0]);
+  stored[NVS::Internal::LZ_HEADER_SIZE + 1] ^= 0x01;
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_set_blob(handle, key, stored, length));
+  nvs_close(handle);
+
+  out = NVS::ByteStream(whole, sizeof(whole));
+  TEST_ASSERT_FALSE(compressed_bytestreams.getValue(ByteStreams::Stream_1, out));
+
+  // Data that starts like a compressed value reads back as written
+  uint8_t lookalike[] = {'L', 'Z', 0x01, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0x12, 0x34, 0x56, 0x78,
+                         0xAB};
+  size_t lookalike_size = 0;
+  TEST_ASSERT(
+    compressed_bytestreams.setValue(ByteStreams::Stream_3, {lookalike, sizeof(lookalike)}));
+  TEST_ASSERT(compressed_bytestreams.getValueSize(ByteStreams::Stream_3, lookalike_size));
+  TEST_ASSERT_EQUAL(sizeof(lookalike), lookalike_size);
+  out = NVS::ByteStream(whole, sizeof(whole));
+  TEST_ASSERT(compressed_bytestreams.getValue(ByteStreams::Stream_3, out));
+  TEST_ASSERT_EQUAL(sizeof(lookalike), out.size);
+  TEST_ASSERT_EQUAL_MEMORY(lookalike, whole, sizeof(lookalike));
+
+  // A blob stored before the option was enabled has no header: read as is
+  uint8_t legacy[] = {1, 2, 3, 4, 5};
+  key              = compressed_bytestreams.getKey(ByteStreams::Stream_3);
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_open("test_compress", NVS_READWRITE, &handle));
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_set_blob(handle, key, legacy, sizeof(legacy)));
+  nvs_close(handle);
+  out = NVS::ByteStream(whole, sizeof(whole));
+  TEST_ASSERT(compressed_bytestreams.getValue(ByteStreams::Stream_3, out));
+  TEST_ASSERT_EQUAL(sizeof(legacy), out.size);
+  TEST_ASSERT_EQUAL_MEMORY(legacy, whole, sizeof(legacy));
+
+  TEST_ASSERT(compressed_bytestreams.eraseAll());
+  compressed_bytestreams.end();
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_partition_isolation() {
+  TEST_ASSERT(NVS::isInitialized());
+  TEST_ASSERT(NVS::isInitialized(NVS_DEFAULT_PART_NAME));
+  TEST_ASSERT_FALSE(NVS::isInitialized("hot"));
+
+  // Objects on a partition open only once it is initialized
+  TEST_ASSERT_FALSE(hot_uint32s.begin());
+  TEST_ASSERT(NVS::init("hot"));
+  TEST_ASSERT(NVS::isInitialized("hot"));
+  TEST_ASSERT(hot_uint32s.begin());
+  TEST_ASSERT(cold_uint32s.begin());
+
+  TEST_ASSERT_EQUAL_STRING("hot", hot_uint32s.getPartition());
+  TEST_ASSERT_NULL(cold_uint32s.getPartition());
+
+  // Same namespace and key, separate values
+  TEST_ASSERT(hot_uint32s.setValue(UInt32s::UInt32_1, 42));
+  TEST_ASSERT(cold_uint32s.setValue(UInt32s::UInt32_1, 7));
+
+  uint32_t value = 0;
+  TEST_ASSERT(hot_uint32s.getValue(UInt32s::UInt32_1, value));
+  TEST_ASSERT_EQUAL(42, value);
+  TEST_ASSERT(cold_uint32s.getValue(UInt32s::UInt32_1, value));
+  TEST_ASSERT_EQUAL(7, value);
+
+  // Writes to the hot partition only take its entries
+  nvs_stats_t stats;
+  TEST_ASSERT(NVS::getStats(stats, "hot"));
+  uint32_t used = stats.used_entries;
+  for (uint32_t i = 0; i < 10; i++)
+    TEST_ASSERT(hot_uint32s.setValue(UInt32s::UInt32_2, i));
+
+  nvs_stats_t cold_stats;
+  TEST_ASSERT(NVS::getStats(cold_stats));
+  TEST_ASSERT(NVS::getStats(stats, "hot"));
+  TEST_ASSERT_EQUAL(used + 1, stats.used_entries);
+  TEST_ASSERT(NVS::getStats(stats));
+  TEST_ASSERT_EQUAL(cold_stats.used_entries, stats.used_entries);
+}
+
+void test_partition_lifecycle() {
+  // Erasing one partition leaves the others initialized and their values intact
+  hot_uint32s.end();
+  TEST_ASSERT(NVS::erase("hot"));
+  TEST_ASSERT_FALSE(NVS::isInitialized("hot"));
+  TEST_ASSERT(NVS::isInitialized());
+
+  uint32_t value = 0;
+  TEST_ASSERT(cold_uint32s.getValue(UInt32s::UInt32_1, value));
+  TEST_ASSERT_EQUAL(7, value);
+
+  TEST_ASSERT(NVS::init("hot"));
+  TEST_ASSERT(hot_uint32s.begin());
+  TEST_ASSERT_FALSE(hot_uint32s.getValue(UInt32s::UInt32_1, value));
+
+  // And so does deinitializing it
+  hot_uint32s.end();
+  TEST_ASSERT(NVS::deinit("hot"));
+  TEST_ASSERT(NVS::deinit("hot"));
+  TEST_ASSERT_FALSE(NVS::erase("hot"));
+  TEST_ASSERT(NVS::isInitialized());
+  TEST_ASSERT(cold_uint32s.getValue(UInt32s::UInt32_1, value));
+  TEST_ASSERT_EQUAL(7, value);
+
+  // Labels longer than NVS_PART_NAME_MAX_SIZE are rejected
+  TEST_ASSERT_FALSE(NVS::init("a_partition_label"));
+  TEST_ASSERT_FALSE(NVS::isInitialized("a_partition_label"));
+
+  TEST_ASSERT(cold_uint32s.eraseAll());
+  cold_uint32s.end();
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_counters_accumulate() {
+  TEST_ASSERT_FALSE(counters.add(CounterIds::Boots));
+  TEST_ASSERT_EQUAL(1000, counters.get(CounterIds::EnergyWh));
+
+  TEST_ASSERT(counters.begin());
+  TEST_ASSERT(counters.formatAll());
+  TEST_ASSERT(counters.set(CounterIds::Boots, 0));
+  counters.setFlushInterval(0);
+  counters.resetStats();
+
+#ifndef ARDUINO
+  uint32_t sets = nvs_host_get_counters().sets;
+#endif
+
+  // Updates stay in RAM until flushed
+  for (uint32_t i = 0; i < 100; i++)
+    TEST_ASSERT(counters.add(CounterIds::Hours));
+  TEST_ASSERT(counters.add(CounterIds::EnergyWh, 250));
+
+  TEST_ASSERT_EQUAL(100, counters.get(CounterIds::Hours));
+  TEST_ASSERT_EQUAL(0, counters.getFlushed(CounterIds::Hours));
+  TEST_ASSERT(counters.isDirty());
+#ifndef ARDUINO
+  TEST_ASSERT_EQUAL(sets, nvs_host_get_counters().sets);
+#endif
+
+  // One write for every counter at once
+  TEST_ASSERT(counters.flush());
+  TEST_ASSERT_FALSE(counters.isDirty());
+  TEST_ASSERT(counters.flush());
+#ifndef ARDUINO
+  TEST_ASSERT_EQUAL(sets + 1, nvs_host_get_counters().sets);
+#endif
+
+  NVS::CounterStats stats;
+  counters.getStats(stats);
+  TEST_ASSERT_EQUAL(101, stats.updates);
+  TEST_ASSERT_EQUAL(1, stats.flushes);
+
+  // end() flushes what is pending; begin() reads everything back with one read
+  TEST_ASSERT(counters.add(CounterIds::Boots));
+  counters.end();
+
+#ifndef ARDUINO
+  uint32_t gets = nvs_host_get_counters().gets;
+#endif
+  TEST_ASSERT(counters_reload.begin());
+#ifndef ARDUINO
+  TEST_ASSERT_EQUAL(gets + 1, nvs_host_get_counters().gets);
+#endif
+  TEST_ASSERT_EQUAL(1, counters_reload.get(CounterIds::Boots));
+  TEST_ASSERT_EQUAL(100, counters_reload.get(CounterIds::Hours));
+  TEST_ASSERT_EQUAL(1250, counters_reload.get(CounterIds::EnergyWh));
+  counters_reload.end();
+}
+
+void test_counters_flush_triggers() {
+  TEST_ASSERT(counters.begin());
+  counters.setFlushInterval(0);
+  counters.resetStats();
+  NVS::CounterStats stats;
+
+  // Delta: a flush once a counter moved by 10 since the last one
+  counters.setFlushDelta(CounterIds::Hours, 10);
+  for (uint32_t i = 0; i < 9; i++)
+    TEST_ASSERT(counters.add(CounterIds::Hours));
+  counters.getStats(stats);
+  TEST_ASSERT_EQUAL(0, stats.flushes);
+
+  TEST_ASSERT(counters.add(CounterIds::Hours));
+  counters.getStats(stats);
+  TEST_ASSERT_EQUAL(1, stats.flushes);
+  TEST_ASSERT_EQUAL(110, counters.getFlushed(CounterIds::Hours));
+
+  // Other counters keep accumulating, even in large steps
+  TEST_ASSERT(counters.add(CounterIds::EnergyWh, 5000));
+  counters.getStats(stats);
+  TEST_ASSERT_EQUAL(1, stats.flushes);
+  counters.setFlushDelta(0);
+
+  // Interval: checked by add() and poll()
+  counters.setFlushInterval(5);
+  TEST_ASSERT(counters.poll());
+  counters.getStats(stats);
+  TEST_ASSERT_EQUAL(1, stats.flushes);
+
+#ifdef ARDUINO
+  delay(10);
+#else
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+#endif
+
+  TEST_ASSERT(counters.poll());
+  counters.getStats(stats);
+  TEST_ASSERT_EQUAL(2, stats.flushes);
+  TEST_ASSERT_EQUAL(6250, counters.getFlushed(CounterIds::EnergyWh));
+
+  // Nothing pending: the interval alone does not write
+#ifdef ARDUINO
+  delay(10);
+#else
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+#endif
+
+  TEST_ASSERT(counters.poll());
+  TEST_ASSERT(counters.add(CounterIds::Boots));
+  counters.getStats(stats);
+  TEST_ASSERT_EQUAL(3, stats.flushes);
+
+  counters.setFlushInterval(SETTINGS_COUNTER_FLUSH_MS);
+  counters.end();
+}
+
+void test_counters_reset() {
+  TEST_ASSERT(counters.begin());
+
+  // set() flushes at once; formatAll() resets the formattable counters only
+  TEST_ASSERT(counters.set(CounterIds::EnergyWh, 42));
+  TEST_ASSERT_EQUAL(42, counters.getFlushed(CounterIds::EnergyWh));
+
+  TEST_ASSERT(counters.formatAll());
+  TEST_ASSERT_EQUAL(2, counters.get(CounterIds::Boots));
+  TEST_ASSERT_EQUAL(0, counters.get(CounterIds::Hours));
+  TEST_ASSERT_EQUAL(1000, counters.get(CounterIds::EnergyWh));
+
+  // A damaged record is dropped: every counter starts over at its initial value
+  nvs_handle_t handle;
+  uint8_t record[64];
+  size_t length = sizeof(record);
+  counters.end();
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_open("test_counters", NVS_READWRITE, &handle));
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_get_blob(handle, NVS::Internal::COUNTERS_KEY, record, &length));
+  record[length - 1] ^= 0xFF;
+  TEST_ASSERT_EQUAL(ESP_OK, nvs_set_blob(handle, NVS::Internal::COUNTERS_KEY, record, length));
+  nvs_close(handle);
+
+  TEST_ASSERT(counters.begin());
+  TEST_ASSERT_EQUAL(0, counters.get(CounterIds::Boots));
+  TEST_ASSERT_EQUAL(1000, counters.get(CounterIds::EnergyWh));
+
+  TEST_ASSERT_EQUAL_STRING("Boots", counters.getKey(CounterIds::Boots));
+  TEST_ASSERT_EQUAL_STRING("Operating hours", counters.getHint(CounterIds::Hours));
+  counters.end();
+}
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ---------------------------------------------------------------------------------------------- */
+void test_validate_global_callback_entries() {
+  TEST_ASSERT_EQUAL(expected_global_callback_entries, global_callback_entries);
+}
+
+void test_validate_individual_callback_entries() {
+  TEST_ASSERT_EQUAL(expected_individual_callback_entries, bool_callback_entries);
+  TEST_ASSERT_EQUAL(expected_individual_callback_entries, uint32_callback_entries);
+  TEST_ASSERT_EQUAL(expected_individual_callback_entries, int32_callback_entries);
+  TEST_ASSERT_EQUAL(expected_individual_callback_entries, float_callback_entries);
+  TEST_ASSERT_EQUAL(expected_individual_callback_entries, double_callback_entries);
+  TEST_ASSERT_EQUAL(expected_individual_callback_entries, string_callback_entries);
+  TEST_ASSERT_EQUAL(expected_individual_callback_entries, bytestream_callback_entries);
+}
+
+/* ---------------------------------------------------------------------------------------------- */